@@ -115,4 +115,35 @@ namespace OpenMD {
     }
     return corrTensor;
   }
+
+  // Each term is (b(t2) - b(t1))^2 with b = action - pAve * t on the
+  // diagonal, which expands to b(t1)^2 + b(t2)^2 - 2 b(t1) b(t2):
+  void ActionCorrFunc::getComponents1(int frame, int id, RealType* c) {
+    RealType pAve;
+    pressure_->getAverage(pAve);
+    for (unsigned int i = 0; i < 3; i++) {
+      for (unsigned int j = 0; j < 3; j++) {
+        RealType b = action_[frame](i, j);
+        if (i == j) b -= pAve * time_[frame];
+        int e = 3 * (3*i + j);
+        c[e] = b * b;
+        c[e + 1] = 1.0;
+        c[e + 2] = b;
+      }
+    }
+  }
+  void ActionCorrFunc::getComponents2(int frame, int id, RealType* c) {
+    getComponents1(frame, id, c);
+    for (int e = 0; e < 27; e += 3) std::swap(c[e], c[e + 1]);
+  }
+  Mat3x3d ActionCorrFunc::combineComponents(const RealType* c) {
+    Mat3x3d corrTensor(0.0);
+    for (unsigned int i = 0; i < 3; i++) {
+      for (unsigned int j = 0; j < 3; j++) {
+        int e = 3 * (3*i + j);
+        corrTensor(i, j) = c[e] + c[e + 1] - 2.0 * c[e + 2];
+      }
+    }
+    return corrTensor;
+  }
 }
@@ -56,6 +56,12 @@ namespace OpenMD {
   protected:
     virtual void computeProperty1(int frame1);
     Mat3x3d calcCorrVal(int frame1, int frame2);
+    virtual int getNComponents() { return 27; }
+    virtual void getComponents1(int frame, int id, RealType* c);
+    virtual void getComponents2(int frame, int id, RealType* c);
+    virtual Mat3x3d combineComponents(const RealType* c);
+    // the components are fluctuations from trajectory averages:
+    virtual bool isStreamable() { return false; }
     
     ForceManager* forceMan_;
     Thermo* thermo_;
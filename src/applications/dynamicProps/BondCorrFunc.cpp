@@ -72,5 +72,15 @@ namespace OpenMD {
                                       int id1, int id2) {
     return delta_[frame1][id1] * delta_[frame2][id2];
   }
+
+  void BondCorrFunc::getComponents1(int frame, int id, RealType* c) {
+    c[0] = delta_[frame][id];
+  }
+  RealType BondCorrFunc::combineComponents(const RealType* c) {
+    return c[0];
+  }
+  void BondCorrFunc::clearFrame(int frame) {
+    std::vector<RealType>().swap(delta_[frame]);
+  }
 }
 
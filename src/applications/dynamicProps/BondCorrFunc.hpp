@@ -53,6 +53,10 @@ namespace OpenMD {
   private:
     virtual int computeProperty1(int frame, Bond* bond);
     virtual RealType calcCorrVal(int frame1, int frame2, int id1, int id2);
+    virtual int getNComponents() { return 1; }
+    virtual void getComponents1(int frame, int id, RealType* c);
+    virtual RealType combineComponents(const RealType* c);
+    virtual void clearFrame(int frame);
     
     virtual void computeProperty1(int frame) { return; }
     virtual int computeProperty1(int frame, Molecule* mol) { return -1; }
@@ -184,4 +184,20 @@ namespace OpenMD {
       }
     }
   }
+
+  void ChargeOrientationCorrFunc::getComponents1(int frame, int id,
+                                                 RealType* c) {
+    c[0] = charges_[frame][id];
+  }
+  void ChargeOrientationCorrFunc::getComponents2(int frame, int id,
+                                                 RealType* c) {
+    c[0] = CosTheta_[frame][id];
+  }
+  RealType ChargeOrientationCorrFunc::combineComponents(const RealType* c) {
+    return c[0];
+  }
+  void ChargeOrientationCorrFunc::clearFrame(int frame) {
+    std::vector<RealType>().swap(charges_[frame]);
+    std::vector<RealType>().swap(CosTheta_[frame]);
+  }
 }
@@ -60,6 +60,11 @@ namespace OpenMD {
     virtual int computeProperty1(int frame, StuntDouble* sd);
     virtual int computeProperty2(int frame, StuntDouble* sd);
     virtual RealType calcCorrVal(int frame1, int frame2, int id1, int id2);
+    virtual int getNComponents() { return 1; }
+    virtual void getComponents1(int frame, int id, RealType* c);
+    virtual void getComponents2(int frame, int id, RealType* c);
+    virtual RealType combineComponents(const RealType* c);
+    virtual void clearFrame(int frame);
     virtual void postCorrelate();
 
     std::vector< std::vector<RealType> > charges_;
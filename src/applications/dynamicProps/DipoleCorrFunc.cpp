@@ -94,6 +94,16 @@ namespace OpenMD {
       }
     }    
   }
-}
-
 
+  void DipoleCorrFunc::getComponents1(int frame, int id, RealType* c) {
+    Vector3d v = dipoles_[frame][id];
+    v /= v.length();
+    for (int i = 0; i < 3; i++) c[i] = v[i];
+  }
+  RealType DipoleCorrFunc::combineComponents(const RealType* c) {
+    return c[0] + c[1] + c[2];
+  }
+  void DipoleCorrFunc::clearFrame(int frame) {
+    std::vector<Vector3d>().swap(dipoles_[frame]);
+  }
+}
@@ -58,6 +58,10 @@ namespace OpenMD {
   private:
     virtual int computeProperty1(int frame, StuntDouble* sd);
     virtual RealType calcCorrVal(int frame1, int frame2, int id1, int id2);
+    virtual int getNComponents() { return 3; }
+    virtual void getComponents1(int frame, int id, RealType* c);
+    virtual RealType combineComponents(const RealType* c);
+    virtual void clearFrame(int frame);
     virtual void validateSelection(SelectionManager& seleMan);
 
     std::vector<std::vector<Vector3d> > dipoles_;
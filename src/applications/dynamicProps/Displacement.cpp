@@ -268,5 +268,25 @@ namespace OpenMD {
     }
     ofs.close();    
   }
+
+  // r(t2) - r(t1) is correlated as 1 * r(t2) - r(t1) * 1:
+  void Displacement::getComponents1(int frame, int id, RealType* c) {
+    for (int i = 0; i < 3; i++) {
+      c[i] = 1.0;
+      c[3 + i] = positions_[frame][id][i];
+    }
+  }
+  void Displacement::getComponents2(int frame, int id, RealType* c) {
+    for (int i = 0; i < 3; i++) {
+      c[i] = positions_[frame][id][i];
+      c[3 + i] = 1.0;
+    }
+  }
+  Vector3d Displacement::combineComponents(const RealType* c) {
+    return Vector3d(c[0] - c[3], c[1] - c[4], c[2] - c[5]);
+  }
+  void Displacement::clearFrame(int frame) {
+    std::vector<Vector3d>().swap(positions_[frame]);
+  }
 }
 
@@ -52,6 +52,11 @@ namespace OpenMD {
   private:
     virtual int computeProperty1(int frame, StuntDouble* sd);
     virtual Vector3d calcCorrVal(int frame1, int frame2, int id1, int id2);
+    virtual int getNComponents() { return 6; }
+    virtual void getComponents1(int frame, int id, RealType* c);
+    virtual void getComponents2(int frame, int id, RealType* c);
+    virtual Vector3d combineComponents(const RealType* c);
+    virtual void clearFrame(int frame);
     std::vector<std::vector<Vector3d> > positions_;
   };
 
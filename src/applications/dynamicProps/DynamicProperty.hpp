@@ -54,7 +54,7 @@ namespace OpenMD {
 
   class DynamicProperty {
   public:
-    DynamicProperty(){ }
+    DynamicProperty() : multipleTau_(false) { }
     virtual ~DynamicProperty(){ }
     virtual void doCorrelate() = 0;
 
@@ -65,8 +65,18 @@ namespace OpenMD {
       return outputFilename_;
     }
 
+    /**
+     * Requests an on-the-fly multiple-tau correlation that reads the
+     * trajectory once and does not keep it in memory.  Properties that
+     * can't be computed this way ignore the request.
+     */
+    void setMultipleTau(bool multipleTau) {
+      multipleTau_ = multipleTau;
+    }
+
   protected:
     std::string outputFilename_;
+    bool multipleTau_;
   };
 }
 #endif
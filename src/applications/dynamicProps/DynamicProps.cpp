@@ -292,6 +292,10 @@ int main(int argc, char* argv[]){
     corrFunc->setOutputName(args_info.output_arg);
   }
 
+  if (args_info.multipleTau_flag) {
+    corrFunc->setMultipleTau(true);
+  }
+
   corrFunc->doCorrelate();
 
   delete corrFunc;
@@ -49,6 +49,7 @@ const char *gengetopt_args_info_help[] = {
   "      --dipoleX=DOUBLE          X-component of the dipole with respect to body\n                                  frame  (default=`0.0')",
   "      --dipoleY=DOUBLE          Y-component of the dipole with respect to body\n                                  frame  (default=`0.0')",
   "      --dipoleZ=DOUBLE          Z-component of the dipole with respect to body\n                                  frame  (default=`-1.0')",
+  "      --multipleTau             correlate on the fly with a multiple-tau\n                                  correlator (linear correlation functions\n                                  only)  (default=off)",
   "\n Group: correlation function\n   an option of this group is required",
   "  -s, --selecorr                selection correlation function",
   "  -r, --rcorr                   mean squared displacement",
@@ -86,6 +87,7 @@ const char *gengetopt_args_info_help[] = {
 };
 
 typedef enum {ARG_NO
+  , ARG_FLAG
   , ARG_STRING
   , ARG_INT
   , ARG_DOUBLE
@@ -128,6 +130,7 @@ void clear_given (struct gengetopt_args_info *args_info)
   args_info->dipoleX_given = 0 ;
   args_info->dipoleY_given = 0 ;
   args_info->dipoleZ_given = 0 ;
+  args_info->multipleTau_given = 0 ;
   args_info->selecorr_given = 0 ;
   args_info->rcorr_given = 0 ;
   args_info->rcorrZ_given = 0 ;
@@ -193,6 +196,7 @@ void clear_args (struct gengetopt_args_info *args_info)
   args_info->dipoleY_orig = NULL;
   args_info->dipoleZ_arg = -1.0;
   args_info->dipoleZ_orig = NULL;
+  args_info->multipleTau_flag = 0;
   
 }
 
@@ -217,38 +221,39 @@ void init_args_info(struct gengetopt_args_info *args_info)
   args_info->dipoleX_help = gengetopt_args_info_help[13] ;
   args_info->dipoleY_help = gengetopt_args_info_help[14] ;
   args_info->dipoleZ_help = gengetopt_args_info_help[15] ;
-  args_info->selecorr_help = gengetopt_args_info_help[17] ;
-  args_info->rcorr_help = gengetopt_args_info_help[18] ;
-  args_info->rcorrZ_help = gengetopt_args_info_help[19] ;
-  args_info->vcorr_help = gengetopt_args_info_help[20] ;
-  args_info->vcorrZ_help = gengetopt_args_info_help[21] ;
-  args_info->vcorrR_help = gengetopt_args_info_help[22] ;
-  args_info->wcorr_help = gengetopt_args_info_help[23] ;
-  args_info->dcorr_help = gengetopt_args_info_help[24] ;
-  args_info->lcorr_help = gengetopt_args_info_help[25] ;
-  args_info->lcorrZ_help = gengetopt_args_info_help[26] ;
-  args_info->cohZ_help = gengetopt_args_info_help[27] ;
-  args_info->sdcorr_help = gengetopt_args_info_help[28] ;
-  args_info->r_rcorr_help = gengetopt_args_info_help[29] ;
-  args_info->thetacorr_help = gengetopt_args_info_help[30] ;
-  args_info->drcorr_help = gengetopt_args_info_help[31] ;
-  args_info->stresscorr_help = gengetopt_args_info_help[32] ;
-  args_info->bondcorr_help = gengetopt_args_info_help[33] ;
-  args_info->freqfluccorr_help = gengetopt_args_info_help[34] ;
-  args_info->jumptime_help = gengetopt_args_info_help[35] ;
-  args_info->jumptimeZ_help = gengetopt_args_info_help[36] ;
-  args_info->persistence_help = gengetopt_args_info_help[37] ;
-  args_info->pjcorr_help = gengetopt_args_info_help[38] ;
-  args_info->ftcorr_help = gengetopt_args_info_help[39] ;
-  args_info->ckcorr_help = gengetopt_args_info_help[40] ;
-  args_info->cscorr_help = gengetopt_args_info_help[41] ;
-  args_info->facorr_help = gengetopt_args_info_help[42] ;
-  args_info->tfcorr_help = gengetopt_args_info_help[43] ;
-  args_info->tacorr_help = gengetopt_args_info_help[44] ;
-  args_info->disp_help = gengetopt_args_info_help[45] ;
-  args_info->dispZ_help = gengetopt_args_info_help[46] ;
-  args_info->current_help = gengetopt_args_info_help[47] ;
-  args_info->ddisp_help = gengetopt_args_info_help[48] ;
+  args_info->multipleTau_help = gengetopt_args_info_help[16] ;
+  args_info->selecorr_help = gengetopt_args_info_help[18] ;
+  args_info->rcorr_help = gengetopt_args_info_help[19] ;
+  args_info->rcorrZ_help = gengetopt_args_info_help[20] ;
+  args_info->vcorr_help = gengetopt_args_info_help[21] ;
+  args_info->vcorrZ_help = gengetopt_args_info_help[22] ;
+  args_info->vcorrR_help = gengetopt_args_info_help[23] ;
+  args_info->wcorr_help = gengetopt_args_info_help[24] ;
+  args_info->dcorr_help = gengetopt_args_info_help[25] ;
+  args_info->lcorr_help = gengetopt_args_info_help[26] ;
+  args_info->lcorrZ_help = gengetopt_args_info_help[27] ;
+  args_info->cohZ_help = gengetopt_args_info_help[28] ;
+  args_info->sdcorr_help = gengetopt_args_info_help[29] ;
+  args_info->r_rcorr_help = gengetopt_args_info_help[30] ;
+  args_info->thetacorr_help = gengetopt_args_info_help[31] ;
+  args_info->drcorr_help = gengetopt_args_info_help[32] ;
+  args_info->stresscorr_help = gengetopt_args_info_help[33] ;
+  args_info->bondcorr_help = gengetopt_args_info_help[34] ;
+  args_info->freqfluccorr_help = gengetopt_args_info_help[35] ;
+  args_info->jumptime_help = gengetopt_args_info_help[36] ;
+  args_info->jumptimeZ_help = gengetopt_args_info_help[37] ;
+  args_info->persistence_help = gengetopt_args_info_help[38] ;
+  args_info->pjcorr_help = gengetopt_args_info_help[39] ;
+  args_info->ftcorr_help = gengetopt_args_info_help[40] ;
+  args_info->ckcorr_help = gengetopt_args_info_help[41] ;
+  args_info->cscorr_help = gengetopt_args_info_help[42] ;
+  args_info->facorr_help = gengetopt_args_info_help[43] ;
+  args_info->tfcorr_help = gengetopt_args_info_help[44] ;
+  args_info->tacorr_help = gengetopt_args_info_help[45] ;
+  args_info->disp_help = gengetopt_args_info_help[46] ;
+  args_info->dispZ_help = gengetopt_args_info_help[47] ;
+  args_info->current_help = gengetopt_args_info_help[48] ;
+  args_info->ddisp_help = gengetopt_args_info_help[49] ;
   
 }
 
@@ -467,6 +472,8 @@ cmdline_parser_dump(FILE *outfile, struct gengetopt_args_info *args_info)
     write_into_file(outfile, "dipoleY", args_info->dipoleY_orig, 0);
   if (args_info->dipoleZ_given)
     write_into_file(outfile, "dipoleZ", args_info->dipoleZ_orig, 0);
+  if (args_info->multipleTau_given)
+    write_into_file(outfile, "multipleTau", 0, 0 );
   if (args_info->selecorr_given)
     write_into_file(outfile, "selecorr", 0, 0 );
   if (args_info->rcorr_given)
@@ -1358,6 +1365,9 @@ int update_arg(void *field, char **orig_field,
     val = possible_values[found];
 
   switch(arg_type) {
+  case ARG_FLAG:
+    *((int *)field) = !*((int *)field);
+    break;
   case ARG_INT:
     if (val) *((int *)field) = strtol (val, &stop_char, 0);
     break;
@@ -1395,6 +1405,7 @@ int update_arg(void *field, char **orig_field,
   /* store the original value */
   switch(arg_type) {
   case ARG_NO:
+  case ARG_FLAG:
     break;
   default:
     if (value && orig_field) {
@@ -1476,6 +1487,7 @@ cmdline_parser_internal (
         { "dipoleX",	1, NULL, 0 },
         { "dipoleY",	1, NULL, 0 },
         { "dipoleZ",	1, NULL, 0 },
+        { "multipleTau",	0, NULL, 0 },
         { "selecorr",	0, NULL, 's' },
         { "rcorr",	0, NULL, 'r' },
         { "rcorrZ",	0, NULL, 0 },
@@ -1876,6 +1888,18 @@ cmdline_parser_internal (
                 additional_error))
               goto failure;
           
+          }
+          /* correlate on the fly with a multiple-tau correlator (linear correlation functions only).  */
+          else if (strcmp (long_options[option_index].name, "multipleTau") == 0)
+          {
+          
+          
+            if (update_arg((void *)&(args_info->multipleTau_flag), 0, &(args_info->multipleTau_given),
+                &(local_args_info.multipleTau_given), optarg, 0, 0, ARG_FLAG,
+                check_ambiguity, override, 1, 0, "multipleTau", '-',
+                additional_error))
+              goto failure;
+          
           }
           /* mean squared displacement binned by Z.  */
           else if (strcmp (long_options[option_index].name, "rcorrZ") == 0)
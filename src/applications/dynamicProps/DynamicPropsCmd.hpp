@@ -83,6 +83,8 @@ struct gengetopt_args_info
   double dipoleZ_arg;	/**< @brief Z-component of the dipole with respect to body frame (default='-1.0').  */
   char * dipoleZ_orig;	/**< @brief Z-component of the dipole with respect to body frame original value given at command line.  */
   const char *dipoleZ_help; /**< @brief Z-component of the dipole with respect to body frame help description.  */
+  int multipleTau_flag;	/**< @brief correlate on the fly with a multiple-tau correlator (linear correlation functions only) (default=off).  */
+  const char *multipleTau_help; /**< @brief correlate on the fly with a multiple-tau correlator (linear correlation functions only) help description.  */
   const char *selecorr_help; /**< @brief selection correlation function help description.  */
   const char *rcorr_help; /**< @brief mean squared displacement help description.  */
   const char *rcorrZ_help; /**< @brief mean squared displacement binned by Z help description.  */
@@ -132,6 +134,7 @@ struct gengetopt_args_info
   unsigned int dipoleX_given ;	/**< @brief Whether dipoleX was given.  */
   unsigned int dipoleY_given ;	/**< @brief Whether dipoleY was given.  */
   unsigned int dipoleZ_given ;	/**< @brief Whether dipoleZ was given.  */
+  unsigned int multipleTau_given ;	/**< @brief Whether multipleTau was given.  */
   unsigned int selecorr_given ;	/**< @brief Whether selecorr was given.  */
   unsigned int rcorr_given ;	/**< @brief Whether rcorr was given.  */
   unsigned int rcorrZ_given ;	/**< @brief Whether rcorrZ was given.  */
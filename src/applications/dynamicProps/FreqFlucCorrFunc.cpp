@@ -111,6 +111,13 @@ namespace OpenMD {
       }
     }    
   }
-}
-
 
+  void FreqFlucCorrFunc::getComponents1(int frame, int id, RealType* c) {
+    RealType mean;
+    ueStats_->getAverage(mean);
+    c[0] = ue_[frame][id] - mean;
+  }
+  RealType FreqFlucCorrFunc::combineComponents(const RealType* c) {
+    return c[0];
+  }
+}
@@ -71,6 +71,11 @@ namespace OpenMD {
   private:
     virtual int computeProperty1(int frame, StuntDouble* sd);
     virtual RealType calcCorrVal(int frame1, int frame2, int id1, int id2);
+    virtual int getNComponents() { return 1; }
+    virtual void getComponents1(int frame, int id, RealType* c);
+    virtual RealType combineComponents(const RealType* c);
+    // the components are fluctuations from trajectory averages:
+    virtual bool isStreamable() { return false; }
     virtual void validateSelection(const SelectionManager& seleMan);
     
     std::vector<std::vector<RealType> > ue_;
@@ -67,6 +67,28 @@ namespace OpenMD {
     LegendrePolynomial polynomial(order);
     legendre_ = polynomial.getLegendrePolynomial(order);
 
+    // By the multinomial theorem, each power of u1.u2 in the Legendre
+    // polynomial is
+    //   (u1.u2)^k = sum_{a+b+c=k} k!/(a!b!c!) (x1 x2)^a (y1 y2)^b (z1 z2)^c
+    // so Pn(u1.u2) is a sum of products of monomials of u1 with the
+    // same monomials of u2, and can be correlated with FFTs.
+    DoublePolynomial::iterator i;
+    for (i = legendre_.begin(); i != legendre_.end(); ++i) {
+      int k = i->first;
+      for (int a = 0; a <= k; a++) {
+        for (int b = 0; a + b <= k; b++) {
+          int c = k - a - b;
+          RealType multinomial = 1.0;
+          for (int j = 2; j <= k; j++) multinomial *= j;
+          for (int j = 2; j <= a; j++) multinomial /= j;
+          for (int j = 2; j <= b; j++) multinomial /= j;
+          for (int j = 2; j <= c; j++) multinomial /= j;
+          powers_.push_back(Vector3i(a, b, c));
+          weights_.push_back(i->second * multinomial);
+        }
+      }
+    }
+
     rotMats_.resize(nFrames_);
   }
   
@@ -99,6 +121,41 @@ namespace OpenMD {
     return Vector3d(ux, uy, uz);
   }
 
+  void LegendreCorrFunc::getMonomials(int frame, int id, bool weighted,
+                                      RealType* c) {
+    int nm = powers_.size();
+    for (int axis = 0; axis < 3; axis++) {
+      Vector3d u = rotMats_[frame][id].getRow(axis);
+      u.normalize();
+      for (int m = 0; m < nm; m++) {
+        RealType mono = pow(u.x(), powers_[m][0]) * pow(u.y(), powers_[m][1])
+          * pow(u.z(), powers_[m][2]);
+        c[axis * nm + m] = weighted ? weights_[m] * mono : mono;
+      }
+    }
+  }
+
+  void LegendreCorrFunc::getComponents1(int frame, int id, RealType* c) {
+    getMonomials(frame, id, true, c);
+  }
+
+  void LegendreCorrFunc::getComponents2(int frame, int id, RealType* c) {
+    getMonomials(frame, id, false, c);
+  }
+
+  Vector3d LegendreCorrFunc::combineComponents(const RealType* c) {
+    int nm = powers_.size();
+    Vector3d corr(0.0);
+    for (int axis = 0; axis < 3; axis++)
+      for (int m = 0; m < nm; m++)
+        corr[axis] += c[axis * nm + m];
+    return corr;
+  }
+
+  void LegendreCorrFunc::clearFrame(int frame) {
+    std::vector<RotMat3x3d>().swap(rotMats_[frame]);
+  }
+
   void LegendreCorrFunc::validateSelection(SelectionManager& seleMan) {
     StuntDouble* sd;
     int i;
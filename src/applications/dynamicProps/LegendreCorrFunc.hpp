@@ -57,10 +57,20 @@ namespace OpenMD {
   protected:
     virtual int computeProperty1(int frame, StuntDouble* sd);
     virtual Vector3d calcCorrVal(int frame1, int frame2, int id1, int id2);
+    virtual int getNComponents() { return 3 * powers_.size(); }
+    virtual void getComponents1(int frame, int id, RealType* c);
+    virtual void getComponents2(int frame, int id, RealType* c);
+    virtual Vector3d combineComponents(const RealType* c);
+    virtual void clearFrame(int frame);
     virtual void validateSelection(SelectionManager& seleMan);
 
+    void getMonomials(int frame, int id, bool weighted, RealType* c);
+
     int order_;
     DoublePolynomial legendre_;
+    // Pn(u1.u2) expanded into products of monomials of u1 and u2:
+    std::vector<Vector3i> powers_;
+    std::vector<RealType> weights_;
     std::vector<std::vector<RotMat3x3d> > rotMats_;
   };
 }
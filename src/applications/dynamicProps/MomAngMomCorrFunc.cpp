@@ -100,4 +100,17 @@ namespace OpenMD {
     }
   }
 
+  void MomAngMomCorrFunc::getComponents1(int frame, int id, RealType* c) {
+    for (int i = 0; i < 3; i++) c[i] = momenta_[frame][id][i];
+  }
+  void MomAngMomCorrFunc::getComponents2(int frame, int id, RealType* c) {
+    for (int i = 0; i < 3; i++) c[i] = js_[frame][id][i];
+  }
+  RealType MomAngMomCorrFunc::combineComponents(const RealType* c) {
+    return c[0] + c[1] + c[2];
+  }
+  void MomAngMomCorrFunc::clearFrame(int frame) {
+    std::vector<Vector3d>().swap(momenta_[frame]);
+    std::vector<Vector3d>().swap(js_[frame]);
+  }
 }
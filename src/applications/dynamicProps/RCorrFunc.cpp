@@ -352,5 +352,45 @@ namespace OpenMD {
     dr  = positions_[frame2][id2] - positions_[frame1][id1];
     return dr * dr;
   }
+
+  // |r(t2) - r(t1)|^2 = r(t1)^2 + r(t2)^2 - 2 r(t1).r(t2), and each of
+  // these terms is a product of a property of t1 and one of t2:
+  void RCorrFunc::getComponents1(int frame, int id, RealType* c) {
+    Vector3d r = positions_[frame][id];
+    c[0] = r.lengthSquare();
+    c[1] = 1.0;
+    for (int i = 0; i < 3; i++) c[2 + i] = r[i];
+  }
+  void RCorrFunc::getComponents2(int frame, int id, RealType* c) {
+    Vector3d r = positions_[frame][id];
+    c[0] = 1.0;
+    c[1] = r.lengthSquare();
+    for (int i = 0; i < 3; i++) c[2 + i] = r[i];
+  }
+  RealType RCorrFunc::combineComponents(const RealType* c) {
+    return c[0] + c[1] - 2.0 * (c[2] + c[3] + c[4]);
+  }
+  void RCorrFunc::clearFrame(int frame) {
+    std::vector<Vector3d>().swap(positions_[frame]);
+  }
+
+  void RCorrFuncR::getComponents1(int frame, int id, RealType* c) {
+    RealType r = positions_[frame][id];
+    c[0] = r * r;
+    c[1] = 1.0;
+    c[2] = r;
+  }
+  void RCorrFuncR::getComponents2(int frame, int id, RealType* c) {
+    RealType r = positions_[frame][id];
+    c[0] = 1.0;
+    c[1] = r * r;
+    c[2] = r;
+  }
+  RealType RCorrFuncR::combineComponents(const RealType* c) {
+    return c[0] + c[1] - 2.0 * c[2];
+  }
+  void RCorrFuncR::clearFrame(int frame) {
+    std::vector<RealType>().swap(positions_[frame]);
+  }
 }
 
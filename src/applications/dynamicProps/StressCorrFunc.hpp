@@ -57,6 +57,12 @@ namespace OpenMD {
   private:
     virtual void computeProperty1(int frame);
     virtual Mat3x3d calcCorrVal(int frame1, int frame2);
+    virtual int getNComponents() { return 27; }
+    virtual void getComponents1(int frame, int id, RealType* c);
+    virtual void getComponents2(int frame, int id, RealType* c);
+    virtual Mat3x3d combineComponents(const RealType* c);
+    // the components are fluctuations from trajectory averages:
+    virtual bool isStreamable() { return false; }
 
     std::vector<Mat3x3d> action_;
     std::vector<RealType> time_;
@@ -74,5 +74,12 @@ namespace OpenMD {
   RealType SystemDipoleCorrFunc::calcCorrVal(int frame1, int frame2) {    
     return dot(sysDipoles_[frame1], sysDipoles_[frame2]);
   }
+
+  void SystemDipoleCorrFunc::getComponents1(int frame, int id, RealType* c) {
+    for (int i = 0; i < 3; i++) c[i] = sysDipoles_[frame][i];
+  }
+  RealType SystemDipoleCorrFunc::combineComponents(const RealType* c) {
+    return c[0] + c[1] + c[2];
+  }
 }
 
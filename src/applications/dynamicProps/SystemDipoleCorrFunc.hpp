@@ -59,6 +59,9 @@ namespace OpenMD {
   private:
     virtual void computeProperty1(int frame);
     virtual RealType calcCorrVal(int frame1, int frame2);
+    virtual int getNComponents() { return 3; }
+    virtual void getComponents1(int frame, int id, RealType* c);
+    virtual RealType combineComponents(const RealType* c);
     
     std::vector<Vector3d> sysDipoles_;
     Thermo* thermo_;
@@ -75,4 +75,15 @@ namespace OpenMD {
     return dot(a, b)/(a.length() * b.length());
   }
 
+  void ThetaCorrFunc::getComponents1(int frame, int id, RealType* c) {
+    Vector3d v = coords_[frame][id];
+    v /= v.length();
+    for (int i = 0; i < 3; i++) c[i] = v[i];
+  }
+  RealType ThetaCorrFunc::combineComponents(const RealType* c) {
+    return c[0] + c[1] + c[2];
+  }
+  void ThetaCorrFunc::clearFrame(int frame) {
+    std::vector<Vector3d>().swap(coords_[frame]);
+  }
 }
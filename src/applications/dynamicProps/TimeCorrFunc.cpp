@@ -45,6 +45,9 @@
 #include "utils/Revision.hpp"
 #include "primitives/Molecule.hpp"
 #include "math/DynamicVector.hpp"
+#include "math/FFT.hpp"
+#include "math/MultipleTauCorrelator.hpp"
+#include <map>
 
 using namespace std;
 namespace OpenMD {
@@ -105,7 +108,7 @@ namespace OpenMD {
   }
   
   template<typename T>
-  void TimeCorrFunc<T>::preCorrelate() {
+  void TimeCorrFunc<T>::loadSelections() {
 
     evaluator1_.loadScriptString(selectionScript1_);
     //if selection is static, we only need to evaluate it once
@@ -121,7 +124,12 @@ namespace OpenMD {
         validateSelection(seleMan2_);
       }
     }
-    
+  }
+
+  template<typename T>
+  void TimeCorrFunc<T>::preCorrelate() {
+
+    loadSelections();
     progressBar_->clear();
     
     for (int istep = 0; istep < nFrames_; istep++) {
@@ -276,15 +284,40 @@ namespace OpenMD {
   template<typename T>
   void TimeCorrFunc<T>::doCorrelate() {
 
+    // Auto-correlations with two different selections store both
+    // selections in the same property arrays, so those still go
+    // through the direct pair loop:
+    bool linear = getNComponents() > 0 &&
+      !(autoCorrFunc_ && uniqueSelections_);
+
     painCave.isFatal = 0;
     painCave.severity=OPENMD_INFO;
-    sprintf(painCave.errMsg, "Starting pre-correlate scan.");
-    simError();
-    preCorrelate();
 
-    sprintf(painCave.errMsg, "Calculating correlation function.");
-    simError();
-    correlation();
+    if (multipleTau_ && !(linear && isStreamable())) {
+      sprintf(painCave.errMsg,
+              "The multiple-tau correlator can't be used for the %s;\n"
+              "\tthe whole trajectory will be correlated instead.",
+              getCorrFuncType().c_str());
+      simError();
+    }
+
+    if (multipleTau_ && linear && isStreamable()) {
+      sprintf(painCave.errMsg,
+              "Correlating frames with a multiple-tau correlator.");
+      simError();
+      correlateMultipleTau();
+    } else {
+      sprintf(painCave.errMsg, "Starting pre-correlate scan.");
+      simError();
+      preCorrelate();
+
+      sprintf(painCave.errMsg, "Calculating correlation function.");
+      simError();
+      if (linear)
+        correlateFFT();
+      else
+        correlation();
+    }
 
     sprintf(painCave.errMsg, "Doing post-correlation calculations.");
     simError();
@@ -338,6 +371,282 @@ namespace OpenMD {
     }
   }
 
+  template<typename T>
+  void TimeCorrFunc<T>::correlateFFT() {
+    int nComp = getNComponents();
+
+    // Time bins are frame index differences here, so all of the
+    // frames must be spaced by the sample time:
+    for (int j = 1; j < nFrames_; ++j) {
+      if ( fabs( (times_[j] - times_[0]) - j*deltaTime_ ) > 1.0e-4 ) {
+        sprintf(painCave.errMsg,
+                "TimeCorrFunc::correlateFFT Error: sampleTime (%f)\n"
+                "\tin %s does not match actual time-spacing between\n"
+                "\tconfigurations %d (t = %f) and %d (t = %f).\n",
+                deltaTime_, dumpFilename_.c_str(), 0, times_[0], j,
+                times_[j]);
+        painCave.isFatal = 1;
+        simError();
+      }
+    }
+
+    // Each object gets its own pair of time series.  As in
+    // correlateFrames, objects are matched between frames (and
+    // between the two selections) by their global indices.  Each
+    // series is a list of (frame, id) pairs.
+
+    std::vector<std::vector<std::pair<int, int> > > series1;
+    std::vector<std::vector<std::pair<int, int> > > series2;
+
+    if (doSystemProperties_) {
+      series1.resize(1);
+      series2.resize(1);
+      for (int i = 0; i < nFrames_; ++i) {
+        series1[0].push_back(std::make_pair(i, 0));
+        series2[0].push_back(std::make_pair(i, 0));
+      }
+    } else {
+      std::map<int, int> slots;
+      std::map<int, int>::iterator si;
+
+      for (int i = 0; i < nFrames_; ++i) {
+        for (unsigned int k = 0; k < sele1ToIndex_[i].size(); ++k) {
+          si = slots.find(sele1ToIndex_[i][k]);
+          if (si == slots.end()) {
+            si = slots.insert(std::make_pair(sele1ToIndex_[i][k],
+                                             int(series1.size()))).first;
+            series1.push_back(std::vector<std::pair<int, int> >());
+          }
+          series1[si->second].push_back(std::make_pair(i, int(k)));
+        }
+      }
+
+      series2.resize(series1.size());
+      for (int i = 0; i < nFrames_; ++i) {
+        std::vector<int>& s2 = uniqueSelections_ ? sele2ToIndex_[i] :
+          sele1ToIndex_[i];
+        for (unsigned int k = 0; k < s2.size(); ++k) {
+          si = slots.find(s2[k]);
+          // objects that never show up in the first selection have
+          // nothing to be correlated with:
+          if (si != slots.end())
+            series2[si->second].push_back(std::make_pair(i, int(k)));
+        }
+      }
+    }
+
+    int nSeries = series1.size();
+
+    // Zero-padding the series to at least twice their length keeps
+    // the circular correlation from wrapping around:
+    int nFFT = FFT::goodSize(2 * nFrames_);
+    FFT fft(nFFT);
+
+    // corr[k][t] accumulates c1[k](t0) * c2[k](t0 + t) over all
+    // objects and time origins t0.  The last row counts the pairs.
+    std::vector<std::vector<RealType> > corr(nComp + 1,
+                                             std::vector<RealType>(nFrames_, 0.0));
+
+    progressBar_->clear();
+    int visited = 0;
+
+#pragma omp parallel
+    {
+      std::vector<std::vector<RealType> > myCorr(nComp + 1,
+                                                 std::vector<RealType>(nFrames_, 0.0));
+      std::vector<RealType> c1(nComp * nFrames_);
+      std::vector<RealType> c2(nComp * nFrames_);
+      std::vector<RealType> m1(nFrames_);
+      std::vector<RealType> m2(nFrames_);
+      std::vector<ComplexType> z(nFFT);
+      std::vector<ComplexType> p(nFFT);
+
+#pragma omp for schedule(dynamic)
+      for (int s = 0; s < nSeries; ++s) {
+        std::fill(c1.begin(), c1.end(), 0.0);
+        std::fill(c2.begin(), c2.end(), 0.0);
+        std::fill(m1.begin(), m1.end(), 0.0);
+        std::fill(m2.begin(), m2.end(), 0.0);
+
+        for (unsigned int j = 0; j < series1[s].size(); ++j) {
+          int frame = series1[s][j].first;
+          getComponents1(frame, series1[s][j].second, &c1[frame * nComp]);
+          m1[frame] = 1.0;
+        }
+        for (unsigned int j = 0; j < series2[s].size(); ++j) {
+          int frame = series2[s][j].first;
+          getComponents2(frame, series2[s][j].second, &c2[frame * nComp]);
+          m2[frame] = 1.0;
+        }
+
+        for (int k = 0; k <= nComp; ++k) {
+          // The two real series are transformed together as the real
+          // and imaginary parts of a single complex series:
+          std::fill(z.begin(), z.end(), ComplexType(0.0, 0.0));
+          for (int i = 0; i < nFrames_; ++i) {
+            if (k < nComp)
+              z[i] = ComplexType(c1[i * nComp + k], c2[i * nComp + k]);
+            else
+              z[i] = ComplexType(m1[i], m2[i]);
+          }
+          fft.forward(z);
+
+          // Separate the transforms (X and Y) of the two series and
+          // form conj(X) Y, the transform of their correlation:
+          for (int m = 0; m < nFFT; ++m) {
+            ComplexType zm = z[m];
+            ComplexType zn = conj(z[(nFFT - m) % nFFT]);
+            ComplexType x = 0.5 * (zm + zn);
+            ComplexType y = ComplexType(0.0, -0.5) * (zm - zn);
+            p[m] = conj(x) * y;
+          }
+          fft.backward(p);
+
+          for (int t = 0; t < nFrames_; ++t)
+            myCorr[k][t] += p[t].real() / RealType(nFFT);
+        }
+
+#pragma omp critical
+        {
+          visited++;
+          progressBar_->setStatus(visited, nSeries);
+          progressBar_->update();
+        }
+      }
+
+#pragma omp critical
+      {
+        for (int k = 0; k <= nComp; ++k)
+          for (int t = 0; t < nFrames_; ++t)
+            corr[k][t] += myCorr[k][t];
+      }
+    }
+
+    std::vector<RealType> c(nComp);
+    for (unsigned int t = 0; t < nTimeBins_; ++t) {
+      for (int k = 0; k < nComp; ++k) c[k] = corr[k][t];
+      histogram_[t] = combineComponents(&c[0]);
+      count_[t] = int(corr[nComp][t] + 0.5);
+    }
+  }
+
+  template<typename T>
+  void TimeCorrFunc<T>::correlateMultipleTau() {
+    int nComp = getNComponents();
+    int nLevels = MultipleTauCorrelator::levelsForLag(nFrames_ - 1);
+
+    // One correlator for each object (keyed by global index), or a
+    // single one for system properties:
+    std::map<int, MultipleTauCorrelator*> correlators;
+    std::map<int, MultipleTauCorrelator*>::iterator ci;
+    std::map<int, int> ids1;
+    std::map<int, int> ids2;
+    std::map<int, int>::iterator ii;
+    std::vector<RealType> c1(nComp);
+    std::vector<RealType> c2(nComp);
+
+    loadSelections();
+    progressBar_->clear();
+
+    for (int istep = 0; istep < nFrames_; istep++) {
+      reader_->readFrame(istep);
+      currentSnapshot_ = info_->getSnapshotManager()->getCurrentSnapshot();
+      times_[istep] = currentSnapshot_->getTime();
+
+      if (istep > 0 &&
+          fabs( (times_[istep] - times_[istep-1]) - deltaTime_ ) > 1.0e-4) {
+        sprintf(painCave.errMsg,
+                "TimeCorrFunc::correlateMultipleTau Error: sampleTime (%f)\n"
+                "\tin %s does not match actual time-spacing between\n"
+                "\tconfigurations %d (t = %f) and %d (t = %f).\n",
+                deltaTime_, dumpFilename_.c_str(), istep-1, times_[istep-1],
+                istep, times_[istep]);
+        painCave.isFatal = 1;
+        simError();
+      }
+
+      progressBar_->setStatus(istep+1, nFrames_);
+      progressBar_->update();
+
+      computeFrame(istep);
+
+      if (doSystemProperties_) {
+        if (correlators.empty())
+          correlators[0] = new MultipleTauCorrelator(nComp, nLevels);
+        getComponents1(istep, 0, &c1[0]);
+        getComponents2(istep, 0, &c2[0]);
+        correlators[0]->add(&c1[0], &c2[0]);
+      } else {
+        std::vector<int>& s1 = sele1ToIndex_[istep];
+        std::vector<int>& s2 = uniqueSelections_ ? sele2ToIndex_[istep] :
+          sele1ToIndex_[istep];
+
+        ids1.clear();
+        ids2.clear();
+        for (unsigned int k = 0; k < s1.size(); ++k) ids1[s1[k]] = k;
+        for (unsigned int k = 0; k < s2.size(); ++k) ids2[s2[k]] = k;
+
+        // Objects that turn up part of the way through the trajectory
+        // are missing from all of the earlier frames:
+        for (ii = ids1.begin(); ii != ids1.end(); ++ii) {
+          if (correlators.find(ii->first) == correlators.end()) {
+            MultipleTauCorrelator* mtc = new MultipleTauCorrelator(nComp,
+                                                                   nLevels);
+            for (int i = 0; i < istep; i++) mtc->add(NULL, NULL);
+            correlators[ii->first] = mtc;
+          }
+        }
+
+        for (ci = correlators.begin(); ci != correlators.end(); ++ci) {
+          RealType* a = NULL;
+          RealType* b = NULL;
+          ii = ids1.find(ci->first);
+          if (ii != ids1.end()) {
+            getComponents1(istep, ii->second, &c1[0]);
+            a = &c1[0];
+          }
+          ii = ids2.find(ci->first);
+          if (ii != ids2.end()) {
+            getComponents2(istep, ii->second, &c2[0]);
+            b = &c2[0];
+          }
+          ci->second->add(a, b);
+        }
+      }
+
+      // Nothing from this frame is needed any longer:
+      clearFrame(istep);
+      std::vector<int>().swap(sele1ToIndex_[istep]);
+      if (uniqueSelections_)
+        std::vector<int>().swap(sele2ToIndex_[istep]);
+    }
+
+    std::vector<int> lags = MultipleTauCorrelator(nComp, nLevels).getLags();
+    std::vector<RealType> sums(lags.size() * nComp, 0.0);
+    std::vector<RealType> counts(lags.size(), 0.0);
+
+    for (ci = correlators.begin(); ci != correlators.end(); ++ci) {
+      ci->second->addTo(sums, counts);
+      delete ci->second;
+    }
+
+    // The time bins are now the correlator's lags that fit inside
+    // the trajectory:
+    nTimeBins_ = 0;
+    while (nTimeBins_ < lags.size() && lags[nTimeBins_] < nFrames_)
+      nTimeBins_++;
+
+    histogram_.resize(nTimeBins_);
+    count_.resize(nTimeBins_);
+    times_.resize(nTimeBins_);
+
+    for (unsigned int i = 0; i < nTimeBins_; ++i) {
+      times_[i] = lags[i] * deltaTime_;
+      histogram_[i] = combineComponents(&sums[i * nComp]);
+      count_[i] = int(counts[i] + 0.5);
+    }
+  }
+
   /*
   template<typename T>
   void TimeCorrFunc<T>::validateSelection(SelectionManager& seleMan) {   
@@ -92,8 +92,48 @@ namespace OpenMD {
     virtual void computeFrame(int frame);
     virtual void validateSelection(SelectionManager& seleMan);
     virtual void correlateFrames(int frame1, int frame2, int timeBin);
+    virtual void correlateFFT();
+    virtual void correlateMultipleTau();
     virtual void writeCorrelate();
 
+    /**
+     * Linear correlation functions can also hand over the quantities
+     * being correlated as sets of real-valued components.  If
+     * calcCorrVal is a linear combination of the products of
+     * component k from the first property (at frame1) with component
+     * k from the second property (at frame2), the whole correlation
+     * function can be computed with FFTs (the Wiener-Khinchin
+     * theorem) in O(nFrames log nFrames) time per object rather than
+     * by visiting every pair of frames.  Correlation functions that
+     * return a non-zero number of components here must also
+     * implement getComponents1 and combineComponents.  For system
+     * properties, the id passed to getComponents is always 0.
+     */
+    virtual int getNComponents() { return 0; }
+    virtual void getComponents1(int frame, int id, RealType* c) { }
+    virtual void getComponents2(int frame, int id, RealType* c) {
+      getComponents1(frame, id, c);
+    }
+    /**
+     * Converts sums of component products (one per component) into
+     * the correlation value.  Must be linear in c.
+     */
+    virtual T combineComponents(const RealType* c) { return T(0.0); }
+
+    /**
+     * The multiple-tau correlator hands each frame's components over
+     * as soon as the frame has been read, so it can only be used if
+     * the components don't depend on averages over the whole
+     * trajectory.
+     */
+    virtual bool isStreamable() { return getNComponents() > 0; }
+    /**
+     * Releases the stored properties of a frame that the
+     * multiple-tau correlator no longer needs.
+     */
+    virtual void clearFrame(int frame) { }
+    void loadSelections();
+
     // The pure virtual functions that must be implemented.
     
     // For System Properties:
@@ -129,4 +129,27 @@ namespace OpenMD {
       }
     }
   }
+
+  // The outer product a(t1) b(t2) has the components a_i(t1) * b_j(t2):
+  void TorForCorrFunc::getComponents1(int frame, int id, RealType* c) {
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 3; j++)
+        c[3*i + j] = torques_[frame][id][i];
+  }
+  void TorForCorrFunc::getComponents2(int frame, int id, RealType* c) {
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 3; j++)
+        c[3*i + j] = forces_[frame][id][j];
+  }
+  Mat3x3d TorForCorrFunc::combineComponents(const RealType* c) {
+    Mat3x3d corrTensor(0.0);
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 3; j++)
+        corrTensor(i, j) = c[3*i + j];
+    return corrTensor;
+  }
+  void TorForCorrFunc::clearFrame(int frame) {
+    std::vector<Vector3d>().swap(forces_[frame]);
+    std::vector<Vector3d>().swap(torques_[frame]);
+  }
 }
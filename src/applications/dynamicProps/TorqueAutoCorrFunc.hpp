@@ -55,6 +55,11 @@ namespace OpenMD {
     virtual void validateSelection(SelectionManager& seleMan);    
     virtual int computeProperty1(int frame, StuntDouble* sd);
     virtual Mat3x3d calcCorrVal(int frame1, int frame2, int id1, int id2);
+    virtual int getNComponents() { return 9; }
+    virtual void getComponents1(int frame, int id, RealType* c);
+    virtual void getComponents2(int frame, int id, RealType* c);
+    virtual Mat3x3d combineComponents(const RealType* c);
+    virtual void clearFrame(int frame);
     virtual void postCorrelate();
 
     std::vector<std::vector<Vector3d> > torques_;
@@ -118,5 +118,35 @@ namespace OpenMD {
     v2  = velocities_[frame1][id1] * velocities_[frame2][id2];
     return v2;
   }
+
+  void VCorrFunc::getComponents1(int frame, int id, RealType* c) {
+    for (int i = 0; i < 3; i++) c[i] = velocities_[frame][id][i];
+  }
+  RealType VCorrFunc::combineComponents(const RealType* c) {
+    return c[0] + c[1] + c[2];
+  }
+  void VCorrFunc::clearFrame(int frame) {
+    std::vector<Vector3d>().swap(velocities_[frame]);
+  }
+
+  void VCorrFuncZ::getComponents1(int frame, int id, RealType* c) {
+    c[0] = velocities_[frame][id];
+  }
+  RealType VCorrFuncZ::combineComponents(const RealType* c) {
+    return c[0];
+  }
+  void VCorrFuncZ::clearFrame(int frame) {
+    std::vector<RealType>().swap(velocities_[frame]);
+  }
+
+  void VCorrFuncR::getComponents1(int frame, int id, RealType* c) {
+    c[0] = velocities_[frame][id];
+  }
+  RealType VCorrFuncR::combineComponents(const RealType* c) {
+    return c[0];
+  }
+  void VCorrFuncR::clearFrame(int frame) {
+    std::vector<RealType>().swap(velocities_[frame]);
+  }
 }
 
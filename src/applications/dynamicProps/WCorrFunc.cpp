@@ -90,4 +90,13 @@ namespace OpenMD {
     }
   }
 
+  void WCorrFunc::getComponents1(int frame, int id, RealType* c) {
+    c[0] = charge_velocities_[frame][id];
+  }
+  RealType WCorrFunc::combineComponents(const RealType* c) {
+    return c[0];
+  }
+  void WCorrFunc::clearFrame(int frame) {
+    std::vector<RealType>().swap(charge_velocities_[frame]);
+  }
 }
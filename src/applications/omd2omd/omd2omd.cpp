@@ -53,6 +53,7 @@
 #include "io/DumpReader.hpp"
 #include "io/DumpWriter.hpp"
 #include "utils/simError.h"
+#include "utils/CaseConversion.hpp"
 #include "utils/Constants.hpp"
 #include "math/Quaternion.hpp"
 
@@ -134,6 +135,29 @@ int main(int argc, char* argv[]){
   SimCreator newCreator;
   SimInfo* newInfo = newCreator.createSim(outFileName, false);
 
+  // The input format is detected by the DumpReader; the output format
+  // comes from the meta-data unless it is overridden here:
+  if (args_info.format_given) {
+    std::string format(args_info.format_arg);
+    toUpper(format);
+    if (format != "TEXT" && format != "BINARY") {
+      sprintf(painCave.errMsg, "Unknown output format: %s\n"
+              "\tChoose either text or binary.\n", args_info.format_arg);
+      painCave.isFatal = 1;
+      simError();
+    }
+    newInfo->getSimParams()->setDumpFileFormat(format);
+  }
+  if (args_info.precision_given) {
+    if (args_info.precision_arg <= 0.0) {
+      strcpy( painCave.errMsg,
+              "The position precision must be positive.\n" );
+      painCave.isFatal = 1;
+      simError();
+    }
+    newInfo->getSimParams()->setDumpPositionPrecision(args_info.precision_arg);
+  }
+
   DumpReader* dumpReader = new DumpReader(oldInfo, dumpFileName);
   int nframes = dumpReader->getNFrames();
   
@@ -266,6 +290,13 @@ void createMdFile(const std::string&oldMdFileName,
       }
     } else
       newMdFile << buffer << std::endl;
+
+    // only the meta-data is needed; the frames (which may be binary)
+    // are written later by the DumpWriter:
+    if (strstr(buffer, "</MetaData>") != NULL) {
+      newMdFile << "</OpenMD>" << std::endl;
+      break;
+    }
     
     oldMdFile.getline(buffer, MAXLEN);
   }
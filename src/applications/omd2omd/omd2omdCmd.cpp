@@ -46,6 +46,8 @@ const char *gengetopt_args_info_help[] = {
   "  -p, --rotatePhi=DOUBLE    rotate all coordinates Euler angle Phi\n                              (default=`0.0')",
   "  -q, --rotateTheta=DOUBLE  rotate all coordinates Euler angle Theta\n                              (default=`0.0')",
   "  -r, --rotatePsi=DOUBLE    rotate all coordinates Euler angle Psi\n                              (default=`0.0')",
+  "  -f, --format=format       output trajectory format (text or binary)",
+  "  -e, --precision=DOUBLE    quantize binary output positions to this precision\n                              (angstroms)",
     0
 };
 
@@ -86,6 +88,8 @@ void clear_given (struct gengetopt_args_info *args_info)
   args_info->rotatePhi_given = 0 ;
   args_info->rotateTheta_given = 0 ;
   args_info->rotatePsi_given = 0 ;
+  args_info->format_given = 0 ;
+  args_info->precision_given = 0 ;
 }
 
 static
@@ -114,6 +118,9 @@ void clear_args (struct gengetopt_args_info *args_info)
   args_info->rotateTheta_orig = NULL;
   args_info->rotatePsi_arg = 0.0;
   args_info->rotatePsi_orig = NULL;
+  args_info->format_arg = NULL;
+  args_info->format_orig = NULL;
+  args_info->precision_orig = NULL;
   
 }
 
@@ -135,6 +142,8 @@ void init_args_info(struct gengetopt_args_info *args_info)
   args_info->rotatePhi_help = gengetopt_args_info_help[10] ;
   args_info->rotateTheta_help = gengetopt_args_info_help[11] ;
   args_info->rotatePsi_help = gengetopt_args_info_help[12] ;
+  args_info->format_help = gengetopt_args_info_help[13] ;
+  args_info->precision_help = gengetopt_args_info_help[14] ;
   
 }
 
@@ -234,6 +243,9 @@ cmdline_parser_release (struct gengetopt_args_info *args_info)
   free_string_field (&(args_info->rotatePhi_orig));
   free_string_field (&(args_info->rotateTheta_orig));
   free_string_field (&(args_info->rotatePsi_orig));
+  free_string_field (&(args_info->format_arg));
+  free_string_field (&(args_info->format_orig));
+  free_string_field (&(args_info->precision_orig));
   
   
   for (i = 0; i < args_info->inputs_num; ++i)
@@ -295,6 +307,10 @@ cmdline_parser_dump(FILE *outfile, struct gengetopt_args_info *args_info)
     write_into_file(outfile, "rotateTheta", args_info->rotateTheta_orig, 0);
   if (args_info->rotatePsi_given)
     write_into_file(outfile, "rotatePsi", args_info->rotatePsi_orig, 0);
+  if (args_info->format_given)
+    write_into_file(outfile, "format", args_info->format_orig, 0);
+  if (args_info->precision_given)
+    write_into_file(outfile, "precision", args_info->precision_orig, 0);
   
 
   i = EXIT_SUCCESS;
@@ -1175,6 +1191,8 @@ cmdline_parser_internal (
         { "rotatePhi",	1, NULL, 'p' },
         { "rotateTheta",	1, NULL, 'q' },
         { "rotatePsi",	1, NULL, 'r' },
+        { "format",	1, NULL, 'f' },
+        { "precision",	1, NULL, 'e' },
         { 0,  0, 0, 0 }
       };
 
@@ -1183,7 +1201,7 @@ cmdline_parser_internal (
       custom_opterr = opterr;
       custom_optopt = optopt;
 
-      c = custom_getopt_long (argc, argv, "hVi:o:x:y:z:t:u:v:p:q:r:", long_options, &option_index);
+      c = custom_getopt_long (argc, argv, "hVi:o:x:y:z:t:u:v:p:q:r:f:e:", long_options, &option_index);
 
       optarg = custom_optarg;
       optind = custom_optind;
@@ -1336,6 +1354,30 @@ cmdline_parser_internal (
             goto failure;
         
           break;
+        case 'f':	/* output trajectory format (text or binary).  */
+        
+        
+          if (update_arg( (void *)&(args_info->format_arg), 
+               &(args_info->format_orig), &(args_info->format_given),
+              &(local_args_info.format_given), optarg, 0, 0, ARG_STRING,
+              check_ambiguity, override, 0, 0,
+              "format", 'f',
+              additional_error))
+            goto failure;
+        
+          break;
+        case 'e':	/* quantize binary output positions to this precision (angstroms).  */
+        
+        
+          if (update_arg( (void *)&(args_info->precision_arg), 
+               &(args_info->precision_orig), &(args_info->precision_given),
+              &(local_args_info.precision_given), optarg, 0, 0, ARG_DOUBLE,
+              check_ambiguity, override, 0, 0,
+              "precision", 'e',
+              additional_error))
+            goto failure;
+        
+          break;
 
         case 0:	/* Long option with no short option */
         case '?':	/* Invalid option.  */
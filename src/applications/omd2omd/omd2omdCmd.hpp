@@ -72,6 +72,12 @@ struct gengetopt_args_info
   double rotatePsi_arg;	/**< @brief rotate all coordinates Euler angle Psi (default='0.0').  */
   char * rotatePsi_orig;	/**< @brief rotate all coordinates Euler angle Psi original value given at command line.  */
   const char *rotatePsi_help; /**< @brief rotate all coordinates Euler angle Psi help description.  */
+  char * format_arg;	/**< @brief output trajectory format (text or binary).  */
+  char * format_orig;	/**< @brief output trajectory format (text or binary) original value given at command line.  */
+  const char *format_help; /**< @brief output trajectory format (text or binary) help description.  */
+  double precision_arg;	/**< @brief quantize binary output positions to this precision (angstroms).  */
+  char * precision_orig;	/**< @brief quantize binary output positions to this precision (angstroms) original value given at command line.  */
+  const char *precision_help; /**< @brief quantize binary output positions to this precision (angstroms) help description.  */
   
   unsigned int help_given ;	/**< @brief Whether help was given.  */
   unsigned int version_given ;	/**< @brief Whether version was given.  */
@@ -86,6 +92,8 @@ struct gengetopt_args_info
   unsigned int rotatePhi_given ;	/**< @brief Whether rotatePhi was given.  */
   unsigned int rotateTheta_given ;	/**< @brief Whether rotateTheta was given.  */
   unsigned int rotatePsi_given ;	/**< @brief Whether rotatePsi was given.  */
+  unsigned int format_given ;	/**< @brief Whether format was given.  */
+  unsigned int precision_given ;	/**< @brief Whether precision was given.  */
 
   char **inputs ; /**< @brief unamed options (options without names) */
   unsigned inputs_num ; /**< @brief unamed options number */
@@ -81,6 +81,12 @@ namespace OpenMD {
     values_.push_back( comVel );
   }
   
+  void COMVel::mergeSequence(SequentialAnalyzer* worker) {
+    SequentialAnalyzer::mergeSequence(worker);
+    COMVel* w = static_cast<COMVel*>(worker);
+    values_.insert(values_.end(), w->values_.begin(), w->values_.end());
+  }
+
   void COMVel::writeSequence() {
     std::ofstream ofs(outputFilename_.c_str(), std::ios::binary);
     
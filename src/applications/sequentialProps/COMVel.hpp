@@ -51,7 +51,9 @@ namespace OpenMD {
     COMVel(SimInfo* info, const std::string& filename, 
 	   const std::string& sele1, const std::string& sele2);
     
+    bool isFrameParallel() { return true; }
     virtual void doFrame(int frame);
+    virtual void mergeSequence(SequentialAnalyzer* worker);
     virtual void writeSequence();
     
   private:
@@ -81,6 +81,12 @@ namespace OpenMD {
     values_.push_back( com );
   }
   
+  void CenterOfMass::mergeSequence(SequentialAnalyzer* worker) {
+    SequentialAnalyzer::mergeSequence(worker);
+    CenterOfMass* w = static_cast<CenterOfMass*>(worker);
+    values_.insert(values_.end(), w->values_.begin(), w->values_.end());
+  }
+
   void CenterOfMass::writeSequence() {
     std::ofstream ofs(outputFilename_.c_str(), std::ios::binary);
     
@@ -80,6 +80,7 @@ namespace OpenMD {
                   RealType solidZ, RealType dropletRadius);
 
     virtual void doFrame(int frame);
+    bool isFrameParallel() { return true; }
     
   private:
     RealType solidZ_;
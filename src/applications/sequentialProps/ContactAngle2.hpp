@@ -55,6 +55,7 @@ namespace OpenMD {
                   int nrbins, int nZBins);
     
     virtual void doFrame(int frame);
+    bool isFrameParallel() { return true; }
     
   private:
 
@@ -175,6 +175,13 @@ namespace OpenMD {
     histogram_.push_back(histo);
   }
 
+  void GCNSeq::mergeSequence(SequentialAnalyzer* worker) {
+    SequentialAnalyzer::mergeSequence(worker);
+    GCNSeq* w = static_cast<GCNSeq*>(worker);
+    count_.insert(count_.end(), w->count_.begin(), w->count_.end());
+    histogram_.insert(histogram_.end(), w->histogram_.begin(), w->histogram_.end());
+  }
+
   void GCNSeq::writeSequence() {
     std::ofstream ofs(outputFilename_.c_str(), std::ios::binary);
     
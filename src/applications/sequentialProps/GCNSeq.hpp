@@ -73,7 +73,9 @@ namespace OpenMD {
            const std::string& sele2, RealType rCut, int bins);
 
     virtual ~GCNSeq();
+    bool isFrameParallel() { return true; }
     virtual void doFrame(int istep);
+    virtual void mergeSequence(SequentialAnalyzer* worker);
     virtual void writeSequence();
     
   private:
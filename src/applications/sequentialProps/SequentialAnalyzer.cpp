@@ -74,33 +74,69 @@ namespace OpenMD {
   }
   
   void SequentialAnalyzer::doSequence() {
+    std::vector<SequentialAnalyzer*> noWorkers;
+    doSequence(noWorkers);
+  }
 
-    preSequence();
+  void SequentialAnalyzer::doSequence(std::vector<SequentialAnalyzer*>& workers) {
 
-    DumpReader reader(info_, dumpFilename_); 
-    int nFrames = reader.getNFrames();
-  
-    storageLayout_ = info_->getStorageLayout();
+    // This analyzer takes the first block of frames and the workers
+    // the following ones, so appending the workers' sequences in
+    // order keeps the frames in trajectory order.
+    std::vector<SequentialAnalyzer*> all(1, this);
+    all.insert(all.end(), workers.begin(), workers.end());
+    int nWorkers = all.size();
 
-    for (frame_ = 0; frame_ < nFrames; frame_ += step_) {
-      reader.readFrame(frame_);
-      currentSnapshot_ = info_->getSnapshotManager()->getCurrentSnapshot();
-      times_.push_back( currentSnapshot_->getTime() );
-      
-      if (evaluator1_.isDynamic()) {
-        seleMan1_.setSelectionSet(evaluator1_.evaluate());
-      }
-      if (evaluator2_.isDynamic()) {
-        seleMan2_.setSelectionSet(evaluator2_.evaluate());
+    // The readers are opened one after another so that the frame index
+    // written by the first one is simply loaded by the rest.
+    std::vector<DumpReader*> readers(nWorkers);
+    for (int w = 0; w < nWorkers; w++) {
+      all[w]->preSequence();
+      readers[w] = new DumpReader(all[w]->info_, dumpFilename_);
+      all[w]->storageLayout_ = all[w]->info_->getStorageLayout();
+    }
+
+    int nFrames = readers[0]->getNFrames();
+    int nSteps = (nFrames + step_ - 1) / step_;
+
+#pragma omp parallel for schedule(static, 1) num_threads(nWorkers)
+    for (int w = 0; w < nWorkers; w++) {
+      SequentialAnalyzer* sa = all[w];
+      int first = int((long)nSteps * w / nWorkers);
+      int last = int((long)nSteps * (w + 1) / nWorkers);
+
+      for (int s = first; s < last; s++) {
+        sa->frame_ = s * step_;
+        readers[w]->readFrame(sa->frame_);
+        sa->currentSnapshot_ = sa->info_->getSnapshotManager()->getCurrentSnapshot();
+        sa->times_.push_back( sa->currentSnapshot_->getTime() );
+
+        if (sa->evaluator1_.isDynamic()) {
+          sa->seleMan1_.setSelectionSet(sa->evaluator1_.evaluate());
+        }
+        if (sa->evaluator2_.isDynamic()) {
+          sa->seleMan2_.setSelectionSet(sa->evaluator2_.evaluate());
+        }
+
+        sa->doFrame(sa->frame_);
       }
-            
-      doFrame(frame_);
-    }   
+    }
+
+    for (int w = 0; w < nWorkers; w++) delete readers[w];
+
+    for (unsigned int w = 0; w < workers.size(); w++)
+      mergeSequence(workers[w]);
 
     postSequence();
-    writeSequence();   
+    writeSequence();
   }
-  
+
+  void SequentialAnalyzer::mergeSequence(SequentialAnalyzer* worker) {
+    times_.insert(times_.end(), worker->times_.begin(), worker->times_.end());
+    values_.insert(values_.end(), worker->values_.begin(),
+                   worker->values_.end());
+  }
+
   void SequentialAnalyzer::writeSequence() {
     std::ofstream ofs(outputFilename_.c_str(), std::ios::binary);
 
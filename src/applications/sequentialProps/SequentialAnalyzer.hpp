@@ -66,6 +66,23 @@ namespace OpenMD {
     virtual ~SequentialAnalyzer(){ }
     virtual void doSequence();
 
+    /**
+     * Analyzers whose doFrame() depends only on the current frame can
+     * share the trajectory among several workers, each an identically
+     * configured analyzer built on its own SimInfo.  Such analyzers
+     * return true here, and override mergeSequence() if they keep
+     * per-frame results beyond times_ and values_.
+     */
+    virtual bool isFrameParallel() { return false; }
+
+    /**
+     * Splits the frames into contiguous blocks, one for this analyzer
+     * and one for each of the workers (processed concurrently when
+     * OpenMP is available), then appends the workers' sequences in
+     * trajectory order and writes the output.
+     */
+    void doSequence(std::vector<SequentialAnalyzer*>& workers);
+
     void setOutputName(const std::string& filename) {
       outputFilename_ = filename;
     }
@@ -98,6 +115,7 @@ namespace OpenMD {
     virtual void postSequence() {}
     virtual void writeSequence();
     virtual void doFrame(int frame) = 0;
+    virtual void mergeSequence(SequentialAnalyzer* worker);
 
     SimInfo* info_;
     Snapshot* currentSnapshot_;
@@ -60,54 +60,11 @@
 
 using namespace OpenMD;
 
-int main(int argc, char* argv[]){
-
-  gengetopt_args_info args_info;
-
-  //parse the command line option
-  if (cmdline_parser (argc, argv, &args_info) != 0) {
-    exit(1) ;
-  }
-
-  //get the dumpfile name and meta-data file name
-  std::string dumpFileName = args_info.input_arg;
-
-  std::string sele1;
-  std::string sele2;
-
-  // check the first selection argument, or set it to the environment
-  // variable, or failing that, set it to "select all"
-
-  if (args_info.sele1_given) {
-    sele1 = args_info.sele1_arg;
-  } else {
-    char*  sele1Env= getenv("SELECTION1");
-    if (sele1Env) {
-      sele1 = sele1Env;
-    } else {
-      sele1 = "select all";
-    }
-  }
-
-  // check the second selection argument, or set it to the environment
-  // variable, or failing that, set it to the first selection
-
-  if (args_info.sele2_given) {
-    sele2 = args_info.sele2_arg;
-  } else {
-    char* sele2Env = getenv("SELECTION2");
-    if (sele2Env) {
-      sele2 = sele2Env;
-    } else {
-      //If sele2 is not specified, then the default behavior
-      //should be what is already intended for sele1
-      sele2 = sele1;
-    }
-  }
-
-  //parse md file and set up the system
-  SimCreator creator;
-  SimInfo* info = creator.createSim(dumpFileName, false);
+static SequentialAnalyzer* createAnalyzer(SimInfo* info,
+                                          gengetopt_args_info& args_info,
+                                          const std::string& dumpFileName,
+                                          const std::string& sele1,
+                                          const std::string& sele2) {
 
   SequentialAnalyzer* analyzer = NULL;
   if(args_info.com_given){
@@ -209,11 +166,100 @@ int main(int argc, char* argv[]){
                                  args_info.nbins_arg, args_info.nbins_z_arg);
   }
 
+  return analyzer;
+}
+
+int main(int argc, char* argv[]){
+
+  gengetopt_args_info args_info;
+
+  //parse the command line option
+  if (cmdline_parser (argc, argv, &args_info) != 0) {
+    exit(1) ;
+  }
+
+  //get the dumpfile name and meta-data file name
+  std::string dumpFileName = args_info.input_arg;
+
+  std::string sele1;
+  std::string sele2;
+
+  // check the first selection argument, or set it to the environment
+  // variable, or failing that, set it to "select all"
+
+  if (args_info.sele1_given) {
+    sele1 = args_info.sele1_arg;
+  } else {
+    char*  sele1Env= getenv("SELECTION1");
+    if (sele1Env) {
+      sele1 = sele1Env;
+    } else {
+      sele1 = "select all";
+    }
+  }
+
+  // check the second selection argument, or set it to the environment
+  // variable, or failing that, set it to the first selection
+
+  if (args_info.sele2_given) {
+    sele2 = args_info.sele2_arg;
+  } else {
+    char* sele2Env = getenv("SELECTION2");
+    if (sele2Env) {
+      sele2 = sele2Env;
+    } else {
+      //If sele2 is not specified, then the default behavior
+      //should be what is already intended for sele1
+      sele2 = sele1;
+    }
+  }
+
+  //parse md file and set up the system
+  SimCreator creator;
+  SimInfo* info = creator.createSim(dumpFileName, false);
+
+  SequentialAnalyzer* analyzer = createAnalyzer(info, args_info, dumpFileName,
+                                                sele1, sele2);
+
   if (args_info.output_given) {
     analyzer->setOutputName(args_info.output_arg);
   }
 
-  analyzer->doSequence();
+  int nThreads = args_info.threads_arg;
+
+  if (nThreads > 1 && !analyzer->isFrameParallel()) {
+    sprintf( painCave.errMsg,
+             "This sequence does not support processing frames in "
+             "parallel;\n\tthe trajectory will be read on a single thread.\n");
+    painCave.severity = OPENMD_INFO;
+    painCave.isFatal = 0;
+    simError();
+    nThreads = 1;
+  }
+
+  if (nThreads > 1) {
+    // Every worker gets its own copy of the system and an identically
+    // configured analyzer:
+    std::vector<SimInfo*> workerInfos;
+    std::vector<SequentialAnalyzer*> workers;
+    for (int i = 1; i < nThreads; i++) {
+      SimCreator workerCreator;
+      SimInfo* workerInfo = workerCreator.createSim(dumpFileName, false);
+      SequentialAnalyzer* worker = createAnalyzer(workerInfo, args_info,
+                                                  dumpFileName, sele1, sele2);
+      workerInfos.push_back(workerInfo);
+      workers.push_back(worker);
+    }
+
+    analyzer->doSequence(workers);
+
+    for (unsigned int i = 0; i < workers.size(); i++) {
+      delete workers[i];
+      delete workerInfos[i];
+    }
+  } else {
+    analyzer->doSequence();
+  }
 
   delete analyzer;
   delete info;
@@ -37,6 +37,7 @@ const char *gengetopt_args_info_help[] = {
   "  -V, --version                 Print version and exit",
   "  -i, --input=filename          input dump file (mandatory)",
   "  -o, --output=filename         output file name",
+  "      --threads=INT             number of threads used to process frames in\n                                  parallel  (default=`1')",
   "      --sele1=selection script  select first stuntdouble set",
   "      --sele2=selection script  select second stuntdouble set (if sele2 is not\n                                  set, use script from sele1)",
   "  -b, --nbins=INT               number of bins (general purpose)\n                                  (default=`100')",
@@ -86,6 +87,7 @@ void clear_given (struct gengetopt_args_info *args_info)
   args_info->version_given = 0 ;
   args_info->input_given = 0 ;
   args_info->output_given = 0 ;
+  args_info->threads_given = 0 ;
   args_info->sele1_given = 0 ;
   args_info->sele2_given = 0 ;
   args_info->nbins_given = 0 ;
@@ -114,6 +116,8 @@ void clear_args (struct gengetopt_args_info *args_info)
   args_info->input_orig = NULL;
   args_info->output_arg = NULL;
   args_info->output_orig = NULL;
+  args_info->threads_arg = 1;
+  args_info->threads_orig = NULL;
   args_info->sele1_arg = NULL;
   args_info->sele1_orig = NULL;
   args_info->sele2_arg = NULL;
@@ -141,23 +145,24 @@ void init_args_info(struct gengetopt_args_info *args_info)
   args_info->version_help = gengetopt_args_info_help[1] ;
   args_info->input_help = gengetopt_args_info_help[2] ;
   args_info->output_help = gengetopt_args_info_help[3] ;
-  args_info->sele1_help = gengetopt_args_info_help[4] ;
-  args_info->sele2_help = gengetopt_args_info_help[5] ;
-  args_info->nbins_help = gengetopt_args_info_help[6] ;
-  args_info->nbins_z_help = gengetopt_args_info_help[7] ;
-  args_info->centroidX_help = gengetopt_args_info_help[8] ;
-  args_info->centroidY_help = gengetopt_args_info_help[9] ;
-  args_info->referenceZ_help = gengetopt_args_info_help[10] ;
-  args_info->dropletR_help = gengetopt_args_info_help[11] ;
-  args_info->threshDens_help = gengetopt_args_info_help[12] ;
-  args_info->bufferLength_help = gengetopt_args_info_help[13] ;
-  args_info->rcut_help = gengetopt_args_info_help[14] ;
-  args_info->com_help = gengetopt_args_info_help[16] ;
-  args_info->comvel_help = gengetopt_args_info_help[17] ;
-  args_info->ca1_help = gengetopt_args_info_help[18] ;
-  args_info->ca2_help = gengetopt_args_info_help[19] ;
-  args_info->gcn_help = gengetopt_args_info_help[20] ;
-  args_info->testequi_help = gengetopt_args_info_help[21] ;
+  args_info->threads_help = gengetopt_args_info_help[4] ;
+  args_info->sele1_help = gengetopt_args_info_help[5] ;
+  args_info->sele2_help = gengetopt_args_info_help[6] ;
+  args_info->nbins_help = gengetopt_args_info_help[7] ;
+  args_info->nbins_z_help = gengetopt_args_info_help[8] ;
+  args_info->centroidX_help = gengetopt_args_info_help[9] ;
+  args_info->centroidY_help = gengetopt_args_info_help[10] ;
+  args_info->referenceZ_help = gengetopt_args_info_help[11] ;
+  args_info->dropletR_help = gengetopt_args_info_help[12] ;
+  args_info->threshDens_help = gengetopt_args_info_help[13] ;
+  args_info->bufferLength_help = gengetopt_args_info_help[14] ;
+  args_info->rcut_help = gengetopt_args_info_help[15] ;
+  args_info->com_help = gengetopt_args_info_help[17] ;
+  args_info->comvel_help = gengetopt_args_info_help[18] ;
+  args_info->ca1_help = gengetopt_args_info_help[19] ;
+  args_info->ca2_help = gengetopt_args_info_help[20] ;
+  args_info->gcn_help = gengetopt_args_info_help[21] ;
+  args_info->testequi_help = gengetopt_args_info_help[22] ;
   
 }
 
@@ -248,6 +253,7 @@ cmdline_parser_release (struct gengetopt_args_info *args_info)
   free_string_field (&(args_info->input_orig));
   free_string_field (&(args_info->output_arg));
   free_string_field (&(args_info->output_orig));
+  free_string_field (&(args_info->threads_orig));
   free_string_field (&(args_info->sele1_arg));
   free_string_field (&(args_info->sele1_orig));
   free_string_field (&(args_info->sele2_arg));
@@ -304,6 +310,8 @@ cmdline_parser_dump(FILE *outfile, struct gengetopt_args_info *args_info)
     write_into_file(outfile, "input", args_info->input_orig, 0);
   if (args_info->output_given)
     write_into_file(outfile, "output", args_info->output_orig, 0);
+  if (args_info->threads_given)
+    write_into_file(outfile, "threads", args_info->threads_orig, 0);
   if (args_info->sele1_given)
     write_into_file(outfile, "sele1", args_info->sele1_orig, 0);
   if (args_info->sele2_given)
@@ -1225,6 +1233,7 @@ cmdline_parser_internal (
         { "version",	0, NULL, 'V' },
         { "input",	1, NULL, 'i' },
         { "output",	1, NULL, 'o' },
+        { "threads",	1, NULL, 0 },
         { "sele1",	1, NULL, 0 },
         { "sele2",	1, NULL, 0 },
         { "nbins",	1, NULL, 'b' },
@@ -1402,8 +1411,22 @@ cmdline_parser_internal (
           break;
 
         case 0:	/* Long option with no short option */
+          /* number of threads used to process frames in parallel.  */
+          if (strcmp (long_options[option_index].name, "threads") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->threads_arg), 
+                 &(args_info->threads_orig), &(args_info->threads_given),
+                &(local_args_info.threads_given), optarg, 0, "1", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "threads", '-',
+                additional_error))
+              goto failure;
+          
+          }
           /* select first stuntdouble set.  */
-          if (strcmp (long_options[option_index].name, "sele1") == 0)
+          else if (strcmp (long_options[option_index].name, "sele1") == 0)
           {
           
           
@@ -45,6 +45,9 @@ struct gengetopt_args_info
   char * output_arg;	/**< @brief output file name.  */
   char * output_orig;	/**< @brief output file name original value given at command line.  */
   const char *output_help; /**< @brief output file name help description.  */
+  int threads_arg;	/**< @brief number of threads used to process frames in parallel (default='1').  */
+  char * threads_orig;	/**< @brief number of threads used to process frames in parallel original value given at command line.  */
+  const char *threads_help; /**< @brief number of threads used to process frames in parallel help description.  */
   char * sele1_arg;	/**< @brief select first stuntdouble set.  */
   char * sele1_orig;	/**< @brief select first stuntdouble set original value given at command line.  */
   const char *sele1_help; /**< @brief select first stuntdouble set help description.  */
@@ -89,6 +92,7 @@ struct gengetopt_args_info
   unsigned int version_given ;	/**< @brief Whether version was given.  */
   unsigned int input_given ;	/**< @brief Whether input was given.  */
   unsigned int output_given ;	/**< @brief Whether output was given.  */
+  unsigned int threads_given ;	/**< @brief Whether threads was given.  */
   unsigned int sele1_given ;	/**< @brief Whether sele1 was given.  */
   unsigned int sele2_given ;	/**< @brief Whether sele2 was given.  */
   unsigned int nbins_given ;	/**< @brief Whether nbins was given.  */
@@ -94,6 +94,13 @@ namespace OpenMD {
     TempJ_.push_back( angMom_Temp);
   }
 
+  void Equipartition::mergeSequence(SequentialAnalyzer* worker) {
+    SequentialAnalyzer::mergeSequence(worker);
+    Equipartition* w = static_cast<Equipartition*>(worker);
+    TempP_.insert(TempP_.end(), w->TempP_.begin(), w->TempP_.end());
+    TempJ_.insert(TempJ_.end(), w->TempJ_.begin(), w->TempJ_.end());
+  }
+
   void Equipartition::writeSequence() {
     std::ofstream ofs(outputFilename_.c_str(), std::ios::binary);
 
@@ -189,6 +189,13 @@ namespace OpenMD {
 
   }
 
+  void GofAngle2::mergeHistogram(RadialDistrFunc* worker) {
+    GofAngle2* w = static_cast<GofAngle2*>(worker);
+    for (unsigned int i = 0; i < avgGofr_.size(); ++i)
+      for (unsigned int j = 0; j < avgGofr_[i].size(); ++j)
+        avgGofr_[i][j] += w->avgGofr_[i][j];
+  }
+
   void GofAngle2::collectHistogram(StuntDouble* sd1, StuntDouble* sd2) {
     bool usePeriodicBoundaryConditions_ = info_->getSimParams()->getUsePeriodicBoundaryConditions();
     
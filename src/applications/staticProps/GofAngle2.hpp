@@ -68,6 +68,7 @@ namespace OpenMD {
     virtual void collectHistogram(StuntDouble* sd1, StuntDouble* sd2, 
                                   StuntDouble* sd3);
     virtual void processHistogram();
+    virtual void mergeHistogram(RadialDistrFunc* worker);
 
     virtual void writeRdf();
 
@@ -122,6 +122,12 @@ namespace OpenMD {
     
   }
   
+  void GofR::mergeHistogram(RadialDistrFunc* worker) {
+    GofR* w = static_cast<GofR*>(worker);
+    for (unsigned int i = 0; i < avgGofr_.size(); ++i)
+      avgGofr_[i] += w->avgGofr_[i];
+  }
+
   void GofR::collectHistogram(StuntDouble* sd1, StuntDouble* sd2) {
 
     if (sd1 == sd2) {
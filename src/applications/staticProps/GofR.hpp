@@ -64,7 +64,9 @@ namespace OpenMD {
     virtual void preProcess();
     virtual void initializeHistogram();
     virtual void collectHistogram(StuntDouble* sd1, StuntDouble* sd2);
+    virtual RealType getPairCutoff() { return len_; }
     virtual void processHistogram();
+    virtual void mergeHistogram(RadialDistrFunc* worker);
     virtual void postProcess();
 
     virtual void writeRdf();
@@ -228,6 +228,13 @@ namespace OpenMD {
     }
   }
 
+  void GofRAngle::mergeHistogram(RadialDistrFunc* worker) {
+    GofRAngle* w = static_cast<GofRAngle*>(worker);
+    for (unsigned int i = 0; i < avgGofr_.size(); ++i)
+      for (unsigned int j = 0; j < avgGofr_[i].size(); ++j)
+        avgGofr_[i][j] += w->avgGofr_[i][j];
+  }
+
   void GofRAngle::collectHistogram(StuntDouble* sd1, StuntDouble* sd2) {
 
     if (sd1 == sd2) {
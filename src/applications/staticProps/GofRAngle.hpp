@@ -75,7 +75,9 @@ namespace OpenMD {
 
     virtual void initializeHistogram();
     virtual void processHistogram();
+    virtual void mergeHistogram(RadialDistrFunc* worker);
     virtual void collectHistogram(StuntDouble* sd1, StuntDouble* sd2);
+    virtual RealType getPairCutoff() { return len_; }
     virtual void collectHistogram(StuntDouble* sd1, StuntDouble* sd2, 
                                   StuntDouble* sd3);
     virtual RealType evaluateAngle(StuntDouble* sd1, StuntDouble* sd2) = 0;
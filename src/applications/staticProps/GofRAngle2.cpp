@@ -235,6 +235,14 @@ namespace OpenMD {
     }
   }
   
+  void GofRAngle2::mergeHistogram(RadialDistrFunc* worker) {
+    GofRAngle2* w = static_cast<GofRAngle2*>(worker);
+    for (unsigned int i = 0; i < avgGofr_.size(); ++i)
+      for (unsigned int j = 0; j < avgGofr_[i].size(); ++j)
+        for (unsigned int k = 0; k < avgGofr_[i][j].size(); ++k)
+          avgGofr_[i][j][k] += w->avgGofr_[i][j][k];
+  }
+
   void GofRAngle2::collectHistogram(StuntDouble* sd1, StuntDouble* sd2) {
     bool usePeriodicBoundaryConditions_ = info_->getSimParams()->getUsePeriodicBoundaryConditions();
     
@@ -63,9 +63,11 @@ namespace OpenMD {
     virtual void processOverlapping( SelectionManager& sman );
     virtual void initializeHistogram();
     virtual void collectHistogram(StuntDouble* sd1, StuntDouble* sd2);
+    virtual RealType getPairCutoff() { return len_; }
     virtual void collectHistogram(StuntDouble* sd1, StuntDouble* sd2, 
                                   StuntDouble* sd3);
     virtual void processHistogram();
+    virtual void mergeHistogram(RadialDistrFunc* worker);
     virtual void writeRdf();
 
     unsigned int nAngleBins_;
@@ -114,6 +114,13 @@ namespace OpenMD {
 
   }
 
+  void GofRZ::mergeHistogram(RadialDistrFunc* worker) {
+    GofRZ* w = static_cast<GofRZ*>(worker);
+    for (unsigned int i = 0; i < avgGofr_.size(); ++i)
+      for (unsigned int j = 0; j < avgGofr_[i].size(); ++j)
+        avgGofr_[i][j] += w->avgGofr_[i][j];
+  }
+
   void GofRZ::collectHistogram(StuntDouble* sd1, StuntDouble* sd2) {
 
     if (sd1 == sd2) {
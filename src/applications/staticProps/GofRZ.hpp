@@ -65,7 +65,11 @@ namespace OpenMD {
       virtual void preProcess();
       virtual void initializeHistogram();
       virtual void processHistogram();
+      virtual void mergeHistogram(RadialDistrFunc* worker);
       virtual void collectHistogram(StuntDouble* sd1, StuntDouble* sd2);
+      virtual RealType getPairCutoff() {
+        return sqrt(len_ * len_ + zLen_ * zLen_);
+      }
       
       virtual void writeRdf();
       
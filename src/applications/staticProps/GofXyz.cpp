@@ -143,6 +143,14 @@ namespace OpenMD {
 
   }
 
+  void GofXyz::mergeHistogram(RadialDistrFunc* worker) {
+    GofXyz* w = static_cast<GofXyz*>(worker);
+    for (unsigned int i = 0; i < histogram_.size(); ++i)
+      for (unsigned int j = 0; j < histogram_[i].size(); ++j)
+        for (unsigned int k = 0; k < histogram_[i][j].size(); ++k)
+          histogram_[i][j][k] += w->histogram_[i][j][k];
+  }
+
   void GofXyz::collectHistogram(StuntDouble* sd1, StuntDouble* sd2) {
     bool usePeriodicBoundaryConditions_ = info_->getSimParams()->getUsePeriodicBoundaryConditions();
 
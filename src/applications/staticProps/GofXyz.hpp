@@ -63,7 +63,13 @@ namespace OpenMD {
 
     virtual void preProcess();
     void initializeHistogram();
+    virtual void mergeHistogram(RadialDistrFunc* worker);
     virtual void collectHistogram(StuntDouble* sd1, StuntDouble* sd2);
+    // bins are truncated toward zero, so the lowest bin reaches one
+    // bin width past -halfLen_:
+    virtual RealType getPairCutoff() {
+      return sqrt(3.0) * (halfLen_ + deltaR_);
+    }
     virtual void writeRdf();
         
     //virtual void validateSelection1(SelectionManager& sman);
@@ -103,6 +103,12 @@ namespace OpenMD {
 
   }
 
+  void GofZ::mergeHistogram(RadialDistrFunc* worker) {
+    GofZ* w = static_cast<GofZ*>(worker);
+    for (unsigned int i = 0; i < avgGofz_.size(); ++i)
+      avgGofz_[i] += w->avgGofz_[i];
+  }
+
   void GofZ::collectHistogram(StuntDouble* sd1, StuntDouble* sd2) {
     if (sd1 == sd2) {
       return;
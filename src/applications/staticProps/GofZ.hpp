@@ -57,7 +57,12 @@ namespace OpenMD {
     virtual void preProcess();
     virtual void initializeHistogram();
     virtual void collectHistogram(StuntDouble* sd1, StuntDouble* sd2);
+    virtual RealType getPairCutoff() {
+      RealType zMax = deltaZ_ * nBins_;
+      return sqrt(rC_ * rC_ + zMax * zMax);
+    }
     virtual void processHistogram();
+    virtual void mergeHistogram(RadialDistrFunc* worker);
     virtual void writeRdf();
 
     RealType deltaZ_;
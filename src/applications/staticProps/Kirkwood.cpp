@@ -86,6 +86,12 @@ namespace OpenMD {
     }
   }
 
+  void Kirkwood::mergeHistogram(RadialDistrFunc* worker) {
+    Kirkwood* w = static_cast<Kirkwood*>(worker);
+    for (unsigned int i = 0; i < avgKirkwood_.size(); ++i)
+      avgKirkwood_[i] += w->avgKirkwood_[i];
+  }
+
   void Kirkwood::collectHistogram(StuntDouble* sd1, StuntDouble* sd2) {
 
     if (sd1 == sd2) {
@@ -65,6 +65,7 @@ namespace OpenMD {
     virtual void initializeHistogram();
     virtual void collectHistogram(StuntDouble* sd1, StuntDouble* sd2);
     virtual void processHistogram();
+    virtual void mergeHistogram(RadialDistrFunc* worker);
     virtual void writeRdf();
 
     RealType len_;
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2005 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *                                                                      
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).             
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).          
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).          
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "applications/staticProps/PairCellList.hpp"
+
+namespace OpenMD {
+
+  bool PairCellList::setup(Snapshot* snap, bool usePBC, RealType cutoff,
+                           SelectionManager& sman1, SelectionManager& sman2) {
+    snap_ = snap;
+    usePBC_ = usePBC;
+
+    // The analysers test their own (slightly differently rounded)
+    // distances, so pad the cutoff a little to be sure that no pair
+    // they would accept is missed.
+    rCut_ = cutoff * (1.0 + 1.0e-8);
+    rCutSq_ = rCut_ * rCut_;
+
+    int nObjects = sman1.getSelectionCount() + sman2.getSelectionCount();
+    Vector3d widths;
+
+    if (usePBC_) {
+      invHmat_ = snap_->getInvHmat();
+      // The distance between opposite faces of the box along each
+      // scaled axis is 1/|row of invHmat|.
+      for (int i = 0; i < 3; i++)
+        widths[i] = 1.0 / invHmat_.getRow(i).length();
+    } else {
+      StuntDouble* sd;
+      int i;
+      bool first = true;
+      Vector3d hi;
+      SelectionManager* smans[2] = {&sman1, &sman2};
+      for (int s = 0; s < 2; s++) {
+        for (sd = smans[s]->beginSelected(i); sd != NULL;
+             sd = smans[s]->nextSelected(i)) {
+          Vector3d pos = sd->getPos();
+          if (first) {
+            lo_ = pos;
+            hi = pos;
+            first = false;
+          }
+          for (int k = 0; k < 3; k++) {
+            lo_[k] = std::min(lo_[k], pos[k]);
+            hi[k] = std::max(hi[k], pos[k]);
+          }
+        }
+      }
+      span_ = hi - lo_;
+      widths = span_;
+    }
+
+    for (int i = 0; i < 3; i++) {
+      nCellsPerSide_[i] = std::max(1, int(widths[i] / rCut_));
+    }
+
+    // Keep the grid from growing much beyond the number of objects
+    // when the cutoff is small compared to the box.
+    long maxCells = std::max(27, 2 * nObjects);
+    while ((long)nCellsPerSide_[0] * nCellsPerSide_[1] * nCellsPerSide_[2]
+           > maxCells) {
+      int big = 0;
+      for (int i = 1; i < 3; i++)
+        if (nCellsPerSide_[i] > nCellsPerSide_[big]) big = i;
+      if (nCellsPerSide_[big] <= 3) break;
+      nCellsPerSide_[big] = (nCellsPerSide_[big] + 1) / 2;
+    }
+
+    if (usePBC_) {
+      // Fewer than three cells along a periodic direction would make
+      // the wrapped stencil visit some cells twice.
+      for (int i = 0; i < 3; i++)
+        if (nCellsPerSide_[i] < 3) return false;
+    }
+
+    nCells_ = nCellsPerSide_[0] * nCellsPerSide_[1] * nCellsPerSide_[2];
+    return true;
+  }
+
+  int PairCellList::getCell(const Vector3d& pos) {
+    Vector3d scaled;
+    if (usePBC_) {
+      scaled = invHmat_ * pos;
+      for (int i = 0; i < 3; i++)
+        scaled[i] -= floor(scaled[i]);
+    } else {
+      for (int i = 0; i < 3; i++)
+        scaled[i] = span_[i] > 0.0 ? (pos[i] - lo_[i]) / span_[i] : 0.0;
+    }
+
+    Vector3i c;
+    for (int i = 0; i < 3; i++) {
+      c[i] = int(scaled[i] * nCellsPerSide_[i]);
+      // scaled coordinates of 1.0 can turn up after rounding:
+      c[i] = std::min(std::max(c[i], 0), nCellsPerSide_[i] - 1);
+    }
+    return (c[0] * nCellsPerSide_[1] + c[1]) * nCellsPerSide_[2] + c[2];
+  }
+
+  void PairCellList::fill(SelectionManager& sman, CellContents& cells) {
+    cells.resize(nCells_);
+    for (int c = 0; c < nCells_; c++)
+      cells[c].clear();
+
+    StuntDouble* sd;
+    int i;
+    for (sd = sman.beginSelected(i); sd != NULL; sd = sman.nextSelected(i)) {
+      Member m;
+      m.sd = sd;
+      m.index = i;
+      cells[getCell(sd->getPos())].push_back(m);
+    }
+  }
+
+  void PairCellList::getNeighbors(int cell, std::vector<int>& neighbors) {
+    neighbors.clear();
+
+    Vector3i c;
+    c[2] = cell % nCellsPerSide_[2];
+    c[1] = (cell / nCellsPerSide_[2]) % nCellsPerSide_[1];
+    c[0] = cell / (nCellsPerSide_[1] * nCellsPerSide_[2]);
+
+    Vector3i n;
+    for (int dx = -1; dx <= 1; dx++) {
+      n[0] = c[0] + dx;
+      for (int dy = -1; dy <= 1; dy++) {
+        n[1] = c[1] + dy;
+        for (int dz = -1; dz <= 1; dz++) {
+          n[2] = c[2] + dz;
+
+          Vector3i w = n;
+          bool inside = true;
+          for (int i = 0; i < 3; i++) {
+            if (w[i] < 0 || w[i] >= nCellsPerSide_[i]) {
+              if (usePBC_)
+                w[i] = (w[i] + nCellsPerSide_[i]) % nCellsPerSide_[i];
+              else
+                inside = false;
+            }
+          }
+          if (inside)
+            neighbors.push_back((w[0] * nCellsPerSide_[1] + w[1]) *
+                                nCellsPerSide_[2] + w[2]);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2005 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *                                                                      
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).             
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).          
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).          
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#ifndef APPLICATIONS_STATICPROPS_PAIRCELLLIST_HPP
+#define APPLICATIONS_STATICPROPS_PAIRCELLLIST_HPP
+
+#include <vector>
+
+#include "brains/Snapshot.hpp"
+#include "math/Vector3.hpp"
+#include "primitives/StuntDouble.hpp"
+#include "selection/SelectionManager.hpp"
+
+namespace OpenMD {
+
+  /**
+   * @class PairCellList
+   * @brief Spatial binning of selected StuntDoubles for pair histograms
+   *
+   * Sorts the objects of one or more selections into a grid of cells
+   * that are at least one cutoff wide, so that pair analysers only
+   * visit pairs in neighboring cells instead of every pair in the two
+   * selections.  With periodic boundaries the cells are built in
+   * scaled (box) coordinates, so triclinic boxes are handled, and the
+   * neighbor stencil wraps around the box.  Without periodic
+   * boundaries the grid spans the bounding box of the selections.
+   *
+   * Each binned object remembers its position in the selection, so
+   * that callers can visit overlapping pairs once and in the same
+   * order as a loop over the selection would.
+   */
+  class PairCellList {
+  public:
+    struct Member {
+      StuntDouble* sd;
+      int index;      /**< position in the selection it was binned from */
+    };
+    typedef std::vector<std::vector<Member> > CellContents;
+
+    PairCellList() : snap_(NULL), usePBC_(false), rCut_(0.0), rCutSq_(0.0),
+                     nCells_(0) {}
+
+    /**
+     * Lays out the grid for the current frame.  Returns false if the
+     * cutoff is too large for the box to hold at least three cells
+     * along every periodic direction; the caller should then fall
+     * back to looping over all pairs.
+     */
+    bool setup(Snapshot* snap, bool usePBC, RealType cutoff,
+               SelectionManager& sman1, SelectionManager& sman2);
+
+    /** Sorts the objects of a selection into cells. */
+    void fill(SelectionManager& sman, CellContents& cells);
+
+    int getNCells() { return nCells_; }
+
+    /** Indices of the (up to 27) cells neighboring (and including) cell. */
+    void getNeighbors(int cell, std::vector<int>& neighbors);
+
+    /**
+     * True if the (minimum image) separation of the two objects is
+     * within the cutoff the grid was laid out for.
+     */
+    bool inRange(StuntDouble* sd1, StuntDouble* sd2) {
+      Vector3d r12 = sd2->getPos() - sd1->getPos();
+      if (usePBC_) snap_->wrapVector(r12);
+      return r12.lengthSquare() <= rCutSq_;
+    }
+
+  private:
+    int getCell(const Vector3d& pos);
+
+    Snapshot* snap_;
+    bool usePBC_;
+    RealType rCut_;
+    RealType rCutSq_;
+    Mat3x3d invHmat_;
+    Vector3d lo_;
+    Vector3d span_;
+    Vector3i nCellsPerSide_;
+    int nCells_;
+  };
+
+}
+#endif
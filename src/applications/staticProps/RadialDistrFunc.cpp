@@ -56,7 +56,9 @@ namespace OpenMD {
     : StaticAnalyser(info, filename, nbins), selectionScript1_(sele1),
       selectionScript2_(sele2), evaluator1_(info), evaluator2_(info),
       seleMan1_(info), seleMan2_(info), sele1_minus_common_(info),
-      sele2_minus_common_(info), common_(info) {
+      sele2_minus_common_(info), common_(info), usePairCells_(false) {
+
+    usePBC_ = info->getSimParams()->getUsePeriodicBoundaryConditions();
 
     evaluator1_.loadScriptString(sele1);
     evaluator2_.loadScriptString(sele2);
@@ -87,71 +89,80 @@ namespace OpenMD {
   }
 
   void RadialDistrFunc::process() {
+    std::vector<StaticAnalyser*> noWorkers;
+    processFrames(noWorkers);
+  }
 
+  void RadialDistrFunc::beginFrames(int nFrames) {
     preProcess();
-
-    DumpReader reader(info_, dumpFilename_);
-    int nFrames = reader.getNFrames();
     nProcessed_ = nFrames / step_;
+  }
 
-    for (int i = 0; i < nFrames; i += step_) {
+  void RadialDistrFunc::collectFrame(int frame) {
 
-      reader.readFrame(i);
-      currentSnapshot_ = info_->getSnapshotManager()->getCurrentSnapshot();
+    currentSnapshot_ = info_->getSnapshotManager()->getCurrentSnapshot();
 
-      if (evaluator1_.isDynamic()) {
-	seleMan1_.setSelectionSet(evaluator1_.evaluate());
-	validateSelection1(seleMan1_);
-      }
-      if (evaluator2_.isDynamic()) {
-	seleMan2_.setSelectionSet(evaluator2_.evaluate());
-	validateSelection2(seleMan2_);
-      }
+    if (evaluator1_.isDynamic()) {
+      seleMan1_.setSelectionSet(evaluator1_.evaluate());
+      validateSelection1(seleMan1_);
+    }
+    if (evaluator2_.isDynamic()) {
+      seleMan2_.setSelectionSet(evaluator2_.evaluate());
+      validateSelection2(seleMan2_);
+    }
 
-      initializeHistogram();
-
-      // Selections may overlap, and we need a bit of logic to deal
-      // with this.
-      //
-      // |     s1    |
-      // | s1 -c | c |
-      //         | c | s2 - c |
-      //         |    s2      |
-      //
-      // s1 : Set of StuntDoubles in selection1
-      // s2 : Set of StuntDoubles in selection2
-      // c  : Intersection of selection1 and selection2
-      //
-      // When we loop over the pairs, we can divide the looping into 3
-      // stages:
-      //
-      // Stage 1 :     [s1-c]      [s2]
-      // Stage 2 :     [c]         [s2 - c]
-      // Stage 3 :     [c]         [c]
-      // Stages 1 and 2 are completely non-overlapping.
-      // Stage 3 is completely overlapping.
-
-      if (evaluator1_.isDynamic() || evaluator2_.isDynamic()) {
-	common_ = seleMan1_ & seleMan2_;
-	sele1_minus_common_ = seleMan1_ - common_;
-	sele2_minus_common_ = seleMan2_ - common_;
-	nSelected1_ = seleMan1_.getSelectionCount();
-	nSelected2_ = seleMan2_.getSelectionCount();
-	int nIntersect = common_.getSelectionCount();
-
-	nPairs_ = nSelected1_ * nSelected2_ - (nIntersect +1) * nIntersect/2;
-      }
+    initializeHistogram();
 
-      processNonOverlapping(sele1_minus_common_, seleMan2_);
-      processNonOverlapping(common_,             sele2_minus_common_);
-      processOverlapping(common_);
+    // Selections may overlap, and we need a bit of logic to deal
+    // with this.
+    //
+    // |     s1    |
+    // | s1 -c | c |
+    //         | c | s2 - c |
+    //         |    s2      |
+    //
+    // s1 : Set of StuntDoubles in selection1
+    // s2 : Set of StuntDoubles in selection2
+    // c  : Intersection of selection1 and selection2
+    //
+    // When we loop over the pairs, we can divide the looping into 3
+    // stages:
+    //
+    // Stage 1 :     [s1-c]      [s2]
+    // Stage 2 :     [c]         [s2 - c]
+    // Stage 3 :     [c]         [c]
+    // Stages 1 and 2 are completely non-overlapping.
+    // Stage 3 is completely overlapping.
 
-      processHistogram();
+    if (evaluator1_.isDynamic() || evaluator2_.isDynamic()) {
+      common_ = seleMan1_ & seleMan2_;
+      sele1_minus_common_ = seleMan1_ - common_;
+      sele2_minus_common_ = seleMan2_ - common_;
+      nSelected1_ = seleMan1_.getSelectionCount();
+      nSelected2_ = seleMan2_.getSelectionCount();
+      int nIntersect = common_.getSelectionCount();
 
+      nPairs_ = nSelected1_ * nSelected2_ - (nIntersect +1) * nIntersect/2;
     }
 
-    postProcess();
+    RealType pairCutoff = getPairCutoff();
+    usePairCells_ = pairCutoff > 0.0 &&
+      pairCells_.setup(currentSnapshot_, usePBC_, pairCutoff,
+                       seleMan1_, seleMan2_);
 
+    processNonOverlapping(sele1_minus_common_, seleMan2_);
+    processNonOverlapping(common_,             sele2_minus_common_);
+    processOverlapping(common_);
+
+    processHistogram();
+  }
+
+  void RadialDistrFunc::mergeFrames(StaticAnalyser* worker) {
+    mergeHistogram(static_cast<RadialDistrFunc*>(worker));
+  }
+
+  void RadialDistrFunc::endFrames() {
+    postProcess();
     writeRdf();
   }
 
@@ -167,6 +178,29 @@ namespace OpenMD {
     //   for (int j = 0; j < nj; ++j) {}
     // }
 
+    if (usePairCells_) {
+      // Only pairs in neighboring cells can be close enough to count:
+      pairCells_.fill(sman1, cells1_);
+      pairCells_.fill(sman2, cells2_);
+
+      for (int c = 0; c < pairCells_.getNCells(); ++c) {
+        if (cells1_[c].empty()) continue;
+        pairCells_.getNeighbors(c, neighbors_);
+        for (i = 0; i < int(cells1_[c].size()); ++i) {
+          sd1 = cells1_[c][i].sd;
+          for (unsigned int n = 0; n < neighbors_.size(); ++n) {
+            std::vector<PairCellList::Member>& cell2 = cells2_[neighbors_[n]];
+            for (j = 0; j < int(cell2.size()); ++j) {
+              sd2 = cell2[j].sd;
+              if (pairCells_.inRange(sd1, sd2))
+                collectHistogram(sd1, sd2);
+            }
+          }
+        }
+      }
+      return;
+    }
+
     for (sd1 = sman1.beginSelected(i); sd1 != NULL;
          sd1 = sman1.nextSelected(i)) {
       for (sd2 = sman2.beginSelected(j); sd2 != NULL;
@@ -187,6 +221,30 @@ namespace OpenMD {
     //   for (int j = i + 1; j < n; ++j) {}
     // }
 
+    if (usePairCells_) {
+      // Each pair is visited once, with the object that comes first
+      // in the selection passed first, just as in the loop below.
+      pairCells_.fill(sman, cells1_);
+
+      for (int c = 0; c < pairCells_.getNCells(); ++c) {
+        if (cells1_[c].empty()) continue;
+        pairCells_.getNeighbors(c, neighbors_);
+        for (unsigned int a = 0; a < cells1_[c].size(); ++a) {
+          PairCellList::Member& m1 = cells1_[c][a];
+          for (unsigned int n = 0; n < neighbors_.size(); ++n) {
+            std::vector<PairCellList::Member>& cell2 = cells1_[neighbors_[n]];
+            for (unsigned int b = 0; b < cell2.size(); ++b) {
+              if (cell2[b].index <= m1.index) continue;
+              sd2 = cell2[b].sd;
+              if (pairCells_.inRange(m1.sd, sd2))
+                collectHistogram(m1.sd, sd2);
+            }
+          }
+        }
+      }
+      return;
+    }
+
     for (sd1 = sman.beginSelected(i); sd1 != NULL;
          sd1 = sman.nextSelected(i)) {
       for (j  = i, sd2 = sman.nextSelected(j); sd2 != NULL;
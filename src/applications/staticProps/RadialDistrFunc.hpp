@@ -49,6 +49,7 @@
 #include "selection/SelectionManager.hpp"
 #include "utils/Constants.hpp"
 #include "applications/staticProps/StaticAnalyser.hpp"
+#include "applications/staticProps/PairCellList.hpp"
 
 namespace OpenMD {
 
@@ -65,9 +66,15 @@ namespace OpenMD {
     virtual ~RadialDistrFunc() {}
 
     void process();
+    bool isFrameParallel() { return true; }
     
   protected:
 
+    void beginFrames(int nFrames);
+    void collectFrame(int frame);
+    void mergeFrames(StaticAnalyser* worker);
+    void endFrames();
+
     virtual void preProcess() {}
     virtual void postProcess() {}
     virtual void processNonOverlapping(SelectionManager& sman1,
@@ -92,11 +99,30 @@ namespace OpenMD {
     SelectionManager sele2_minus_common_;
     SelectionManager common_;
 
+    bool usePBC_;
+    bool usePairCells_;
+    PairCellList pairCells_;
+    PairCellList::CellContents cells1_;
+    PairCellList::CellContents cells2_;
+    std::vector<int> neighbors_;
+
   private:
 
+    /**
+     * Upper bound on the separation of any pair that can contribute
+     * to the histogram.  Analysers that return a positive value only
+     * see pairs found through a PairCellList, rather than every pair
+     * of the two selections.  Since the pairs then arrive in a
+     * different order, only analysers whose histograms are insensitive
+     * to the order of accumulation should opt in.
+     */
+    virtual RealType getPairCutoff() { return 0.0; }
+
     virtual void initializeHistogram() {}
     virtual void collectHistogram(StuntDouble* sd1, StuntDouble* sd2) = 0;
     virtual void processHistogram() {}
+    /** Adds the accumulated histograms of another worker to ours */
+    virtual void mergeHistogram(RadialDistrFunc* worker) = 0;
 
     virtual void validateSelection1(SelectionManager& sman) {}
     virtual void validateSelection2(SelectionManager& sman) {}
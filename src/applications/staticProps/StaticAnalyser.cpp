@@ -41,6 +41,7 @@
  */
 
 #include "applications/staticProps/StaticAnalyser.hpp"
+#include "io/DumpReader.hpp"
 #include "utils/simError.h"
 #include "utils/Revision.hpp"
 
@@ -60,6 +61,46 @@ namespace OpenMD {
       counts_->accumulator.push_back( new Accumulator() );
   }
 
+  void StaticAnalyser::processFrames(std::vector<StaticAnalyser*>& workers) {
+
+    // This analyser takes the last block of frames, so that it is
+    // left holding the final frame just as it would after a serial
+    // pass; anything computed from the current snapshot in
+    // endFrames() is then unchanged.
+    std::vector<StaticAnalyser*> all(workers);
+    all.push_back(this);
+    int nWorkers = all.size();
+
+    // The readers are opened one after another so that the frame index
+    // written by the first one is simply loaded by the rest.
+    std::vector<DumpReader*> readers(nWorkers);
+    for (int w = nWorkers - 1; w >= 0; w--)
+      readers[w] = new DumpReader(all[w]->info_, dumpFilename_);
+
+    int nFrames = readers[nWorkers - 1]->getNFrames();
+    int nSteps = (nFrames + step_ - 1) / step_;
+
+    for (int w = 0; w < nWorkers; w++)
+      all[w]->beginFrames(nFrames);
+
+#pragma omp parallel for schedule(static, 1) num_threads(nWorkers)
+    for (int w = 0; w < nWorkers; w++) {
+      int first = int((long)nSteps * w / nWorkers);
+      int last = int((long)nSteps * (w + 1) / nWorkers);
+      for (int s = first; s < last; s++) {
+        readers[w]->readFrame(s * step_);
+        all[w]->collectFrame(s * step_);
+      }
+    }
+
+    for (int w = 0; w < nWorkers; w++) delete readers[w];
+
+    for (unsigned int w = 0; w < workers.size(); w++)
+      mergeFrames(workers[w]);
+
+    endFrames();
+  }
+
   void StaticAnalyser::writeOutput() {
     vector<OutputData*>::iterator i;
     OutputData* outputData;
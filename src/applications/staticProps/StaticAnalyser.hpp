@@ -43,6 +43,7 @@
 #define APPLICATIONS_STATICPROPS_STATICANALYSER_HPP
 
 #include <string>
+#include <vector>
 #include "brains/SimInfo.hpp"
 #include "brains/Snapshot.hpp"
 #include "utils/Accumulator.hpp"
@@ -80,6 +81,24 @@ namespace OpenMD {
     virtual ~StaticAnalyser() {}
     virtual void process()=0;
 
+    /**
+     * Analysers that accumulate their results frame by frame in
+     * private storage can share the trajectory among several workers.
+     * Such analysers return true here and implement beginFrames(),
+     * collectFrame(), mergeFrames() and endFrames().  Each worker is
+     * an identically configured analyser built on its own SimInfo.
+     */
+    virtual bool isFrameParallel() { return false; }
+
+    /**
+     * Splits the frames into contiguous blocks, processes one block
+     * in this analyser and one in each of the workers (concurrently
+     * when OpenMP is available), merges the workers' results and
+     * writes the output.  With no workers this is a plain serial
+     * pass over the trajectory.
+     */
+    void processFrames(std::vector<StaticAnalyser*>& workers);
+
     void setOutputName(const std::string& filename) {
       outputFilename_ = filename;
     }
@@ -108,6 +127,11 @@ namespace OpenMD {
     }
 
   protected:
+    virtual void beginFrames(int nFrames) {}
+    virtual void collectFrame(int frame) {}
+    virtual void mergeFrames(StaticAnalyser* worker) {}
+    virtual void endFrames() {}
+
     virtual void writeOutput();
     virtual void writeData(ostream& os, OutputData* dat, unsigned int bin);
     virtual void writeErrorBars(ostream& os, OutputData* dat, unsigned int bin);
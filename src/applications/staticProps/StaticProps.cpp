@@ -104,87 +104,13 @@
 
 using namespace OpenMD;
 
-int main(int argc, char* argv[]){
-
-
-  gengetopt_args_info args_info;
-
-  //parse the command line option
-  if (cmdline_parser (argc, argv, &args_info) != 0) {
-    exit(1) ;
-  }
-
-  //get the dumpfile name
-  std::string dumpFileName = args_info.input_arg;
-  std::string sele1;
-  std::string sele2;
-  std::string sele3;
-
-  // check the first selection argument, or set it to the environment
-  // variable, or failing that, set it to "select all"
-
-  if (args_info.sele1_given) {
-    sele1 = args_info.sele1_arg;
-  } else {
-    char*  sele1Env= getenv("SELECTION1");
-    if (sele1Env) {
-      sele1 = sele1Env;
-    } else {
-      sele1 = "select all";
-    }
-  }
-
-  // check the second selection argument, or set it to the environment
-  // variable, or failing that, set it to the first selection
-
-  if (args_info.sele2_given) {
-    sele2 = args_info.sele2_arg;
-  } else {
-    char* sele2Env = getenv("SELECTION2");
-    if (sele2Env) {
-      sele2 = sele2Env;
-    } else {
-      //If sele2 is not specified, then the default behavior
-      //should be what is already intended for sele1
-      sele2 = sele1;
-    }
-  }
-
-  // check the third selection argument, which is only set if
-  // requested by the user
-
-  if (args_info.sele3_given) sele3 = args_info.sele3_arg;
-
-  bool batchMode(false);
-  if (args_info.scd_given){
-    if (args_info.sele1_given &&
-        args_info.sele2_given && args_info.sele3_given) {
-      batchMode = false;
-    } else if (args_info.molname_given &&
-               args_info.begin_given && args_info.end_given) {
-      if (args_info.begin_arg < 0 ||
-          args_info.end_arg < 0 || args_info.begin_arg > args_info.end_arg-2) {
-        sprintf( painCave.errMsg,
-                 "below conditions are not satisfied:\n"
-                 "0 <= begin && 0<= end && begin <= end-2\n");
-        painCave.severity = OPENMD_ERROR;
-        painCave.isFatal = 1;
-        simError();
-      }
-      batchMode = true;
-    } else{
-      sprintf( painCave.errMsg,
-               "either --sele1, --sele2, --sele3 are specified,"
-               " or --molname, --begin, --end are specified\n");
-      painCave.severity = OPENMD_ERROR;
-      painCave.isFatal = 1;
-      simError();
-    }
-  }
-
-  //parse md file and set up the system
-  SimCreator creator;
-  SimInfo* info = creator.createSim(dumpFileName);
+static StaticAnalyser* createAnalyser(SimInfo* info,
+                                      gengetopt_args_info& args_info,
+                                      const std::string& dumpFileName,
+                                      const std::string& sele1,
+                                      const std::string& sele2,
+                                      const std::string& sele3,
+                                      bool batchMode) {
 
   // convert privilegedAxis to corresponding integer
   // x axis -> 0
@@ -285,7 +211,7 @@ RealType vRadius;
 
   }
 
-  StaticAnalyser* analyser;
+  StaticAnalyser* analyser = NULL;
 
   if (args_info.gofr_given){
     analyser= new GofR(info, dumpFileName, sele1, sele2, maxLen,
@@ -747,6 +673,93 @@ RealType vRadius;
 
   }
 
+  return analyser;
+}
+
+int main(int argc, char* argv[]){
+
+
+  gengetopt_args_info args_info;
+
+  //parse the command line option
+  if (cmdline_parser (argc, argv, &args_info) != 0) {
+    exit(1) ;
+  }
+
+  //get the dumpfile name
+  std::string dumpFileName = args_info.input_arg;
+  std::string sele1;
+  std::string sele2;
+  std::string sele3;
+
+  // check the first selection argument, or set it to the environment
+  // variable, or failing that, set it to "select all"
+
+  if (args_info.sele1_given) {
+    sele1 = args_info.sele1_arg;
+  } else {
+    char*  sele1Env= getenv("SELECTION1");
+    if (sele1Env) {
+      sele1 = sele1Env;
+    } else {
+      sele1 = "select all";
+    }
+  }
+
+  // check the second selection argument, or set it to the environment
+  // variable, or failing that, set it to the first selection
+
+  if (args_info.sele2_given) {
+    sele2 = args_info.sele2_arg;
+  } else {
+    char* sele2Env = getenv("SELECTION2");
+    if (sele2Env) {
+      sele2 = sele2Env;
+    } else {
+      //If sele2 is not specified, then the default behavior
+      //should be what is already intended for sele1
+      sele2 = sele1;
+    }
+  }
+
+  // check the third selection argument, which is only set if
+  // requested by the user
+
+  if (args_info.sele3_given) sele3 = args_info.sele3_arg;
+
+  bool batchMode(false);
+  if (args_info.scd_given){
+    if (args_info.sele1_given &&
+        args_info.sele2_given && args_info.sele3_given) {
+      batchMode = false;
+    } else if (args_info.molname_given &&
+               args_info.begin_given && args_info.end_given) {
+      if (args_info.begin_arg < 0 ||
+          args_info.end_arg < 0 || args_info.begin_arg > args_info.end_arg-2) {
+        sprintf( painCave.errMsg,
+                 "below conditions are not satisfied:\n"
+                 "0 <= begin && 0<= end && begin <= end-2\n");
+        painCave.severity = OPENMD_ERROR;
+        painCave.isFatal = 1;
+        simError();
+      }
+      batchMode = true;
+    } else{
+      sprintf( painCave.errMsg,
+               "either --sele1, --sele2, --sele3 are specified,"
+               " or --molname, --begin, --end are specified\n");
+      painCave.severity = OPENMD_ERROR;
+      painCave.isFatal = 1;
+      simError();
+    }
+  }
+
+  //parse md file and set up the system
+  SimCreator creator;
+  SimInfo* info = creator.createSim(dumpFileName);
+
+  StaticAnalyser* analyser = createAnalyser(info, args_info, dumpFileName,
+                                            sele1, sele2, sele3, batchMode);
 
   if (args_info.output_given) {
     analyser->setOutputName(args_info.output_arg);
@@ -755,7 +768,43 @@ RealType vRadius;
     analyser->setStep(args_info.step_arg);
   }
 
-  analyser->process();
+  int nThreads = args_info.threads_arg;
+
+  if (nThreads > 1 && !analyser->isFrameParallel()) {
+    sprintf( painCave.errMsg,
+             "This analysis does not support processing frames in "
+             "parallel;\n\tthe trajectory will be read on a single thread.\n");
+    painCave.severity = OPENMD_INFO;
+    painCave.isFatal = 0;
+    simError();
+    nThreads = 1;
+  }
+
+  if (nThreads > 1) {
+    // Every worker gets its own copy of the system and an identically
+    // configured analyser:
+    std::vector<SimInfo*> workerInfos;
+    std::vector<StaticAnalyser*> workers;
+    for (int i = 1; i < nThreads; i++) {
+      SimCreator workerCreator;
+      SimInfo* workerInfo = workerCreator.createSim(dumpFileName);
+      StaticAnalyser* worker = createAnalyser(workerInfo, args_info,
+                                              dumpFileName, sele1, sele2,
+                                              sele3, batchMode);
+      worker->setStep(analyser->getStep());
+      workerInfos.push_back(workerInfo);
+      workers.push_back(worker);
+    }
+
+    analyser->processFrames(workers);
+
+    for (unsigned int i = 0; i < workers.size(); i++) {
+      delete workers[i];
+      delete workerInfos[i];
+    }
+  } else {
+    analyser->process();
+  }
 
   delete analyser;
   delete info;
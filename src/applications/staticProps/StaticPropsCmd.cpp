@@ -38,6 +38,7 @@ const char *gengetopt_args_info_help[] = {
   "  -i, --input=filename          input dump file (mandatory)",
   "  -o, --output=filename         output file name",
   "  -n, --step=INT                process every n frame  (default=`1')",
+  "      --threads=INT             number of threads used to process frames in\n                                  parallel  (default=`1')",
   "  -b, --nbins=INT               number of bins (general purpose)\n                                  (default=`100')",
   "  -x, --nbins_x=INT             number of bins in x axis  (default=`100')",
   "  -y, --nbins_y=INT             number of bins in y axis  (default=`100')",
@@ -171,6 +172,7 @@ void clear_given (struct gengetopt_args_info *args_info)
   args_info->input_given = 0 ;
   args_info->output_given = 0 ;
   args_info->step_given = 0 ;
+  args_info->threads_given = 0 ;
   args_info->nbins_given = 0 ;
   args_info->nbins_x_given = 0 ;
   args_info->nbins_y_given = 0 ;
@@ -277,6 +279,8 @@ void clear_args (struct gengetopt_args_info *args_info)
   args_info->output_orig = NULL;
   args_info->step_arg = 1;
   args_info->step_orig = NULL;
+  args_info->threads_arg = 1;
+  args_info->threads_orig = NULL;
   args_info->nbins_arg = 100;
   args_info->nbins_orig = NULL;
   args_info->nbins_x_arg = 100;
@@ -348,99 +352,100 @@ void init_args_info(struct gengetopt_args_info *args_info)
   args_info->input_help = gengetopt_args_info_help[2] ;
   args_info->output_help = gengetopt_args_info_help[3] ;
   args_info->step_help = gengetopt_args_info_help[4] ;
-  args_info->nbins_help = gengetopt_args_info_help[5] ;
-  args_info->nbins_x_help = gengetopt_args_info_help[6] ;
-  args_info->nbins_y_help = gengetopt_args_info_help[7] ;
-  args_info->nbins_z_help = gengetopt_args_info_help[8] ;
-  args_info->nrbins_help = gengetopt_args_info_help[9] ;
-  args_info->nanglebins_help = gengetopt_args_info_help[10] ;
-  args_info->rcut_help = gengetopt_args_info_help[11] ;
-  args_info->OOcut_help = gengetopt_args_info_help[12] ;
-  args_info->thetacut_help = gengetopt_args_info_help[13] ;
-  args_info->OHcut_help = gengetopt_args_info_help[14] ;
-  args_info->dz_help = gengetopt_args_info_help[15] ;
-  args_info->length_help = gengetopt_args_info_help[16] ;
-  args_info->zlength_help = gengetopt_args_info_help[17] ;
-  args_info->zoffset_help = gengetopt_args_info_help[18] ;
-  args_info->sele1_help = gengetopt_args_info_help[19] ;
-  args_info->sele2_help = gengetopt_args_info_help[20] ;
-  args_info->sele3_help = gengetopt_args_info_help[21] ;
-  args_info->refsele_help = gengetopt_args_info_help[22] ;
-  args_info->comsele_help = gengetopt_args_info_help[23] ;
-  args_info->seleoffset_help = gengetopt_args_info_help[24] ;
-  args_info->seleoffset2_help = gengetopt_args_info_help[25] ;
-  args_info->molname_help = gengetopt_args_info_help[26] ;
-  args_info->begin_help = gengetopt_args_info_help[27] ;
-  args_info->end_help = gengetopt_args_info_help[28] ;
-  args_info->radius_help = gengetopt_args_info_help[29] ;
-  args_info->voxelSize_help = gengetopt_args_info_help[30] ;
-  args_info->gaussWidth_help = gengetopt_args_info_help[31] ;
-  args_info->privilegedAxis_help = gengetopt_args_info_help[32] ;
-  args_info->privilegedAxis2_help = gengetopt_args_info_help[33] ;
-  args_info->momentum_help = gengetopt_args_info_help[34] ;
-  args_info->component_help = gengetopt_args_info_help[35] ;
-  args_info->dipoleX_help = gengetopt_args_info_help[36] ;
-  args_info->dipoleY_help = gengetopt_args_info_help[37] ;
-  args_info->dipoleZ_help = gengetopt_args_info_help[38] ;
-  args_info->v_radius_help = gengetopt_args_info_help[39] ;
-  args_info->gen_xyz_help = gengetopt_args_info_help[40] ;
-  args_info->atom_name_help = gengetopt_args_info_help[41] ;
-  args_info->bo_help = gengetopt_args_info_help[43] ;
-  args_info->ior_help = gengetopt_args_info_help[44] ;
-  args_info->for_help = gengetopt_args_info_help[45] ;
-  args_info->bad_help = gengetopt_args_info_help[46] ;
-  args_info->count_help = gengetopt_args_info_help[47] ;
-  args_info->gofr_help = gengetopt_args_info_help[48] ;
-  args_info->gofz_help = gengetopt_args_info_help[49] ;
-  args_info->r_theta_help = gengetopt_args_info_help[50] ;
-  args_info->r_omega_help = gengetopt_args_info_help[51] ;
-  args_info->r_z_help = gengetopt_args_info_help[52] ;
-  args_info->theta_omega_help = gengetopt_args_info_help[53] ;
-  args_info->r_theta_omega_help = gengetopt_args_info_help[54] ;
-  args_info->gxyz_help = gengetopt_args_info_help[55] ;
-  args_info->twodgofr_help = gengetopt_args_info_help[56] ;
-  args_info->p2_help = gengetopt_args_info_help[57] ;
-  args_info->rp2_help = gengetopt_args_info_help[58] ;
-  args_info->scd_help = gengetopt_args_info_help[59] ;
-  args_info->density_help = gengetopt_args_info_help[60] ;
-  args_info->slab_density_help = gengetopt_args_info_help[61] ;
-  args_info->pipe_density_help = gengetopt_args_info_help[62] ;
-  args_info->p_angle_help = gengetopt_args_info_help[63] ;
-  args_info->hxy_help = gengetopt_args_info_help[64] ;
-  args_info->rho_r_help = gengetopt_args_info_help[65] ;
-  args_info->angle_r_help = gengetopt_args_info_help[66] ;
-  args_info->hullvol_help = gengetopt_args_info_help[67] ;
-  args_info->rodlength_help = gengetopt_args_info_help[68] ;
-  args_info->tet_param_help = gengetopt_args_info_help[69] ;
-  args_info->tet_param_z_help = gengetopt_args_info_help[70] ;
-  args_info->tet_param_dens_help = gengetopt_args_info_help[71] ;
-  args_info->tet_param_xyz_help = gengetopt_args_info_help[72] ;
-  args_info->rnemdz_help = gengetopt_args_info_help[73] ;
-  args_info->rnemdr_help = gengetopt_args_info_help[74] ;
-  args_info->rnemdrt_help = gengetopt_args_info_help[75] ;
-  args_info->nitrile_help = gengetopt_args_info_help[76] ;
-  args_info->multipole_help = gengetopt_args_info_help[77] ;
-  args_info->surfDiffusion_help = gengetopt_args_info_help[78] ;
-  args_info->cn_help = gengetopt_args_info_help[79] ;
-  args_info->scn_help = gengetopt_args_info_help[80] ;
-  args_info->gcn_help = gengetopt_args_info_help[81] ;
-  args_info->hbond_help = gengetopt_args_info_help[82] ;
-  args_info->potDiff_help = gengetopt_args_info_help[83] ;
-  args_info->tet_hb_help = gengetopt_args_info_help[84] ;
-  args_info->kirkwood_help = gengetopt_args_info_help[85] ;
-  args_info->kirkwoodQ_help = gengetopt_args_info_help[86] ;
-  args_info->densityfield_help = gengetopt_args_info_help[87] ;
-  args_info->velocityfield_help = gengetopt_args_info_help[88] ;
-  args_info->velocityZ_help = gengetopt_args_info_help[89] ;
-  args_info->eam_density_help = gengetopt_args_info_help[90] ;
-  args_info->net_charge_help = gengetopt_args_info_help[91] ;
-  args_info->current_density_help = gengetopt_args_info_help[92] ;
-  args_info->chargez_help = gengetopt_args_info_help[93] ;
-  args_info->charge_density_z_help = gengetopt_args_info_help[94] ;
-  args_info->countz_help = gengetopt_args_info_help[95] ;
-  args_info->momentum_distribution_help = gengetopt_args_info_help[96] ;
-  args_info->dipole_orientation_help = gengetopt_args_info_help[97] ;
-  args_info->order_prob_help = gengetopt_args_info_help[98] ;
+  args_info->threads_help = gengetopt_args_info_help[5] ;
+  args_info->nbins_help = gengetopt_args_info_help[6] ;
+  args_info->nbins_x_help = gengetopt_args_info_help[7] ;
+  args_info->nbins_y_help = gengetopt_args_info_help[8] ;
+  args_info->nbins_z_help = gengetopt_args_info_help[9] ;
+  args_info->nrbins_help = gengetopt_args_info_help[10] ;
+  args_info->nanglebins_help = gengetopt_args_info_help[11] ;
+  args_info->rcut_help = gengetopt_args_info_help[12] ;
+  args_info->OOcut_help = gengetopt_args_info_help[13] ;
+  args_info->thetacut_help = gengetopt_args_info_help[14] ;
+  args_info->OHcut_help = gengetopt_args_info_help[15] ;
+  args_info->dz_help = gengetopt_args_info_help[16] ;
+  args_info->length_help = gengetopt_args_info_help[17] ;
+  args_info->zlength_help = gengetopt_args_info_help[18] ;
+  args_info->zoffset_help = gengetopt_args_info_help[19] ;
+  args_info->sele1_help = gengetopt_args_info_help[20] ;
+  args_info->sele2_help = gengetopt_args_info_help[21] ;
+  args_info->sele3_help = gengetopt_args_info_help[22] ;
+  args_info->refsele_help = gengetopt_args_info_help[23] ;
+  args_info->comsele_help = gengetopt_args_info_help[24] ;
+  args_info->seleoffset_help = gengetopt_args_info_help[25] ;
+  args_info->seleoffset2_help = gengetopt_args_info_help[26] ;
+  args_info->molname_help = gengetopt_args_info_help[27] ;
+  args_info->begin_help = gengetopt_args_info_help[28] ;
+  args_info->end_help = gengetopt_args_info_help[29] ;
+  args_info->radius_help = gengetopt_args_info_help[30] ;
+  args_info->voxelSize_help = gengetopt_args_info_help[31] ;
+  args_info->gaussWidth_help = gengetopt_args_info_help[32] ;
+  args_info->privilegedAxis_help = gengetopt_args_info_help[33] ;
+  args_info->privilegedAxis2_help = gengetopt_args_info_help[34] ;
+  args_info->momentum_help = gengetopt_args_info_help[35] ;
+  args_info->component_help = gengetopt_args_info_help[36] ;
+  args_info->dipoleX_help = gengetopt_args_info_help[37] ;
+  args_info->dipoleY_help = gengetopt_args_info_help[38] ;
+  args_info->dipoleZ_help = gengetopt_args_info_help[39] ;
+  args_info->v_radius_help = gengetopt_args_info_help[40] ;
+  args_info->gen_xyz_help = gengetopt_args_info_help[41] ;
+  args_info->atom_name_help = gengetopt_args_info_help[42] ;
+  args_info->bo_help = gengetopt_args_info_help[44] ;
+  args_info->ior_help = gengetopt_args_info_help[45] ;
+  args_info->for_help = gengetopt_args_info_help[46] ;
+  args_info->bad_help = gengetopt_args_info_help[47] ;
+  args_info->count_help = gengetopt_args_info_help[48] ;
+  args_info->gofr_help = gengetopt_args_info_help[49] ;
+  args_info->gofz_help = gengetopt_args_info_help[50] ;
+  args_info->r_theta_help = gengetopt_args_info_help[51] ;
+  args_info->r_omega_help = gengetopt_args_info_help[52] ;
+  args_info->r_z_help = gengetopt_args_info_help[53] ;
+  args_info->theta_omega_help = gengetopt_args_info_help[54] ;
+  args_info->r_theta_omega_help = gengetopt_args_info_help[55] ;
+  args_info->gxyz_help = gengetopt_args_info_help[56] ;
+  args_info->twodgofr_help = gengetopt_args_info_help[57] ;
+  args_info->p2_help = gengetopt_args_info_help[58] ;
+  args_info->rp2_help = gengetopt_args_info_help[59] ;
+  args_info->scd_help = gengetopt_args_info_help[60] ;
+  args_info->density_help = gengetopt_args_info_help[61] ;
+  args_info->slab_density_help = gengetopt_args_info_help[62] ;
+  args_info->pipe_density_help = gengetopt_args_info_help[63] ;
+  args_info->p_angle_help = gengetopt_args_info_help[64] ;
+  args_info->hxy_help = gengetopt_args_info_help[65] ;
+  args_info->rho_r_help = gengetopt_args_info_help[66] ;
+  args_info->angle_r_help = gengetopt_args_info_help[67] ;
+  args_info->hullvol_help = gengetopt_args_info_help[68] ;
+  args_info->rodlength_help = gengetopt_args_info_help[69] ;
+  args_info->tet_param_help = gengetopt_args_info_help[70] ;
+  args_info->tet_param_z_help = gengetopt_args_info_help[71] ;
+  args_info->tet_param_dens_help = gengetopt_args_info_help[72] ;
+  args_info->tet_param_xyz_help = gengetopt_args_info_help[73] ;
+  args_info->rnemdz_help = gengetopt_args_info_help[74] ;
+  args_info->rnemdr_help = gengetopt_args_info_help[75] ;
+  args_info->rnemdrt_help = gengetopt_args_info_help[76] ;
+  args_info->nitrile_help = gengetopt_args_info_help[77] ;
+  args_info->multipole_help = gengetopt_args_info_help[78] ;
+  args_info->surfDiffusion_help = gengetopt_args_info_help[79] ;
+  args_info->cn_help = gengetopt_args_info_help[80] ;
+  args_info->scn_help = gengetopt_args_info_help[81] ;
+  args_info->gcn_help = gengetopt_args_info_help[82] ;
+  args_info->hbond_help = gengetopt_args_info_help[83] ;
+  args_info->potDiff_help = gengetopt_args_info_help[84] ;
+  args_info->tet_hb_help = gengetopt_args_info_help[85] ;
+  args_info->kirkwood_help = gengetopt_args_info_help[86] ;
+  args_info->kirkwoodQ_help = gengetopt_args_info_help[87] ;
+  args_info->densityfield_help = gengetopt_args_info_help[88] ;
+  args_info->velocityfield_help = gengetopt_args_info_help[89] ;
+  args_info->velocityZ_help = gengetopt_args_info_help[90] ;
+  args_info->eam_density_help = gengetopt_args_info_help[91] ;
+  args_info->net_charge_help = gengetopt_args_info_help[92] ;
+  args_info->current_density_help = gengetopt_args_info_help[93] ;
+  args_info->chargez_help = gengetopt_args_info_help[94] ;
+  args_info->charge_density_z_help = gengetopt_args_info_help[95] ;
+  args_info->countz_help = gengetopt_args_info_help[96] ;
+  args_info->momentum_distribution_help = gengetopt_args_info_help[97] ;
+  args_info->dipole_orientation_help = gengetopt_args_info_help[98] ;
+  args_info->order_prob_help = gengetopt_args_info_help[99] ;
   
 }
 
@@ -538,6 +543,7 @@ cmdline_parser_release (struct gengetopt_args_info *args_info)
   free_string_field (&(args_info->output_arg));
   free_string_field (&(args_info->output_orig));
   free_string_field (&(args_info->step_orig));
+  free_string_field (&(args_info->threads_orig));
   free_string_field (&(args_info->nbins_orig));
   free_string_field (&(args_info->nbins_x_orig));
   free_string_field (&(args_info->nbins_y_orig));
@@ -667,6 +673,8 @@ cmdline_parser_dump(FILE *outfile, struct gengetopt_args_info *args_info)
     write_into_file(outfile, "output", args_info->output_orig, 0);
   if (args_info->step_given)
     write_into_file(outfile, "step", args_info->step_orig, 0);
+  if (args_info->threads_given)
+    write_into_file(outfile, "threads", args_info->threads_orig, 0);
   if (args_info->nbins_given)
     write_into_file(outfile, "nbins", args_info->nbins_orig, 0);
   if (args_info->nbins_x_given)
@@ -1815,6 +1823,7 @@ cmdline_parser_internal (
         { "input",	1, NULL, 'i' },
         { "output",	1, NULL, 'o' },
         { "step",	1, NULL, 'n' },
+        { "threads",	1, NULL, 0 },
         { "nbins",	1, NULL, 'b' },
         { "nbins_x",	1, NULL, 'x' },
         { "nbins_y",	1, NULL, 'y' },
@@ -2251,8 +2260,22 @@ cmdline_parser_internal (
           break;
 
         case 0:	/* Long option with no short option */
+          /* number of threads used to process frames in parallel.  */
+          if (strcmp (long_options[option_index].name, "threads") == 0)
+          {
+          
+          
+            if (update_arg( (void *)&(args_info->threads_arg), 
+                 &(args_info->threads_orig), &(args_info->threads_given),
+                &(local_args_info.threads_given), optarg, 0, "1", ARG_INT,
+                check_ambiguity, override, 0, 0,
+                "threads", '-',
+                additional_error))
+              goto failure;
+          
+          }
           /* number of bins in z axis.  */
-          if (strcmp (long_options[option_index].name, "nbins_z") == 0)
+          else if (strcmp (long_options[option_index].name, "nbins_z") == 0)
           {
           
           
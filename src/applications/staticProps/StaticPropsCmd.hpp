@@ -53,6 +53,9 @@ struct gengetopt_args_info
   int step_arg;	/**< @brief process every n frame (default='1').  */
   char * step_orig;	/**< @brief process every n frame original value given at command line.  */
   const char *step_help; /**< @brief process every n frame help description.  */
+  int threads_arg;	/**< @brief number of threads used to process frames in parallel (default='1').  */
+  char * threads_orig;	/**< @brief number of threads used to process frames in parallel original value given at command line.  */
+  const char *threads_help; /**< @brief number of threads used to process frames in parallel help description.  */
   int nbins_arg;	/**< @brief number of bins (general purpose) (default='100').  */
   char * nbins_orig;	/**< @brief number of bins (general purpose) original value given at command line.  */
   const char *nbins_help; /**< @brief number of bins (general purpose) help description.  */
@@ -225,6 +228,7 @@ struct gengetopt_args_info
   unsigned int input_given ;	/**< @brief Whether input was given.  */
   unsigned int output_given ;	/**< @brief Whether output was given.  */
   unsigned int step_given ;	/**< @brief Whether step was given.  */
+  unsigned int threads_given ;	/**< @brief Whether threads was given.  */
   unsigned int nbins_given ;	/**< @brief Whether nbins was given.  */
   unsigned int nbins_x_given ;	/**< @brief Whether nbins_x was given.  */
   unsigned int nbins_y_given ;	/**< @brief Whether nbins_y was given.  */
@@ -93,6 +93,12 @@ namespace OpenMD {
 
   }
 
+  void TwoDGofR::mergeHistogram(RadialDistrFunc* worker) {
+    TwoDGofR* w = static_cast<TwoDGofR*>(worker);
+    for (unsigned int i = 0; i < avgTwoDGofR_.size(); ++i)
+      avgTwoDGofR_[i] += w->avgTwoDGofR_[i];
+  }
+
   void TwoDGofR::collectHistogram(StuntDouble* sd1, StuntDouble* sd2) {
 
     if (sd1 == sd2) {
@@ -384,6 +384,87 @@ namespace OpenMD {
     }
   }
 
+  void DataStorage::copyFrom(DataStorage& source, int layout) {
+    if (source.size_ != size_ || source.storageLayout_ != storageLayout_) {
+      *this = source;
+      return;
+    }
+
+    layout &= storageLayout_;
+
+    if (layout & dslPosition) {
+      position = source.position;
+    }
+
+    if (layout & dslVelocity) {
+      velocity = source.velocity;
+    }
+
+    if (layout & dslForce) {
+      force = source.force;
+    }
+
+    if (layout & dslAmat) {
+      aMat = source.aMat;
+    }
+
+    if (layout & dslAngularMomentum) {
+      angularMomentum = source.angularMomentum;
+    }
+
+    if (layout & dslTorque) {
+      torque = source.torque;
+    }
+
+    if (layout & dslParticlePot) {
+      particlePot = source.particlePot;
+    }
+
+    if (layout & dslDensity) {
+      density = source.density;
+    }
+
+    if (layout & dslFunctional) {
+      functional = source.functional;
+    }
+
+    if (layout & dslFunctionalDerivative) {
+      functionalDerivative = source.functionalDerivative;
+    }
+
+    if (layout & dslDipole) {
+      dipole = source.dipole;
+    }
+
+    if (layout & dslQuadrupole) {
+      quadrupole = source.quadrupole;
+    }
+
+    if (layout & dslElectricField) {
+      electricField = source.electricField;
+    }
+
+    if (layout & dslSkippedCharge) {
+      skippedCharge = source.skippedCharge;
+    }
+
+    if (layout & dslFlucQPosition) {
+      flucQPos = source.flucQPos;
+    }
+
+    if (layout & dslFlucQVelocity) {
+      flucQVel = source.flucQVel;
+    }
+
+    if (layout & dslFlucQForce) {
+      flucQFrc = source.flucQFrc;
+    }
+
+    if (layout & dslSitePotential) {
+      sitePotential = source.sitePotential;
+    }
+  }
+
   int DataStorage::getStorageLayout() {
     return storageLayout_;
   }
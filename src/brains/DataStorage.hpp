@@ -117,6 +117,12 @@ namespace OpenMD {
      * @param target
      */
     void copy(int source, std::size_t num, std::size_t target);
+    /**
+     * Copies the arrays selected by layout from another DataStorage.
+     * If the two don't have the same size and storage layout, the
+     * whole DataStorage is copied instead.
+     */
+    void copyFrom(DataStorage& source, int layout);
     /** Returns the storage layout  */
     int getStorageLayout();
     /** Sets the storage layout  */
@@ -65,12 +65,18 @@
 #include <cstdio>
 #include <iostream>
 #include <iomanip>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 namespace OpenMD {
 
   ForceManager::ForceManager(SimInfo * info) : initialized_(false), info_(info),
                                                switcher_(NULL),
+                                               pairListStale_(true),
+                                               nThreads_(1),
+                                               pairLoopPrimed_(false),
                                                seleMan_(info),
                                                evaluator_(info) {
     forceField_ = info_->getForceField();
@@ -102,7 +108,7 @@ namespace OpenMD {
    *      Use the maximum suggested value that was found.
    *
    * cutoffMethod : (one of HARD, SWITCHED, SHIFTED_FORCE, TAYLOR_SHIFTED,
-   *                        SHIFTED_POTENTIAL, or EWALD_FULL)
+   *                        SHIFTED_POTENTIAL, EWALD_FULL, or EWALD_SPME)
    *      If cutoffMethod was explicitly set, use that choice.
    *      If cutoffMethod was not explicitly set, use SHIFTED_FORCE
    *
@@ -172,6 +178,7 @@ namespace OpenMD {
     stringToCutoffMethod["SHIFTED_FORCE"] = SHIFTED_FORCE;
     stringToCutoffMethod["TAYLOR_SHIFTED"] = TAYLOR_SHIFTED;
     stringToCutoffMethod["EWALD_FULL"] = EWALD_FULL;
+    stringToCutoffMethod["EWALD_SPME"] = EWALD_SPME;
 
     if (simParams_->haveCutoffMethod()) {
       string cutMeth = toUpperCopy(simParams_->getCutoffMethod());
@@ -182,7 +189,7 @@ namespace OpenMD {
                 "ForceManager::setupCutoffs: Could not find chosen cutoffMethod %s\n"
                 "\tShould be one of: "
                 "HARD, SWITCHED, SHIFTED_POTENTIAL, TAYLOR_SHIFTED,\n"
-                "\tSHIFTED_FORCE, or EWALD_FULL\n",
+                "\tSHIFTED_FORCE, EWALD_FULL, or EWALD_SPME\n",
                 cutMeth.c_str());
         painCave.isFatal = 1;
         painCave.severity = OPENMD_ERROR;
@@ -453,6 +460,34 @@ namespace OpenMD {
 
     fDecomp_->distributeInitialData();
 
+    nThreads_ = 1;
+#ifdef _OPENMP
+    nThreads_ = omp_get_max_threads();
+    if (info_->getSimParams()->getUseDeterministicForces()) {
+      // A static schedule divides the pair loop identically on every
+      // step, and the per-thread contributions are reduced in thread
+      // order, so the forces are bit-for-bit reproducible for a fixed
+      // number of threads.
+      omp_set_schedule(omp_sched_static, 0);
+    } else {
+      omp_set_schedule(omp_sched_guided, 0);
+    }
+#endif
+    fDecomp_->setNumThreads(nThreads_);
+    threadVirial_.resize(nThreads_);
+    threadHeatFlux_.resize(nThreads_);
+
+    if (nThreads_ > 1) {
+      sprintf( painCave.errMsg,
+               "ForceManager::initialize : Using %d threads for the\n"
+               "\tnon-bonded pair loop%s.\n", nThreads_,
+               info_->getSimParams()->getUseDeterministicForces() ?
+               " (deterministic ordering)" : "");
+      painCave.isFatal = 0;
+      painCave.severity = OPENMD_INFO;
+      simError();
+    }
+
     doPotentialSelection_ = false;
     if (info_->getSimParams()->havePotentialSelection()) {
       doPotentialSelection_ = true;
@@ -749,65 +784,26 @@ namespace OpenMD {
     fDecomp_->zeroWorkArrays();
     fDecomp_->distributeData();
 
-    int cg1, cg2, atom1, atom2, topoDist;
-    Vector3d d_grp, dag, d, gvel2, vel2;
-    RealType rgrpsq, rgrp, r2, r;
-    RealType electroMult, vdwMult;
-    RealType vij(0.0);
-    Vector3d fij, fg, f1;
-    bool in_switching_region;
-    RealType sw, dswdr, swderiv;
-    vector<int> atomListColumn, atomListRow;
-    InteractionData idat;
     SelfData sdat;
-    RealType mf;
-    RealType vpair;
-    RealType dVdFQ1(0.0);
-    RealType dVdFQ2(0.0);
     potVec longRangePotential(0.0);
     potVec selfPotential(0.0);
     RealType reciprocalPotential(0.0);
     RealType surfacePotential(0.0);
-    potVec workPot(0.0);
-    potVec exPot(0.0);
     potVec selectionPotential(0.0);
-    Vector3d eField1(0.0);
-    Vector3d eField2(0.0);
-    RealType sPot1(0.0);
-    RealType sPot2(0.0);
-    bool newAtom1;
-    int gid1, gid2;
-
-    vector<int>::iterator ia, jb;
+    int gid1;
 
     int loopStart, loopEnd;
 
-    idat.rcut = &rCut_;
-    idat.vdwMult = &vdwMult;
-    idat.electroMult = &electroMult;
-    idat.pot = &workPot;
-    idat.excludedPot = &exPot;
-    idat.selePot = &selectionPotential;
     sdat.selfPot = fDecomp_->getSelfPotential();
     sdat.excludedPot = fDecomp_->getExcludedSelfPotential();
     sdat.selePot = fDecomp_->getSelectedSelfPotential();
-    idat.vpair = &vpair;
-    idat.dVdFQ1 = &dVdFQ1;
-    idat.dVdFQ2 = &dVdFQ2;
-    idat.eField1 = &eField1;
-    idat.eField2 = &eField2;
-    idat.sPot1 = &sPot1;
-    idat.sPot2 = &sPot2;
-    idat.f1 = &f1;
-    idat.sw = &sw;
-    idat.shiftedPot = (cutoffMethod_ == SHIFTED_POTENTIAL) ? true : false;
-    idat.shiftedForce = (cutoffMethod_ == SHIFTED_FORCE ||
-                         cutoffMethod_ == TAYLOR_SHIFTED) ? true : false;
-    idat.doParticlePot = doParticlePot_;
-    idat.doElectricField = doElectricField_;
-    idat.doSitePotential = doSitePotential_;
     sdat.doParticlePot = doParticlePot_;
 
+    // The first evaluation is done on a single thread so that the
+    // lazily-built parts of the non-bonded modules (mixing maps and
+    // splines) are only constructed once.
+    int nThreads = pairLoopPrimed_ ? nThreads_ : 1;
+
     loopEnd = PAIR_LOOP;
     if (info_->requiresPrepair() ) {
       loopStart = PREPAIR_LOOP;
@@ -823,174 +819,33 @@ namespace OpenMD {
           if (!usePeriodicBoundaryConditions_)
             Mat3x3d bbox = thermo->getBoundingBox();
           fDecomp_->buildNeighborList(neighborList_, point_);
+          pairListStale_ = true;
         }
+        if (pairListStale_) buildAtomPairList();
       }
 
-      for (cg1 = 0; cg1 < int(point_.size()) - 1; cg1++) {
-
-        atomListRow = fDecomp_->getAtomsInGroupRow(cg1);
-        newAtom1 = true;
-
-        for (int m2 = point_[cg1]; m2 < point_[cg1+1]; m2++) {
-
-          cg2 = neighborList_[m2];
-
-          d_grp  = fDecomp_->getIntergroupVector(cg1, cg2);
-
-          // already wrapped in the getIntergroupVector call:
-          // curSnapshot->wrapVector(d_grp);
-          rgrpsq = d_grp.lengthSquare();
-
-          if (rgrpsq < rCutSq_) {
-            if (iLoop == PAIR_LOOP) {
-              vij = 0.0;
-              fij.zero();
-              eField1.zero();
-              eField2.zero();
-              sPot1 = 0.0;
-              sPot2 = 0.0;
-            }
-
-            in_switching_region = switcher_->getSwitch(rgrpsq, sw, dswdr,
-                                                       rgrp);
-
-            atomListColumn = fDecomp_->getAtomsInGroupColumn(cg2);
-
-            if (doHeatFlux_)
-              gvel2 = fDecomp_->getGroupVelocityColumn(cg2);
-
-            for (ia = atomListRow.begin();
-                 ia != atomListRow.end(); ++ia) {
-              atom1 = (*ia);
-
-              if (doPotentialSelection_) {
-                gid1 = fDecomp_->getGlobalIDRow(atom1);
-                idat.isSelected = seleMan_.isGlobalIDSelected(gid1);
-              }
-
-              for (jb = atomListColumn.begin();
-                   jb != atomListColumn.end(); ++jb) {
-                atom2 = (*jb);
-
-                if (doPotentialSelection_) {
-                  gid2 = fDecomp_->getGlobalIDCol(atom2);
-                  idat.isSelected |= seleMan_.isGlobalIDSelected(gid2);
-                }
-
-                if (!fDecomp_->skipAtomPair(atom1, atom2, cg1, cg2)) {
-
-                  vpair = 0.0;
-                  workPot = 0.0;
-                  exPot = 0.0;
-                  selectionPotential = 0.0;
-                  f1.zero();
-                  dVdFQ1 = 0.0;
-                  dVdFQ2 = 0.0;
-
-                  fDecomp_->fillInteractionData(idat, atom1, atom2, newAtom1);
-
-                  topoDist = fDecomp_->getTopologicalDistance(atom1, atom2);
-                  vdwMult = vdwScale_[topoDist];
-                  electroMult = electrostaticScale_[topoDist];
-
-                  if (atomListRow.size() == 1 && atomListColumn.size() == 1) {
-                    idat.d = &d_grp;
-                    idat.r2 = &rgrpsq;
-                    if (doHeatFlux_)
-                      vel2 = gvel2;
-                  } else {
-                    d = fDecomp_->getInteratomicVector(atom1, atom2);
-                    curSnapshot->wrapVector( d );
-                    r2 = d.lengthSquare();
-                    idat.d = &d;
-                    idat.r2 = &r2;
-                    if (doHeatFlux_)
-                      vel2 = fDecomp_->getAtomVelocityColumn(atom2);
-                  }
-
-                  r = sqrt( *(idat.r2) );
-                  idat.rij = &r;
-
-                  if (iLoop == PREPAIR_LOOP) {
-                    interactionMan_->doPrePair(idat);
-                  } else {
-                    interactionMan_->doPair(idat);
-                    fDecomp_->unpackInteractionData(idat, atom1, atom2);
-                    vij += vpair;
-                    fij += f1;
-                    virialTensor -= outProduct( *(idat.d), f1);
-                    if (doHeatFlux_)
-                      fDecomp_->addToHeatFlux(*(idat.d) * dot(f1, vel2));
-                  }
-                }
-              }
-            }
-
-            if (iLoop == PAIR_LOOP) {
-              if (in_switching_region) {
-                swderiv = vij * dswdr / rgrp;
-                fg = swderiv * d_grp;
-                fij += fg;
-
-                if (atomListRow.size() == 1 && atomListColumn.size() == 1) {
-                  if (!fDecomp_->skipAtomPair(atomListRow[0],
-                                              atomListColumn[0],
-                                              cg1, cg2)) {
-                    virialTensor -= outProduct( *(idat.d), fg);
-                    if (doHeatFlux_)
-                      fDecomp_->addToHeatFlux(*(idat.d) * dot(fg, vel2));
-                  }
-                }
+      for (int t = 1; t < nThreads; t++) {
+        threadVirial_[t] *= 0.0;
+        threadHeatFlux_[t] = V3Zero;
+      }
 
-                for (ia = atomListRow.begin();
-                     ia != atomListRow.end(); ++ia) {
-                  atom1 = (*ia);
-                  mf = fDecomp_->getMassFactorRow(atom1);
-                  // fg is the force on atom ia due to cutoff group's
-                  // presence in switching region
-                  fg = swderiv * d_grp * mf;
-                  fDecomp_->addForceToAtomRow(atom1, fg);
-                  if (atomListRow.size() > 1) {
-                    if (info_->usesAtomicVirial()) {
-                      // find the distance between the atom
-                      // and the center of the cutoff group:
-                      dag = fDecomp_->getAtomToGroupVectorRow(atom1, cg1);
-                      virialTensor -= outProduct(dag, fg);
-                      if (doHeatFlux_)
-                        fDecomp_->addToHeatFlux( dag * dot(fg, vel2));
-                    }
-                  }
-                }
-                for (jb = atomListColumn.begin();
-                     jb != atomListColumn.end(); ++jb) {
-                  atom2 = (*jb);
-                  mf = fDecomp_->getMassFactorColumn(atom2);
-                  // fg is the force on atom jb due to cutoff group's
-                  // presence in switching region
-                  fg = -swderiv * d_grp * mf;
-                  fDecomp_->addForceToAtomColumn(atom2, fg);
+#pragma omp parallel num_threads(nThreads) if (nThreads > 1)
+      {
+        int tid = 0;
+#ifdef _OPENMP
+        tid = omp_get_thread_num();
+#endif
+        longRangePairLoop(iLoop, tid);
+      }
 
-                  if (atomListColumn.size() > 1) {
-                    if (info_->usesAtomicVirial()) {
-                      // find the distance between the atom
-                      // and the center of the cutoff group:
-                      dag = fDecomp_->getAtomToGroupVectorColumn(atom2, cg2);
-                      virialTensor -= outProduct(dag, fg);
-                      if (doHeatFlux_)
-                        fDecomp_->addToHeatFlux( dag * dot(fg, vel2));
-                    }
-                  }
-                }
-              }
-              //if (!info_->usesAtomicVirial()) {
-              //  virialTensor -= outProduct(d_grp, fij);
-              //  if (doHeatFlux_)
-              //     fDecomp_->addToHeatFlux( d_grp * dot(fij, vel2));
-              //}
-            }
-          }
+      if (nThreads > 1) {
+        // private contributions are added in thread order:
+        fDecomp_->reduceThreadData();
+        for (int t = 1; t < nThreads; t++) {
+          virialTensor += threadVirial_[t];
+          if (doHeatFlux_)
+            fDecomp_->addToHeatFlux(threadHeatFlux_[t]);
         }
-        newAtom1 = false;
       }
 
       if (iLoop == PREPAIR_LOOP) {
@@ -1013,9 +868,11 @@ namespace OpenMD {
       }
     }
 
+    pairLoopPrimed_ = true;
+
     // collects pairwise information
     fDecomp_->collectData();
-    if (cutoffMethod_ == EWALD_FULL) {
+    if (cutoffMethod_ == EWALD_FULL || cutoffMethod_ == EWALD_SPME) {
       interactionMan_->doReciprocalSpaceSum(reciprocalPotential);
       curSnapshot->setReciprocalPotential(reciprocalPotential);
     }
@@ -1056,6 +913,359 @@ namespace OpenMD {
     }
   }
 
+  /**
+   * A single pass (pre-pair or pair) through the neighbor list.  When
+   * this is called from inside a parallel region, the row cutoff
+   * groups are divided among the threads, and each thread accumulates
+   * forces, potentials, and the virial into its own storage (thread 0
+   * uses the normal work arrays).
+   */
+  /**
+   * Expands the cutoff-group neighbor list into the atom pairs that
+   * the pair loop visits.  Everything about a pair that only depends
+   * on the topology (whether the decomposition skips it, exclusions,
+   * and the topological scaling of the interactions) is worked out
+   * here, once per neighbor list build, instead of on every step.
+   */
+  void ForceManager::buildAtomPairList() {
+    int cg1, cg2, atom1, atom2, topoDist, iHash;
+    bool excluded;
+    vector<int>::iterator ia, jb;
+
+    pairPoint_.clear();
+    pairIsGroupPair_.clear();
+    pairAtom1_.clear();
+    pairAtom2_.clear();
+    pairExcluded_.clear();
+    pairVdwMult_.clear();
+    pairElectroMult_.clear();
+
+    pairPoint_.reserve(neighborList_.size() + 1);
+    pairIsGroupPair_.reserve(neighborList_.size());
+
+    for (cg1 = 0; cg1 < int(point_.size()) - 1; cg1++) {
+      vector<int>& atomListRow = fDecomp_->getAtomsInGroupRow(cg1);
+
+      for (int m2 = point_[cg1]; m2 < point_[cg1+1]; m2++) {
+        cg2 = neighborList_[m2];
+        vector<int>& atomListColumn = fDecomp_->getAtomsInGroupColumn(cg2);
+
+        pairPoint_.push_back(pairAtom1_.size());
+        pairIsGroupPair_.push_back(atomListRow.size() == 1 &&
+                                   atomListColumn.size() == 1);
+
+        for (ia = atomListRow.begin(); ia != atomListRow.end(); ++ia) {
+          atom1 = (*ia);
+          for (jb = atomListColumn.begin();
+               jb != atomListColumn.end(); ++jb) {
+            atom2 = (*jb);
+
+            if (fDecomp_->skipAtomPair(atom1, atom2, cg1, cg2)) continue;
+
+            // excluded pairs only matter to the electrostatic
+            // interaction, and pairs of types with no non-bonded
+            // interactions never contribute:
+            excluded = fDecomp_->excludeAtomPair(atom1, atom2);
+            iHash = interactionMan_->getInteractionHash(
+                                           fDecomp_->getIdentRow(atom1),
+                                           fDecomp_->getIdentCol(atom2));
+            if (excluded) iHash &= ELECTROSTATIC_INTERACTION;
+            if (iHash == 0) continue;
+
+            topoDist = fDecomp_->getTopologicalDistance(atom1, atom2);
+
+            pairAtom1_.push_back(atom1);
+            pairAtom2_.push_back(atom2);
+            pairExcluded_.push_back(excluded);
+            pairVdwMult_.push_back(vdwScale_[topoDist]);
+            pairElectroMult_.push_back(electrostaticScale_[topoDist]);
+          }
+        }
+      }
+    }
+    pairPoint_.push_back(pairAtom1_.size());
+    pairListStale_ = false;
+  }
+
+  /**
+   * The charge-only path used by the fluctuating charge
+   * equilibration.  For every pair of fluctuating charges in the
+   * current pair list this reports the global IDs of the two atoms
+   * and the (switched) coupling d^2 U / dq1 dq2, which does not depend
+   * on the charges themselves.  The geometry and the pair list are
+   * the ones left behind by the last call to calcForces().  In
+   * parallel, each processor reports only the pairs it owns.
+   */
+  void ForceManager::getFluctuatingChargeCouplings(vector<int>& gid1,
+                                                   vector<int>& gid2,
+                                                   vector<RealType>& coupling) {
+    gid1.clear();
+    gid2.clear();
+    coupling.clear();
+
+    if (!info_->usesFluctuatingCharges()) return;
+    if (pairListStale_) buildAtomPairList();
+
+    Snapshot* curSnapshot = info_->getSnapshotManager()->getCurrentSnapshot();
+    int cg1, cg2, atom1, atom2;
+    Vector3d d_grp, d;
+    RealType rgrpsq, rgrp, r, sw, dswdr, k;
+
+    for (cg1 = 0; cg1 < int(point_.size()) - 1; cg1++) {
+      for (int m2 = point_[cg1]; m2 < point_[cg1+1]; m2++) {
+        cg2 = neighborList_[m2];
+
+        d_grp  = fDecomp_->getIntergroupVector(cg1, cg2);
+        rgrpsq = d_grp.lengthSquare();
+        if (rgrpsq >= rCutSq_) continue;
+
+        switcher_->getSwitch(rgrpsq, sw, dswdr, rgrp);
+
+        for (int p = pairPoint_[m2]; p < pairPoint_[m2+1]; p++) {
+          atom1 = pairAtom1_[p];
+          atom2 = pairAtom2_[p];
+
+          if (pairIsGroupPair_[m2]) {
+            r = sqrt(rgrpsq);
+          } else {
+            d = fDecomp_->getInteratomicVector(atom1, atom2);
+            curSnapshot->wrapVector( d );
+            r = d.length();
+          }
+
+          k = interactionMan_->getFluctuatingChargeCoupling(
+                                              fDecomp_->getIdentRow(atom1),
+                                              fDecomp_->getIdentCol(atom2),
+                                              r, pairExcluded_[p],
+                                              pairElectroMult_[p]);
+          if (k == 0.0) continue;
+
+          gid1.push_back(fDecomp_->getGlobalIDRow(atom1));
+          gid2.push_back(fDecomp_->getGlobalIDCol(atom2));
+          coupling.push_back(k * sw);
+        }
+      }
+    }
+  }
+
+  void ForceManager::longRangePairLoop(int iLoop, int tid) {
+
+    Snapshot* curSnapshot = info_->getSnapshotManager()->getCurrentSnapshot();
+    Mat3x3d& virial = (tid == 0) ? virialTensor : threadVirial_[tid];
+
+    int cg1, cg2, atom1, atom2;
+    Vector3d d_grp, dag, d, gvel2, vel2;
+    RealType rgrpsq, rgrp, r2, r;
+    RealType electroMult, vdwMult;
+    RealType vij(0.0);
+    Vector3d fij, fg, f1;
+    bool in_switching_region;
+    RealType sw, dswdr, swderiv;
+    vector<int> atomListColumn, atomListRow;
+    InteractionData idat;
+    RealType mf;
+    RealType vpair;
+    RealType dVdFQ1(0.0);
+    RealType dVdFQ2(0.0);
+    potVec workPot(0.0);
+    potVec exPot(0.0);
+    potVec selectionPotential(0.0);
+    Vector3d eField1(0.0);
+    Vector3d eField2(0.0);
+    RealType sPot1(0.0);
+    RealType sPot2(0.0);
+    int gid1, gid2;
+
+    vector<int>::iterator ia, jb;
+
+    idat.rcut = &rCut_;
+    idat.vdwMult = &vdwMult;
+    idat.electroMult = &electroMult;
+    idat.pot = &workPot;
+    idat.excludedPot = &exPot;
+    idat.selePot = &selectionPotential;
+    idat.vpair = &vpair;
+    idat.dVdFQ1 = &dVdFQ1;
+    idat.dVdFQ2 = &dVdFQ2;
+    idat.eField1 = &eField1;
+    idat.eField2 = &eField2;
+    idat.sPot1 = &sPot1;
+    idat.sPot2 = &sPot2;
+    idat.f1 = &f1;
+    idat.sw = &sw;
+    idat.shiftedPot = (cutoffMethod_ == SHIFTED_POTENTIAL) ? true : false;
+    idat.shiftedForce = (cutoffMethod_ == SHIFTED_FORCE ||
+                         cutoffMethod_ == TAYLOR_SHIFTED) ? true : false;
+    idat.doParticlePot = doParticlePot_;
+    idat.doElectricField = doElectricField_;
+    idat.doSitePotential = doSitePotential_;
+
+    // the row-atom properties in idat are only refreshed when atom1
+    // changes from one pair to the next:
+    int lastAtom1 = -1;
+
+#pragma omp for schedule(runtime)
+    for (cg1 = 0; cg1 < int(point_.size()) - 1; cg1++) {
+
+      for (int m2 = point_[cg1]; m2 < point_[cg1+1]; m2++) {
+
+        cg2 = neighborList_[m2];
+
+        d_grp  = fDecomp_->getIntergroupVector(cg1, cg2);
+
+        // already wrapped in the getIntergroupVector call:
+        // curSnapshot->wrapVector(d_grp);
+        rgrpsq = d_grp.lengthSquare();
+
+        if (rgrpsq < rCutSq_) {
+          if (iLoop == PAIR_LOOP) {
+            vij = 0.0;
+            fij.zero();
+            eField1.zero();
+            eField2.zero();
+            sPot1 = 0.0;
+            sPot2 = 0.0;
+          }
+
+          in_switching_region = switcher_->getSwitch(rgrpsq, sw, dswdr,
+                                                     rgrp);
+
+          if (doHeatFlux_) {
+            gvel2 = fDecomp_->getGroupVelocityColumn(cg2);
+            vel2 = gvel2;
+          }
+
+          for (int p = pairPoint_[m2]; p < pairPoint_[m2+1]; p++) {
+            atom1 = pairAtom1_[p];
+            atom2 = pairAtom2_[p];
+
+            if (doPotentialSelection_) {
+              gid1 = fDecomp_->getGlobalIDRow(atom1);
+              gid2 = fDecomp_->getGlobalIDCol(atom2);
+              idat.isSelected = seleMan_.isGlobalIDSelected(gid1) ||
+                seleMan_.isGlobalIDSelected(gid2);
+            }
+
+            vpair = 0.0;
+            workPot = 0.0;
+            exPot = 0.0;
+            selectionPotential = 0.0;
+            f1.zero();
+            dVdFQ1 = 0.0;
+            dVdFQ2 = 0.0;
+
+            fDecomp_->fillInteractionData(idat, atom1, atom2,
+                                          atom1 != lastAtom1, tid);
+            lastAtom1 = atom1;
+
+            idat.excluded = pairExcluded_[p];
+            vdwMult = pairVdwMult_[p];
+            electroMult = pairElectroMult_[p];
+
+            if (pairIsGroupPair_[m2]) {
+              idat.d = &d_grp;
+              idat.r2 = &rgrpsq;
+            } else {
+              d = fDecomp_->getInteratomicVector(atom1, atom2);
+              curSnapshot->wrapVector( d );
+              r2 = d.lengthSquare();
+              idat.d = &d;
+              idat.r2 = &r2;
+              if (doHeatFlux_)
+                vel2 = fDecomp_->getAtomVelocityColumn(atom2);
+            }
+
+            r = sqrt( *(idat.r2) );
+            idat.rij = &r;
+
+            if (iLoop == PREPAIR_LOOP) {
+              interactionMan_->doPrePair(idat);
+            } else {
+              interactionMan_->doPair(idat);
+              fDecomp_->unpackInteractionData(idat, atom1, atom2, tid);
+              vij += vpair;
+              fij += f1;
+              virial -= outProduct( *(idat.d), f1);
+              if (doHeatFlux_)
+                addToHeatFlux(tid, *(idat.d) * dot(f1, vel2));
+            }
+          }
+
+          if (iLoop == PAIR_LOOP) {
+            if (in_switching_region) {
+              swderiv = vij * dswdr / rgrp;
+              fg = swderiv * d_grp;
+              fij += fg;
+
+              atomListRow = fDecomp_->getAtomsInGroupRow(cg1);
+              atomListColumn = fDecomp_->getAtomsInGroupColumn(cg2);
+
+              if (pairIsGroupPair_[m2]) {
+                if (pairPoint_[m2+1] > pairPoint_[m2]) {
+                  virial -= outProduct(d_grp, fg);
+                  if (doHeatFlux_)
+                    addToHeatFlux(tid, d_grp * dot(fg, vel2));
+                }
+              }
+
+              for (ia = atomListRow.begin();
+                   ia != atomListRow.end(); ++ia) {
+                atom1 = (*ia);
+                mf = fDecomp_->getMassFactorRow(atom1);
+                // fg is the force on atom ia due to cutoff group's
+                // presence in switching region
+                fg = swderiv * d_grp * mf;
+                fDecomp_->addForceToAtomRow(atom1, fg, tid);
+                if (atomListRow.size() > 1) {
+                  if (info_->usesAtomicVirial()) {
+                    // find the distance between the atom
+                    // and the center of the cutoff group:
+                    dag = fDecomp_->getAtomToGroupVectorRow(atom1, cg1);
+                    virial -= outProduct(dag, fg);
+                    if (doHeatFlux_)
+                      addToHeatFlux(tid,  dag * dot(fg, vel2));
+                  }
+                }
+              }
+              for (jb = atomListColumn.begin();
+                   jb != atomListColumn.end(); ++jb) {
+                atom2 = (*jb);
+                mf = fDecomp_->getMassFactorColumn(atom2);
+                // fg is the force on atom jb due to cutoff group's
+                // presence in switching region
+                fg = -swderiv * d_grp * mf;
+                fDecomp_->addForceToAtomColumn(atom2, fg, tid);
+
+                if (atomListColumn.size() > 1) {
+                  if (info_->usesAtomicVirial()) {
+                    // find the distance between the atom
+                    // and the center of the cutoff group:
+                    dag = fDecomp_->getAtomToGroupVectorColumn(atom2, cg2);
+                    virial -= outProduct(dag, fg);
+                    if (doHeatFlux_)
+                      addToHeatFlux(tid,  dag * dot(fg, vel2));
+                  }
+                }
+              }
+            }
+            //if (!info_->usesAtomicVirial()) {
+            //  virial -= outProduct(d_grp, fij);
+            //  if (doHeatFlux_)
+            //     addToHeatFlux(tid,  d_grp * dot(fij, vel2));
+            //}
+          }
+        }
+      }
+    }
+  }
+
+  void ForceManager::addToHeatFlux(int tid, const Vector3d& hf) {
+    if (tid == 0)
+      fDecomp_->addToHeatFlux(hf);
+    else
+      threadHeatFlux_[tid] += hf;
+  }
+
   void ForceManager::postCalculation() {
 
     vector<Perturbation*>::iterator pi;
@@ -1590,6 +1800,7 @@ namespace OpenMD {
           if (!usePeriodicBoundaryConditions_)
             Mat3x3d bbox = thermo->getBoundingBox();
           fDecomp_->buildNeighborList(neighborList_, point_);
+          pairListStale_ = true;
         }
       }
 
@@ -1654,6 +1865,7 @@ namespace OpenMD {
                   dVdFQ1 = 0.0;
                   dVdFQ2 = 0.0;
 
+                  idat.excluded = fDecomp_->excludeAtomPair(atom1, atom2);
                   fDecomp_->fillInteractionData(idat, atom1, atom2, newAtom1);
 
                   topoDist = fDecomp_->getTopologicalDistance(atom1, atom2);
@@ -1783,7 +1995,7 @@ namespace OpenMD {
 
     // collects pairwise information
     fDecomp_->collectData();
-    if (cutoffMethod_ == EWALD_FULL) {
+    if (cutoffMethod_ == EWALD_FULL || cutoffMethod_ == EWALD_SPME) {
       interactionMan_->doReciprocalSpaceSum(reciprocalPotential);
       curSnapshot->setReciprocalPotential(reciprocalPotential);
 
@@ -83,6 +83,9 @@ namespace OpenMD {
     virtual void calcForces();
     virtual void calcSelectedForces(Molecule* mol1, Molecule* mol2);
     void setDoElectricField(bool def) { doElectricField_ = def; }
+    void getFluctuatingChargeCouplings(vector<int>& gid1, vector<int>& gid2,
+                                       vector<RealType>& coupling);
+
     void initialize();
 
   protected: 
@@ -101,6 +104,9 @@ namespace OpenMD {
     virtual void preCalculation();        
     virtual void shortRangeInteractions();
     virtual void longRangeInteractions();
+    void buildAtomPairList();
+    void longRangePairLoop(int iLoop, int tid);
+    void addToHeatFlux(int tid, const Vector3d& hf);
     virtual void postCalculation();
 
     virtual void selectedPreCalculation(Molecule* mol1, Molecule* mol2);        
@@ -130,11 +136,32 @@ namespace OpenMD {
     vector<int> neighborList_;
     vector<int> point_;
 
+    /**
+     * Atom pairs expanded from the cutoff-group neighbor list.  These
+     * are rebuilt whenever the neighbor list is, and already have the
+     * skipped pairs and pairs with no non-bonded interactions removed,
+     * so the pair loop only streams through them.  The atom pairs for
+     * the group pair neighborList_[m] are [pairPoint_[m], pairPoint_[m+1]).
+     */
+    vector<int> pairPoint_;
+    vector<bool> pairIsGroupPair_;   /**< both groups are single atoms */
+    vector<int> pairAtom1_;
+    vector<int> pairAtom2_;
+    vector<bool> pairExcluded_;
+    vector<RealType> pairVdwMult_;
+    vector<RealType> pairElectroMult_;
+    bool pairListStale_;             /**< neighbor list changed since build */
+
     vector<RealType> vdwScale_;
     vector<RealType> electrostaticScale_;
 
     Mat3x3d virialTensor;
 
+    int nThreads_;             /**< threads sharing the non-bonded pair loop */
+    bool pairLoopPrimed_;      /**< has the pair loop been run once serially? */
+    vector<Mat3x3d> threadVirial_;     /**< virial from threads other than 0 */
+    vector<Vector3d> threadHeatFlux_;  /**< heat flux from threads other than 0 */
+
     vector<Perturbation*> perturbations_;
 
     bool doPotentialSelection_;
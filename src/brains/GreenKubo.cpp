@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2005 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#ifdef IS_MPI
+#include <mpi.h>
+#endif
+
+#include <fstream>
+#include <cmath>
+#include "brains/GreenKubo.hpp"
+#include "utils/Constants.hpp"
+#include "utils/StringUtils.hpp"
+#include "utils/simError.h"
+
+namespace OpenMD {
+
+  GreenKubo::GreenKubo(SimInfo* info) : info_(info), thermo_(info),
+                                        stressCorr_(NULL), currentCorr_(NULL),
+                                        nSamples_(0), volumeSum_(0.0),
+                                        temperatureSum_(0.0) {
+    Globals* simParams = info_->getSimParams();
+    RealType dt = simParams->getDt();
+
+    if (simParams->haveCorrelationSampleTime()) {
+      // the correlators need evenly spaced samples, so round the
+      // sample time to a whole number of steps:
+      sampleTime_ = std::max(RealType(1.0), round(simParams->getCorrelationSampleTime() / dt))
+        * dt;
+    } else {
+      sampleTime_ = dt;
+    }
+
+    int maxLag = int(simParams->getRunTime() / sampleTime_) + 1;
+    int nLevels = MultipleTauCorrelator::levelsForLag(maxLag);
+
+    if (simParams->getAccumulateStressCorrelation())
+      stressCorr_ = new MultipleTauCorrelator(9, nLevels);
+    if (simParams->getAccumulateCurrentCorrelation())
+      currentCorr_ = new MultipleTauCorrelator(3, nLevels);
+
+    outputFileName_ = getPrefix(info_->getFinalConfigFileName()) + ".gk";
+  }
+
+  GreenKubo::~GreenKubo() {
+    delete stressCorr_;
+    delete currentCorr_;
+  }
+
+  void GreenKubo::collectData() {
+    // the Thermo routines reduce over all processors, so every
+    // processor keeps an identical copy of the correlators.
+    if (stressCorr_ != NULL) {
+      Mat3x3d pressureTensor = thermo_.getPressureTensor();
+      RealType p[9];
+      for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+          p[3*i + j] = pressureTensor(i, j) * Constants::pressureConvert;
+      stressCorr_->add(p, p);
+    }
+
+    if (currentCorr_ != NULL) {
+      Vector3d Jc = thermo_.getCurrentDensity()[0];
+      RealType J[3] = {Jc[0], Jc[1], Jc[2]};
+      currentCorr_->add(J, J);
+    }
+
+    volumeSum_ += thermo_.getVolume();
+    temperatureSum_ += thermo_.getTemperature();
+    nSamples_++;
+  }
+
+  void GreenKubo::writeOutputFile() {
+    if (nSamples_ == 0) return;
+
+#ifdef IS_MPI
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+    if (worldRank != 0) return;
+#endif
+
+    std::vector<int> lags;
+    std::vector<RealType> stress, stressCount;
+    std::vector<RealType> current, currentCount;
+
+    if (stressCorr_ != NULL) {
+      lags = stressCorr_->getLags();
+      stress.assign(9 * lags.size(), 0.0);
+      stressCount.assign(lags.size(), 0.0);
+      stressCorr_->addTo(stress, stressCount);
+    }
+    if (currentCorr_ != NULL) {
+      lags = currentCorr_->getLags();
+      current.assign(3 * lags.size(), 0.0);
+      currentCount.assign(lags.size(), 0.0);
+      currentCorr_->addTo(current, currentCount);
+    }
+
+    std::ofstream ofs(outputFileName_.c_str());
+    if (!ofs.is_open()) {
+      sprintf(painCave.errMsg,
+              "GreenKubo: Could not open \"%s\" for output.\n",
+              outputFileName_.c_str());
+      painCave.isFatal = 1;
+      simError();
+    }
+
+    ofs << "# Green-Kubo time correlation functions\n";
+    ofs << "# correlationSampleTime = " << sampleTime_ << " fs\n";
+    ofs << "# samples = " << nSamples_ << "\n";
+    ofs << "# <volume> = " << volumeSum_ / nSamples_ << " Ang^3\n";
+    ofs << "# <temperature> = " << temperatureSum_ / nSamples_ << " K\n";
+    ofs << "#time(fs)";
+    if (stressCorr_ != NULL) {
+      const char* labels[] = {"xx", "xy", "xz", "yx", "yy", "yz",
+                              "zx", "zy", "zz"};
+      for (int k = 0; k < 9; k++)
+        ofs << "\t<P" << labels[k] << "(0)P" << labels[k] << "(t)>";
+      ofs << " (atm^2)";
+    }
+    if (currentCorr_ != NULL) {
+      const char* labels[] = {"x", "y", "z"};
+      for (int k = 0; k < 3; k++)
+        ofs << "\t<J" << labels[k] << "(0)J" << labels[k] << "(t)>";
+      ofs << " (A^2 m^-4)";
+    }
+    ofs << "\n";
+
+    for (unsigned int l = 0; l < lags.size(); l++) {
+      RealType count = (stressCorr_ != NULL) ? stressCount[l] : currentCount[l];
+      if (count < 0.5) continue;
+
+      ofs << lags[l] * sampleTime_;
+      if (stressCorr_ != NULL)
+        for (int k = 0; k < 9; k++)
+          ofs << "\t" << stress[9 * l + k] / stressCount[l];
+      if (currentCorr_ != NULL)
+        for (int k = 0; k < 3; k++)
+          ofs << "\t" << current[3 * l + k] / currentCount[l];
+      ofs << "\n";
+    }
+    ofs.close();
+  }
+}
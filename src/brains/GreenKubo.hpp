@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2005 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#ifndef BRAINS_GREENKUBO_HPP
+#define BRAINS_GREENKUBO_HPP
+
+#include <string>
+#include "brains/SimInfo.hpp"
+#include "brains/Thermo.hpp"
+#include "math/MultipleTauCorrelator.hpp"
+
+namespace OpenMD {
+
+  /**
+   * @class GreenKubo GreenKubo.hpp "brains/GreenKubo.hpp"
+   * Accumulates the time correlation functions that enter Green-Kubo
+   * transport coefficients while the simulation runs.
+   *
+   * The elements of the pressure tensor (for the shear and bulk
+   * viscosities) and of the electrical current density (for the
+   * conductivity) are fed to multiple-tau correlators every
+   * correlationSampleTime, so the autocorrelations reach the length
+   * of the run without storing the trajectory.  The correlations, along
+   * with the average volume and temperature needed for the Green-Kubo
+   * prefactors, are written to a <prefix>.gk file.
+   */
+  class GreenKubo {
+  public:
+    GreenKubo(SimInfo* info);
+    ~GreenKubo();
+
+    RealType getSampleTime() { return sampleTime_; }
+
+    /** Adds the current snapshot to the correlators */
+    void collectData();
+    void writeOutputFile();
+
+  private:
+    SimInfo* info_;
+    Thermo thermo_;
+    RealType sampleTime_;
+    std::string outputFileName_;
+
+    MultipleTauCorrelator* stressCorr_;
+    MultipleTauCorrelator* currentCorr_;
+
+    int nSamples_;
+    RealType volumeSum_;
+    RealType temperatureSum_;
+  };
+}
+#endif
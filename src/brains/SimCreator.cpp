@@ -61,6 +61,9 @@
 #include "brains/SimCreator.hpp"
 #include "brains/SimSnapshotManager.hpp"
 #include "io/DumpReader.hpp"
+#ifdef HAVE_LIBZ
+#include "io/gzstream.hpp"
+#endif
 #include "brains/ForceField.hpp"
 #include "utils/simError.h"
 #include "utils/StringUtils.hpp"
@@ -297,7 +300,28 @@ namespace OpenMD {
         simError(); 
       } 
 
-      mdFile_.getline(buffer, bufferSize);
+      std::istream* mdStream = &mdFile_;
+#ifdef HAVE_LIBZ
+      // Only the MetaData block is needed from a compressed dump file,
+      // so decompress that much into memory and parse it from there:
+      std::stringstream gzMetaData;
+      char magic[2] = {0, 0};
+      mdFile_.read(magic, 2);
+      mdFile_.clear();
+      mdFile_.seekg(0);
+      if ((unsigned char)magic[0] == 0x1f && (unsigned char)magic[1] == 0x8b) {
+        igzstream gzFile(mdFileName.c_str());
+        while (gzFile.getline(buffer, bufferSize)) {
+          gzMetaData << buffer << "\n";
+          if (CaseInsensitiveFind(std::string(buffer), "</MetaData>") !=
+              string::npos)
+            break;
+        }
+        mdStream = &gzMetaData;
+      }
+#endif
+
+      mdStream->getline(buffer, bufferSize);
       ++lineNo;
       std::string line = trimLeftCopy(buffer);
       std::size_t i = CaseInsensitiveFind(line, "<OpenMD");
@@ -338,7 +362,7 @@ namespace OpenMD {
       bool startFound(false);
       bool endFound(false);
       //scan through the input stream and find MetaData tag        
-      while(mdFile_.getline(buffer, bufferSize)) {
+      while(mdStream->getline(buffer, bufferSize)) {
         ++lineNo;
         
         std::string line = trimLeftCopy(buffer);
@@ -347,7 +371,7 @@ namespace OpenMD {
           if (i != string::npos) {
             metaDataBlockStart = lineNo;
             startFound = true;
-            mdOffset = mdFile_.tellg();
+            mdOffset = mdStream->tellg();
           }
         } else {
           std::size_t i = CaseInsensitiveFind(line, "</MetaData>");
@@ -374,16 +398,16 @@ namespace OpenMD {
         simError(); 
       }
         
-      mdFile_.clear();
-      mdFile_.seekg(0);
-      mdFile_.seekg(mdOffset);
+      mdStream->clear();
+      mdStream->seekg(0);
+      mdStream->seekg(mdOffset);
 
       mdRawData.clear();
 
       bool foundVersion = false;
 
       for (int i = 0; i < metaDataBlockEnd - metaDataBlockStart - 1; ++i) {
-        mdFile_.getline(buffer, bufferSize);
+        mdStream->getline(buffer, bufferSize);
         std::string line = trimLeftCopy(buffer);
         std::size_t j = CaseInsensitiveFind(line,
                                             "## Last run using OpenMD Version");
@@ -498,29 +522,22 @@ namespace OpenMD {
   
   void SimCreator::gatherParameters(SimInfo *info, const std::string& mdfile) {
     
-    //figure out the output file names
+    //figure out the output file names.  Every node needs these, since
+    //the dump and eor files are written collectively.
     std::string prefix;
     
-#ifdef IS_MPI
-    
-    if (worldRank == 0) {
-#endif // is_mpi
-      Globals * simParams = info->getSimParams();
-      if (simParams->haveFinalConfig()) {
-        prefix = getPrefix(simParams->getFinalConfig());
-      } else {
-        prefix = getPrefix(mdfile);
-      }
-      
-      info->setFinalConfigFileName(prefix + ".eor");
-      info->setDumpFileName(prefix + ".dump");
-      info->setStatFileName(prefix + ".stat");
-      info->setReportFileName(prefix + ".report");
-      info->setRestFileName(prefix + ".zang");
+    Globals * simParams = info->getSimParams();
+    if (simParams->haveFinalConfig()) {
+      prefix = getPrefix(simParams->getFinalConfig());
+    } else {
+      prefix = getPrefix(mdfile);
+    }
       
-#ifdef IS_MPI      
-    }    
-#endif    
+    info->setFinalConfigFileName(prefix + ".eor");
+    info->setDumpFileName(prefix + ".dump");
+    info->setStatFileName(prefix + ".stat");
+    info->setReportFileName(prefix + ".report");
+    info->setRestFileName(prefix + ".zang");
   }
   
 #ifdef IS_MPI
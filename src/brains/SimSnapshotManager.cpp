@@ -68,7 +68,7 @@ namespace OpenMD {
   }
   bool SimSnapshotManager::advance() {
 
-    *previousSnapshot_ = *currentSnapshot_;
+    previousSnapshot_->copyFrom(*currentSnapshot_, getHistoryLayout());
     currentSnapshot_->setID(currentSnapshot_->getID() + 1);    
     currentSnapshot_->clearDerivedProperties();
     return true;
@@ -77,7 +77,7 @@ namespace OpenMD {
   bool SimSnapshotManager::resetToPrevious() {
     
     int prevID = previousSnapshot_->getID();
-    *currentSnapshot_ = *previousSnapshot_;
+    currentSnapshot_->copyFrom(*previousSnapshot_, getHistoryLayout());
     currentSnapshot_->setID(prevID);
     return true;
   }
@@ -185,6 +185,46 @@ namespace OpenMD {
     hasBoundingBox = false;
   }
 
+  void Snapshot::copyFrom(Snapshot& s, int layout) {
+    atomData.copyFrom(s.atomData, layout);
+    rigidbodyData.copyFrom(s.rigidbodyData, layout);
+    cgData.copyFrom(s.cgData, layout);
+    frameData = s.frameData;
+    orthoTolerance_ = s.orthoTolerance_;
+
+    hasTotalEnergy = s.hasTotalEnergy;
+    hasTranslationalKineticEnergy = s.hasTranslationalKineticEnergy;
+    hasRotationalKineticEnergy = s.hasRotationalKineticEnergy;
+    hasElectronicKineticEnergy = s.hasElectronicKineticEnergy;
+    hasKineticEnergy = s.hasKineticEnergy;
+    hasShortRangePotential = s.hasShortRangePotential;
+    hasLongRangePotential = s.hasLongRangePotential;
+    hasExcludedPotential = s.hasExcludedPotential;
+    hasSelfPotential = s.hasSelfPotential;
+    hasPotentialEnergy = s.hasPotentialEnergy;
+    hasXYarea = s.hasXYarea;
+    hasXZarea = s.hasXZarea;
+    hasYZarea = s.hasYZarea;
+    hasVolume = s.hasVolume;
+    hasPressure = s.hasPressure;
+    hasTemperature = s.hasTemperature;
+    hasElectronicTemperature = s.hasElectronicTemperature;
+    hasNetCharge = s.hasNetCharge;
+    hasChargeMomentum = s.hasChargeMomentum;
+    hasCOM = s.hasCOM;
+    hasCOMvel = s.hasCOMvel;
+    hasCOMw = s.hasCOMw;
+    hasPressureTensor = s.hasPressureTensor;
+    hasSystemDipole = s.hasSystemDipole;
+    hasSystemQuadrupole = s.hasSystemQuadrupole;
+    hasConvectiveHeatFlux = s.hasConvectiveHeatFlux;
+    hasInertiaTensor = s.hasInertiaTensor;
+    hasGyrationalVolume = s.hasGyrationalVolume;
+    hasHullVolume = s.hasHullVolume;
+    hasConservedQuantity = s.hasConservedQuantity;
+    hasBoundingBox = s.hasBoundingBox;
+  }
+
   /** Returns the id of this Snapshot */
   int Snapshot::getID() {
     return frameData.id;
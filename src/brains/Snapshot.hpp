@@ -136,6 +136,13 @@ namespace OpenMD{
     /** sets the state of the computed properties to false */
     void     clearDerivedProperties();
 
+    /**
+     * Copies the FrameData, the state of the computed properties and
+     * the per-object arrays selected by layout (a DataStorage layout)
+     * from another Snapshot.
+     */
+    void     copyFrom(Snapshot& s, int layout);
+
     int      getSize();
     /** Returns the number of atoms */
     int      getNumberOfAtoms();
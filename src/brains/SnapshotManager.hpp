@@ -95,13 +95,30 @@ namespace OpenMD{
     int getStorageLayout() {
       return storageLayout_;
     }
+
+    /**
+     * Sets the per-object arrays (a DataStorage layout) that advance()
+     * keeps in the previous snapshot and resetToPrevious() restores.
+     * The FrameData is always kept.  By default, every array in the
+     * storage layout is kept; users that know which arrays are read
+     * from the previous snapshot can narrow this to avoid copying the
+     * rest on every step.
+     */
+    void setHistoryLayout(int layout) {
+      historyLayout_ = layout;
+    }
+
+    int getHistoryLayout() {
+      return historyLayout_;
+    }
     
   private:
     int storageLayout_;
+    int historyLayout_;
 
   protected:
 
-    SnapshotManager(int storageLayout) : storageLayout_(storageLayout), currentSnapshot_(NULL), previousSnapshot_(NULL) {
+    SnapshotManager(int storageLayout) : storageLayout_(storageLayout), historyLayout_(storageLayout), currentSnapshot_(NULL), previousSnapshot_(NULL) {
     }
             
     Snapshot* currentSnapshot_;
@@ -46,6 +46,9 @@
 /* Define to 1 if you have the `z' library (-lz). */
 #cmakedefine HAVE_LIBZ 1
 
+/* Define to 1 if POSIX threads are available. */
+#cmakedefine HAVE_PTHREAD 1
+
 /* Define to the one symbol short name of this package. */
 #cmakedefine PACKAGE_TARNAME
 
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2012 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *                                                                      
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).             
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).          
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).          
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "flucq/FluctuatingChargeEquilibrator.hpp"
+#include "primitives/Molecule.hpp"
+#include "types/FluctuatingChargeAdapter.hpp"
+#include "utils/simError.h"
+
+#ifdef IS_MPI
+#include <mpi.h>
+#endif
+
+namespace OpenMD {
+
+  FluctuatingChargeEquilibrator::FluctuatingChargeEquilibrator(SimInfo* info,
+                                                               ForceManager* forceMan) :
+    info_(info), forceMan_(forceMan), nForceEvaluations_(0), nFlucQ_(0),
+    nGroups_(0), setup_(false) {
+  }
+
+  void FluctuatingChargeEquilibrator::setupCharges() {
+    SimInfo::MoleculeIterator i;
+    Molecule::FluctuatingChargeIterator  j;
+    Molecule* mol;
+    Atom* atom;
+
+    bool constrainRegions = info_->getSimParams()->getFluctuatingChargeParameters()->getConstrainRegions();
+
+    // Each charge is labeled with the constraint it belongs to: 0 for
+    // the system, region + 1 for constrained regions, and -(1 + global
+    // molecule index) for molecules with constrained total charges.
+
+    std::vector<int> gids;
+    std::vector<int> codes;
+
+    localAtoms_.clear();
+    for (mol = info_->beginMolecule(i); mol != NULL;
+         mol = info_->nextMolecule(i)) {
+      int code = 0;
+      if (mol->constrainTotalCharge()) {
+        code = -(1 + mol->getGlobalIndex());
+      } else if (constrainRegions && mol->getRegion() >= 0) {
+        code = 1 + mol->getRegion();
+      }
+      for (atom = mol->beginFluctuatingCharge(j); atom != NULL;
+           atom = mol->nextFluctuatingCharge(j)) {
+        localAtoms_.push_back(atom);
+        gids.push_back(atom->getGlobalIndex());
+        codes.push_back(code);
+
+        int atid = atom->getAtomType()->getIdent();
+        if (selfCurvature_.find(atid) == selfCurvature_.end()) {
+          FluctuatingChargeAdapter fqa(atom->getAtomType());
+          DoublePolynomial vself = fqa.getSelfPolynomial();
+          DoublePolynomial curvature;
+          for (DoublePolynomial::iterator p = vself.begin();
+               p != vself.end(); ++p) {
+            if (p->first >= 2)
+              curvature.addCoefficient(p->first - 2,
+                                       p->first * (p->first - 1) * p->second);
+          }
+          selfCurvature_[atid] = curvature;
+        }
+      }
+    }
+
+    nFlucQ_ = localAtoms_.size();
+
+#ifdef IS_MPI
+    int nproc;
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+    counts_.assign(nproc, 0);
+    displacements_.assign(nproc, 0);
+
+    int nLocal = nFlucQ_;
+    MPI_Allgather(&nLocal, 1, MPI_INT, &counts_[0], 1, MPI_INT,
+                  MPI_COMM_WORLD);
+    nFlucQ_ = counts_[0];
+    for (int iproc = 1; iproc < nproc; iproc++) {
+      nFlucQ_ += counts_[iproc];
+      displacements_[iproc] = displacements_[iproc-1] + counts_[iproc-1];
+    }
+
+    std::vector<int> allGids(nFlucQ_);
+    std::vector<int> allCodes(nFlucQ_);
+    MPI_Allgatherv(&gids[0], nLocal, MPI_INT, &allGids[0], &counts_[0],
+                   &displacements_[0], MPI_INT, MPI_COMM_WORLD);
+    MPI_Allgatherv(&codes[0], nLocal, MPI_INT, &allCodes[0], &counts_[0],
+                   &displacements_[0], MPI_INT, MPI_COMM_WORLD);
+    gids = allGids;
+    codes = allCodes;
+#endif
+
+    atomToFQ_.assign(info_->getNGlobalAtoms(), -1);
+    for (int k = 0; k < nFlucQ_; k++) atomToFQ_[gids[k]] = k;
+
+    std::map<int, int> groups;
+    std::map<int, int>::iterator g;
+    group_.resize(nFlucQ_);
+    groupSize_.clear();
+    for (int k = 0; k < nFlucQ_; k++) {
+      g = groups.find(codes[k]);
+      if (g == groups.end()) {
+        g = groups.insert(std::make_pair(codes[k], int(groupSize_.size()))).first;
+        groupSize_.push_back(0);
+      }
+      group_[k] = g->second;
+      groupSize_[g->second]++;
+    }
+    nGroups_ = groupSize_.size();
+
+    charge_.resize(nFlucQ_);
+    curvature_.resize(nFlucQ_);
+    setup_ = true;
+  }
+
+  void FluctuatingChargeEquilibrator::buildCouplings() {
+    std::vector<int> gid1, gid2;
+    std::vector<RealType> coupling;
+
+    forceMan_->getFluctuatingChargeCouplings(gid1, gid2, coupling);
+
+    pairI_.clear();
+    pairJ_.clear();
+    pairK_.clear();
+    for (unsigned int p = 0; p < coupling.size(); p++) {
+      int i = atomToFQ_[gid1[p]];
+      int j = atomToFQ_[gid2[p]];
+      if (i < 0 || j < 0) continue;
+      pairI_.push_back(i);
+      pairJ_.push_back(j);
+      pairK_.push_back(coupling[p]);
+    }
+  }
+
+  /**
+   * Gathers the gradient with respect to the charges (and the
+   * charges themselves) from the local atoms into replicated vectors.
+   */
+  void FluctuatingChargeEquilibrator::getGradient(std::vector<RealType>& grad) {
+    int offset = 0;
+#ifdef IS_MPI
+    int myrank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+    offset = displacements_[myrank];
+#endif
+    grad.assign(nFlucQ_, 0.0);
+    for (unsigned int k = 0; k < localAtoms_.size(); k++) {
+      grad[offset + k] = -localAtoms_[k]->getFlucQFrc();
+      charge_[offset + k] = localAtoms_[k]->getFlucQPos();
+    }
+#ifdef IS_MPI
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, &grad[0], &counts_[0],
+                   &displacements_[0], MPI_REALTYPE, MPI_COMM_WORLD);
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, &charge_[0],
+                   &counts_[0], &displacements_[0], MPI_REALTYPE,
+                   MPI_COMM_WORLD);
+#endif
+  }
+
+  void FluctuatingChargeEquilibrator::updateCurvatures() {
+    int offset = 0;
+#ifdef IS_MPI
+    int myrank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+    offset = displacements_[myrank];
+#endif
+    curvature_.assign(nFlucQ_, 0.0);
+    for (unsigned int k = 0; k < localAtoms_.size(); k++) {
+      int atid = localAtoms_[k]->getAtomType()->getIdent();
+      curvature_[offset + k] =
+        selfCurvature_[atid].evaluate(charge_[offset + k]);
+    }
+#ifdef IS_MPI
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, &curvature_[0],
+                   &counts_[0], &displacements_[0], MPI_REALTYPE,
+                   MPI_COMM_WORLD);
+#endif
+  }
+
+  void FluctuatingChargeEquilibrator::setCharges() {
+    int offset = 0;
+#ifdef IS_MPI
+    int myrank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+    offset = displacements_[myrank];
+#endif
+    for (unsigned int k = 0; k < localAtoms_.size(); k++)
+      localAtoms_[k]->setFlucQPos(charge_[offset + k]);
+
+    info_->getSnapshotManager()->getCurrentSnapshot()->clearDerivedProperties();
+  }
+
+  /**
+   * Removes the mean of v within each constraint, so that v is a
+   * charge displacement that conserves every constrained total.
+   */
+  void FluctuatingChargeEquilibrator::project(std::vector<RealType>& v) {
+    std::vector<RealType> mean(nGroups_, 0.0);
+    for (int k = 0; k < nFlucQ_; k++) mean[group_[k]] += v[k];
+    for (int g = 0; g < nGroups_; g++) mean[g] /= groupSize_[g];
+    for (int k = 0; k < nFlucQ_; k++) v[k] -= mean[group_[k]];
+  }
+
+  /**
+   * Jacobi preconditioner restricted to the constraint surface:
+   * z = D^-1 r - D^-1 1 (1^T D^-1 r) / (1^T D^-1 1) for each
+   * constraint, where D is the diagonal of the charge Hessian.
+   */
+  void FluctuatingChargeEquilibrator::precondition(const std::vector<RealType>& r,
+                                                   std::vector<RealType>& z) {
+    std::vector<RealType> dinv(nFlucQ_);
+    std::vector<RealType> sumZ(nGroups_, 0.0);
+    std::vector<RealType> sumDinv(nGroups_, 0.0);
+
+    z.resize(nFlucQ_);
+    for (int k = 0; k < nFlucQ_; k++) {
+      dinv[k] = curvature_[k] > 0.0 ? 1.0 / curvature_[k] : 1.0;
+      z[k] = dinv[k] * r[k];
+      sumZ[group_[k]] += z[k];
+      sumDinv[group_[k]] += dinv[k];
+    }
+    for (int k = 0; k < nFlucQ_; k++)
+      z[k] -= dinv[k] * sumZ[group_[k]] / sumDinv[group_[k]];
+  }
+
+  void FluctuatingChargeEquilibrator::hessianTimes(const std::vector<RealType>& v,
+                                                   std::vector<RealType>& hv) {
+    hv.assign(nFlucQ_, 0.0);
+    for (unsigned int p = 0; p < pairK_.size(); p++) {
+      hv[pairI_[p]] += pairK_[p] * v[pairJ_[p]];
+      hv[pairJ_[p]] += pairK_[p] * v[pairI_[p]];
+    }
+#ifdef IS_MPI
+    MPI_Allreduce(MPI_IN_PLACE, &hv[0], nFlucQ_, MPI_REALTYPE, MPI_SUM,
+                  MPI_COMM_WORLD);
+#endif
+    for (int k = 0; k < nFlucQ_; k++) hv[k] += curvature_[k] * v[k];
+  }
+
+  RealType FluctuatingChargeEquilibrator::rmsNorm(const std::vector<RealType>& v) {
+    RealType sum(0.0);
+    for (int k = 0; k < nFlucQ_; k++) sum += v[k] * v[k];
+    return nFlucQ_ > 0 ? sqrt(sum / nFlucQ_) : 0.0;
+  }
+
+  /**
+   * Preconditioned conjugate gradient solution of H step = rhs on the
+   * constraint surface.  Returns false if the Hessian was found not
+   * to be positive definite there; step then holds the progress made
+   * before that point.
+   */
+  bool FluctuatingChargeEquilibrator::solveStep(const std::vector<RealType>& rhs,
+                                                std::vector<RealType>& step,
+                                                RealType tolerance) {
+    std::vector<RealType> r(rhs);
+    std::vector<RealType> z, p, hp;
+    RealType rz, rzNew, php, alpha, beta;
+    int maxSteps = std::max(nFlucQ_, 10);
+
+    step.assign(nFlucQ_, 0.0);
+    precondition(r, z);
+    p = z;
+    rz = 0.0;
+    for (int k = 0; k < nFlucQ_; k++) rz += r[k] * z[k];
+
+    for (int iter = 0; iter < maxSteps; iter++) {
+      if (rmsNorm(r) < tolerance) break;
+
+      hessianTimes(p, hp);
+      project(hp);
+      php = 0.0;
+      for (int k = 0; k < nFlucQ_; k++) php += p[k] * hp[k];
+      if (php <= 0.0) return false;
+
+      alpha = rz / php;
+      for (int k = 0; k < nFlucQ_; k++) {
+        step[k] += alpha * p[k];
+        r[k] -= alpha * hp[k];
+      }
+
+      precondition(r, z);
+      rzNew = 0.0;
+      for (int k = 0; k < nFlucQ_; k++) rzNew += r[k] * z[k];
+      beta = rzNew / rz;
+      rz = rzNew;
+      for (int k = 0; k < nFlucQ_; k++) p[k] = z[k] + beta * p[k];
+    }
+    return true;
+  }
+
+  bool FluctuatingChargeEquilibrator::equilibrate(RealType tolerance,
+                                                  int maxIterations) {
+    std::vector<RealType> grad, step;
+    bool converged = false;
+
+    if (!setup_) setupCharges();
+    nForceEvaluations_ = 0;
+    if (nFlucQ_ == 0) return true;
+
+    for (int iter = 0; iter < maxIterations; iter++) {
+      forceMan_->calcForces();
+      nForceEvaluations_++;
+
+      getGradient(grad);
+      project(grad);
+      if (rmsNorm(grad) < tolerance) {
+        converged = true;
+        break;
+      }
+
+      // the couplings only depend on the geometry:
+      if (iter == 0) buildCouplings();
+      updateCurvatures();
+
+      for (int k = 0; k < nFlucQ_; k++) grad[k] = -grad[k];
+      bool positive = solveStep(grad, step, 0.1 * tolerance);
+      if (!positive && rmsNorm(step) == 0.0) break;
+
+      for (int k = 0; k < nFlucQ_; k++) charge_[k] += step[k];
+      setCharges();
+    }
+    return converged;
+  }
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2012 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *                                                                      
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).             
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).          
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).          
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#ifndef FLUCQ_FLUCTUATINGCHARGEEQUILIBRATOR_HPP
+#define FLUCQ_FLUCTUATINGCHARGEEQUILIBRATOR_HPP
+
+#include "brains/SimInfo.hpp"
+#include "brains/ForceManager.hpp"
+#include "math/Polynomial.hpp"
+
+namespace OpenMD {
+
+  /**
+   * @class FluctuatingChargeEquilibrator
+   * @brief Direct solution of the electronegativity equalization
+   * (QEq / EEM) problem for the fluctuating charges.
+   *
+   * Near a minimum, the dependence of the potential on the
+   * fluctuating charges is (very nearly) quadratic: the self
+   * polynomials supply the diagonal of the charge Hessian, and the
+   * pair couplings d^2 U / dq_i dq_j come from the Coulomb and Slater
+   * integrals of the electrostatic interaction.  Since the couplings
+   * depend only on the geometry, they are gathered once for the
+   * current configuration (ForceManager::getFluctuatingChargeCouplings)
+   * and then reused.
+   *
+   * Each outer iteration takes the true gradient from a force
+   * calculation, and solves the Newton step subject to the charge
+   * constraints (molecular, regional and system-wide neutrality are
+   * each conserved) with a Jacobi-preconditioned conjugate gradient
+   * that only touches the cached couplings.  The charges start from
+   * their current values, so consecutive steps of a simulation are
+   * warm-started.  When the self polynomials are quadratic and the
+   * electrostatics are purely real-space, a single Newton step lands
+   * on the minimum, and the second force calculation only confirms
+   * convergence.  Reciprocal space contributions and higher order
+   * self polynomials are picked up by the following outer iterations.
+   */
+  class FluctuatingChargeEquilibrator {
+  public:
+    FluctuatingChargeEquilibrator(SimInfo* info, ForceManager* forceMan);
+
+    /**
+     * Moves the fluctuating charges to the constrained minimum of the
+     * potential for the current configuration.  On return, the forces
+     * in the snapshot were computed with the final charges if the
+     * solve converged.
+     * @return true if the projected gradient fell below the tolerance
+     */
+    bool equilibrate(RealType tolerance, int maxIterations);
+
+    /** number of force calculations used by the last equilibrate() */
+    int getForceEvaluations() { return nForceEvaluations_; }
+
+  private:
+    void setupCharges();
+    void buildCouplings();
+    void getGradient(std::vector<RealType>& grad);
+    void setCharges();
+    void updateCurvatures();
+    void project(std::vector<RealType>& v);
+    void precondition(const std::vector<RealType>& r,
+                      std::vector<RealType>& z);
+    void hessianTimes(const std::vector<RealType>& v,
+                      std::vector<RealType>& hv);
+    bool solveStep(const std::vector<RealType>& rhs,
+                   std::vector<RealType>& step, RealType tolerance);
+    RealType rmsNorm(const std::vector<RealType>& v);
+
+    SimInfo* info_;
+    ForceManager* forceMan_;
+    int nForceEvaluations_;
+
+    int nFlucQ_;                   /**< global number of fluctuating charges */
+    int nGroups_;                  /**< number of charge constraints */
+    std::vector<Atom*> localAtoms_;
+    std::vector<int> atomToFQ_;    /**< global atom index -> charge index */
+    std::vector<int> group_;       /**< constraint for each charge */
+    std::vector<int> groupSize_;
+    std::vector<RealType> charge_; /**< replicated charges */
+    std::vector<RealType> curvature_; /**< d^2 Vself / dq^2 */
+    std::map<int, DoublePolynomial> selfCurvature_; /**< by atom type */
+    bool setup_;
+
+    // pair couplings for the current configuration (local pairs only
+    // in parallel):
+    std::vector<int> pairI_;
+    std::vector<int> pairJ_;
+    std::vector<RealType> pairK_;
+
+#ifdef IS_MPI
+    std::vector<int> counts_;
+    std::vector<int> displacements_;
+#endif
+  };
+}
+#endif
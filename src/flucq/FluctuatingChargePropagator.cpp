@@ -47,6 +47,7 @@
 #include "optimization/EndCriteria.hpp"
 #include "optimization/StatusFunction.hpp"
 #include "optimization/OptimizationFactory.hpp"
+#include "utils/simError.h"
 
 #ifdef IS_MPI
 #include <mpi.h>
@@ -56,17 +57,23 @@ using namespace QuantLib;
 namespace OpenMD {
 
   FluctuatingChargePropagator::FluctuatingChargePropagator(SimInfo* info) : 
-    info_(info), forceMan_(NULL), hasFlucQ_(false), initialized_(false) {
+    fqConstraints_(NULL), equilibrator_(NULL), info_(info), forceMan_(NULL),
+    hasFlucQ_(false), initialized_(false) {
     
     Globals* simParams = info_->getSimParams();
     fqParams_ = simParams->getFluctuatingChargeParameters();    
   }
 
   FluctuatingChargePropagator::~FluctuatingChargePropagator() {
+    delete equilibrator_;
   }
 
   void FluctuatingChargePropagator::setForceManager(ForceManager* forceMan) {
     forceMan_ = forceMan;
+    if (equilibrator_ != NULL) {
+      delete equilibrator_;
+      equilibrator_ = new FluctuatingChargeEquilibrator(info_, forceMan_);
+    }
   }
 
   void FluctuatingChargePropagator::initialize() {
@@ -75,6 +82,7 @@ namespace OpenMD {
         hasFlucQ_ = true;
 	fqConstraints_ = new FluctuatingChargeConstraints(info_);
 	fqConstraints_->setConstrainRegions(fqParams_->getConstrainRegions());
+        equilibrator_ = new FluctuatingChargeEquilibrator(info_, forceMan_);
       }
     }
     
@@ -102,26 +110,42 @@ namespace OpenMD {
 
 
     if (fqParams_->getDoInitialOptimization()) {
-    
-      FluctuatingChargeObjectiveFunction flucQobjf(info_, forceMan_, 
-                                                   fqConstraints_);
-      
-      DynamicVector<RealType> initCoords = flucQobjf.setInitialCoords();
+
+      int maxIter = fqParams_->getMaxIterations();
+      RealType tolerance = fqParams_->getTolerance();
+
+      // Solve for the equilibrium charges directly, and only fall
+      // back on the general-purpose minimizer if that fails (e.g. for
+      // self potentials with more than one minimum):
+
+      if (!equilibrator_->equilibrate(tolerance, maxIter)) {
+
+        sprintf(painCave.errMsg,
+                "FluctuatingChargePropagator: The direct equilibration of the\n"
+                "\tfluctuating charges did not converge in %d steps, so the\n"
+                "\tcharges will be optimized with steepest descent.\n",
+                maxIter);
+        painCave.severity = OPENMD_INFO;
+        painCave.isFatal = 0;
+        simError();
+
+        FluctuatingChargeObjectiveFunction flucQobjf(info_, forceMan_, 
+                                                     fqConstraints_);
       
-      Problem problem(flucQobjf, *(new NoConstraint()), *(new NoStatus()), 
-                      initCoords);
+        DynamicVector<RealType> initCoords = flucQobjf.setInitialCoords();
       
+        Problem problem(flucQobjf, *(new NoConstraint()), *(new NoStatus()), 
+                        initCoords);
       
-      int maxIter = fqParams_->getMaxIterations();
-      RealType tolerance = fqParams_->getTolerance();
-      RealType initialStepSize = fqParams_->getInitialStepSize();
+        RealType initialStepSize = fqParams_->getInitialStepSize();
       
-      EndCriteria endCriteria(maxIter, maxIter, tolerance, tolerance,
-                              tolerance);
+        EndCriteria endCriteria(maxIter, maxIter, tolerance, tolerance,
+                                tolerance);
       
-      OptimizationMethod* minim = OptimizationFactory::getInstance()->createOptimization("SD", info_);
+        OptimizationMethod* minim = OptimizationFactory::getInstance()->createOptimization("SD", info_);
       
-      minim->minimize(problem, endCriteria, initialStepSize);
+        minim->minimize(problem, endCriteria, initialStepSize);
+      }
     }
     
     initialized_ = true;
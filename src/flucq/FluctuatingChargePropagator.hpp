@@ -47,6 +47,7 @@
 #include "brains/ForceManager.hpp"
 #include "brains/Thermo.hpp"
 #include "flucq/FluctuatingChargeConstraints.hpp"
+#include "flucq/FluctuatingChargeEquilibrator.hpp"
 
 namespace OpenMD {
 
@@ -72,6 +73,7 @@ namespace OpenMD {
   protected:
     FluctuatingChargeParameters* fqParams_;
     FluctuatingChargeConstraints* fqConstraints_;
+    FluctuatingChargeEquilibrator* equilibrator_;
     SimInfo* info_;
     ForceManager* forceMan_;
     bool hasFlucQ_;
@@ -49,6 +49,7 @@
 #include "integrators/DLM.hpp"
 #include "flucq/FluctuatingChargeDamped.hpp"
 #include "flucq/FluctuatingChargeLangevin.hpp"
+#include "flucq/FluctuatingChargeMinimizer.hpp"
 #include "flucq/FluctuatingChargeNVE.hpp"
 #include "flucq/FluctuatingChargeNVT.hpp"
 #include "utils/simError.h"
@@ -56,10 +57,12 @@
 namespace OpenMD {
   Integrator::Integrator(SimInfo* info) 
     : info_(info), forceMan_(NULL), rotAlgo_(NULL), flucQ_(NULL), 
-      rattle_(NULL), velocitizer_(NULL), rnemd_(NULL), 
+      rattle_(NULL), velocitizer_(NULL), rnemd_(NULL),
+      greenKubo_(NULL), 
       needPotential(false), needVirial(false), 
       needReset(false),  needVelocityScaling(false), 
-      useRNEMD(false), dumpWriter(NULL), statWriter(NULL), thermo(info_),
+      useRNEMD(false), dumpWriter(NULL), statWriter(NULL),
+      asyncOutput_(NULL), thermo(info_),
       snap(info_->getSnapshotManager()->getCurrentSnapshot()) {
     
     simParams = info->getSimParams();
@@ -154,6 +157,11 @@ namespace OpenMD {
       }
     }
     
+    if (simParams->getAccumulateStressCorrelation() ||
+        simParams->getAccumulateCurrentCorrelation()) {
+      greenKubo_ = new GreenKubo(info);
+    }
+
     rotAlgo_ = new DLM();
     rattle_ = new Rattle(info);
     
@@ -167,6 +175,8 @@ namespace OpenMD {
         flucQ_ = new FluctuatingChargeLangevin(info);
       } else if (prop.compare("DAMPED")==0){
         flucQ_ = new FluctuatingChargeDamped(info);         
+      } else if (prop.compare("MINIMIZER")==0){
+        flucQ_ = new FluctuatingChargeMinimizer(info);
       } else {
         sprintf(painCave.errMsg,
                 "Integrator Error: Unknown Fluctuating Charge propagator (%s) requested\n",
@@ -181,11 +191,13 @@ namespace OpenMD {
     delete forceMan_;
     delete velocitizer_;
     delete rnemd_;
+    delete greenKubo_;
     delete flucQ_;
     delete rotAlgo_;
     delete rattle_;    
     delete dumpWriter;
     delete statWriter;
+    delete asyncOutput_;
   }
 
 
@@ -258,6 +270,14 @@ namespace OpenMD {
   
   
   void Integrator::initialize(){
+
+    // Only the constraint algorithm looks back at the previous
+    // snapshot (for the positions at the start of a step), so the
+    // rest of the per-object data isn't copied there on every step:
+    int history = 0;
+    if (info_->getNGlobalConstraints() > 0)
+      history |= DataStorage::dslPosition;
+    info_->getSnapshotManager()->setHistoryLayout(history);
     
     forceMan_->initialize();
     
@@ -287,6 +307,13 @@ namespace OpenMD {
     
     dumpWriter = createDumpWriter();    
     statWriter = createStatWriter(); 
+
+    if (simParams->getAsyncOutput()) {
+      asyncOutput_ = new AsyncOutput();
+      dumpWriter->setAsyncOutput(asyncOutput_);
+      statWriter->setAsyncOutput(asyncOutput_);
+    }
+
     dumpWriter->writeDumpAndEor();
 
     progressBar = new ProgressBar();
@@ -309,6 +336,10 @@ namespace OpenMD {
     if (simParams->getRNEMDParameters()->getUseRNEMD()){
       currRNEMD = RNEMD_exchangeTime + snap->getTime();
     }
+    if (greenKubo_ != NULL) {
+      greenKubo_->collectData();
+      currCorrelation = greenKubo_->getSampleTime() + snap->getTime();
+    }
     needPotential = false;
     needVirial = false;       
     
@@ -354,6 +385,15 @@ namespace OpenMD {
       rnemd_->collectData();
     }
 
+    if (greenKubo_ != NULL) {
+      difference = snap->getTime() - currCorrelation;
+
+      if (difference > 0 || fabs(difference) <= OpenMD::epsilon) {
+        greenKubo_->collectData();
+        currCorrelation += greenKubo_->getSampleTime();
+      }
+    }
+
     difference = snap->getTime() - currSample;
   
     if (difference > 0 || fabs(difference) <= OpenMD::epsilon) {
@@ -369,6 +409,9 @@ namespace OpenMD {
       if (simParams->getRNEMDParameters()->getUseRNEMD()) {
 	rnemd_->writeOutputFile();
       }
+      if (greenKubo_ != NULL) {
+        greenKubo_->writeOutputFile();
+      }
 
       statWriter->writeStat();
 
@@ -400,6 +443,9 @@ namespace OpenMD {
     if (simParams->getRNEMDParameters()->getUseRNEMD()) {
       rnemd_->writeOutputFile();
     }
+    if (greenKubo_ != NULL) {
+      greenKubo_->writeOutputFile();
+    }
     progressBar->setStatus(runTime, runTime);
     progressBar->update();
 
@@ -407,9 +453,14 @@ namespace OpenMD {
  
     delete dumpWriter;
     delete statWriter;
+    delete asyncOutput_;
+
+    SnapshotManager* sman = info_->getSnapshotManager();
+    sman->setHistoryLayout(sman->getStorageLayout());
   
     dumpWriter = NULL;
     statWriter = NULL;
+    asyncOutput_ = NULL;
   }
 
 
@@ -55,6 +55,7 @@
 #include "flucq/FluctuatingChargePropagator.hpp"
 #include "brains/Velocitizer.hpp"
 #include "rnemd/RNEMD.hpp"
+#include "brains/GreenKubo.hpp"
 #include "constraints/Rattle.hpp"
 #include "integrators/DLM.hpp"
 #include "utils/ProgressBar.hpp"
@@ -115,6 +116,7 @@ namespace OpenMD {
     RealType currThermal;
     RealType currReset;
     RealType currRNEMD;
+    RealType currCorrelation;
     
     SimInfo* info_;
     Globals* simParams;
@@ -124,6 +126,7 @@ namespace OpenMD {
     Rattle* rattle_;
     Velocitizer* velocitizer_;
     RNEMD* rnemd_;
+    GreenKubo* greenKubo_;
 
     bool needPotential;
     bool needVirial;
@@ -136,6 +139,7 @@ namespace OpenMD {
     Stats* stats;
     DumpWriter* dumpWriter;
     StatWriter* statWriter;
+    AsyncOutput* asyncOutput_;
     Thermo thermo;
 
     Snapshot* snap;
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2005 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#include "io/AsyncOutput.hpp"
+#include "utils/simError.h"
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <sys/time.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+using namespace std;
+namespace OpenMD {
+
+#ifdef HAVE_PTHREAD
+  struct AsyncOutput::ThreadState {
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t queued;       /**< signalled when a task is submitted */
+    pthread_cond_t finished;     /**< signalled when a task is done */
+  };
+#else
+  struct AsyncOutput::ThreadState {};
+#endif
+
+  AsyncOutput::AsyncOutput() : submitted_(0), completed_(0), stopping_(false),
+                               bytesWritten_(0), maxDepth_(0), nStalls_(0),
+                               stallTime_(0.0), thread_(NULL) {
+#ifdef HAVE_PTHREAD
+    thread_ = new ThreadState;
+    pthread_mutex_init(&thread_->mutex, NULL);
+    pthread_cond_init(&thread_->queued, NULL);
+    pthread_cond_init(&thread_->finished, NULL);
+
+    if (pthread_create(&thread_->thread, NULL, AsyncOutput::threadMain,
+                       this) != 0) {
+      sprintf(painCave.errMsg,
+              "AsyncOutput: could not start the output thread.\n"
+              "\tOutput will be written synchronously.\n");
+      painCave.isFatal = 0;
+      painCave.severity = OPENMD_WARNING;
+      simError();
+      pthread_mutex_destroy(&thread_->mutex);
+      pthread_cond_destroy(&thread_->queued);
+      pthread_cond_destroy(&thread_->finished);
+      delete thread_;
+      thread_ = NULL;
+    }
+#endif
+  }
+
+  AsyncOutput::~AsyncOutput() {
+#ifdef HAVE_PTHREAD
+    if (thread_ != NULL) {
+      pthread_mutex_lock(&thread_->mutex);
+      stopping_ = true;
+      pthread_cond_signal(&thread_->queued);
+      pthread_mutex_unlock(&thread_->mutex);
+
+      pthread_join(thread_->thread, NULL);
+
+      pthread_mutex_destroy(&thread_->mutex);
+      pthread_cond_destroy(&thread_->queued);
+      pthread_cond_destroy(&thread_->finished);
+      delete thread_;
+    }
+#endif
+  }
+
+  long long AsyncOutput::submit(OutputTask* task) {
+#ifdef HAVE_PTHREAD
+    if (thread_ != NULL) {
+      pthread_mutex_lock(&thread_->mutex);
+      queue_.push_back(task);
+      maxDepth_ = max(maxDepth_, int(queue_.size()));
+      long long ticket = ++submitted_;
+      pthread_cond_signal(&thread_->queued);
+      pthread_mutex_unlock(&thread_->mutex);
+      return ticket;
+    }
+#endif
+    // no output thread, so the task is run right away:
+    maxDepth_ = max(maxDepth_, 1);
+    bytesWritten_ += task->run();
+    delete task;
+    completed_ = ++submitted_;
+    return submitted_;
+  }
+
+  void AsyncOutput::wait(long long ticket) {
+#ifdef HAVE_PTHREAD
+    if (thread_ != NULL) {
+      pthread_mutex_lock(&thread_->mutex);
+      if (completed_ < ticket) {
+        RealType start = getWallTime();
+        while (completed_ < ticket)
+          pthread_cond_wait(&thread_->finished, &thread_->mutex);
+        stallTime_ += getWallTime() - start;
+        nStalls_++;
+      }
+      pthread_mutex_unlock(&thread_->mutex);
+    }
+#endif
+  }
+
+  void AsyncOutput::drain() {
+    wait(submitted_);
+  }
+
+  void* AsyncOutput::threadMain(void* arg) {
+    static_cast<AsyncOutput*>(arg)->processTasks();
+    return NULL;
+  }
+
+  void AsyncOutput::processTasks() {
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&thread_->mutex);
+    while (true) {
+      while (queue_.empty() && !stopping_)
+        pthread_cond_wait(&thread_->queued, &thread_->mutex);
+      if (queue_.empty()) break;
+
+      // the task stays at the front of the queue (and counts towards
+      // its depth) until it has been written:
+      OutputTask* task = queue_.front();
+      pthread_mutex_unlock(&thread_->mutex);
+
+      unsigned long long bytes = task->run();
+      delete task;
+
+      pthread_mutex_lock(&thread_->mutex);
+      queue_.pop_front();
+      bytesWritten_ += bytes;
+      completed_++;
+      pthread_cond_broadcast(&thread_->finished);
+    }
+    pthread_mutex_unlock(&thread_->mutex);
+#endif
+  }
+
+  RealType AsyncOutput::getWallTime() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return RealType(tv.tv_sec) + 1.0e-6 * RealType(tv.tv_usec);
+  }
+
+  std::string AsyncOutput::getReport() {
+    drain();
+
+    std::stringstream report;
+    std::string head(79, '#');
+
+    report << "# Output Thread:" << std::string(62, ' ') << "#" << std::endl;
+    report << "# " << right << setw(22) << "Output Tasks:";
+    report << setw(12) << completed_;
+    report << "                                          #" << std::endl;
+    report << "# " << right << setw(22) << "Bytes Written:";
+    report << setw(12) << bytesWritten_;
+    report << "                                          #" << std::endl;
+    report << "# " << right << setw(22) << "Maximum Queue Depth:";
+    report << setw(12) << maxDepth_;
+    report << "                                          #" << std::endl;
+    report << "# " << right << setw(22) << "Stalled Writes:";
+    report << setw(12) << nStalls_;
+    report << "                                          #" << std::endl;
+    report << "# " << right << setw(22) << "Stall Time:";
+    report << setw(12) << stallTime_;
+    report << " " << setw(17) << left << "s"
+           << "                        #" << std::endl;
+    report << head << std::endl;
+    return report.str();
+  }
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2005 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#ifndef IO_ASYNCOUTPUT_HPP
+#define IO_ASYNCOUTPUT_HPP
+
+#include "config.h"
+#include <deque>
+#include <string>
+
+namespace OpenMD {
+
+  /**
+   * @class OutputTask AsyncOutput.hpp "io/AsyncOutput.hpp"
+   * A unit of output work (formatting, compressing and writing) that
+   * can be handed to the output thread.
+   */
+  class OutputTask {
+  public:
+    virtual ~OutputTask() {}
+    /** Does the work and returns the number of bytes written. */
+    virtual unsigned long long run() = 0;
+  };
+
+  /**
+   * @class AsyncOutput AsyncOutput.hpp "io/AsyncOutput.hpp"
+   * A background thread that runs output tasks in the order in which
+   * they were submitted, so that the integrator doesn't stall while
+   * frames are formatted, compressed and flushed to disk.
+   *
+   * Writers stage whatever data a task needs before submitting it and
+   * use the returned ticket to wait until the task is done before they
+   * reuse the staging area.  Only those waits stall the integrator, and
+   * the time spent in them is reported in getReport().  If OpenMD was
+   * built without POSIX threads, tasks are run as soon as they are
+   * submitted.
+   */
+  class AsyncOutput {
+  public:
+    AsyncOutput();
+    /** Finishes the queued tasks and stops the output thread. */
+    ~AsyncOutput();
+
+    /**
+     * Queues a task for the output thread, which takes ownership of
+     * it.  Returns a ticket that can be passed to wait().
+     */
+    long long submit(OutputTask* task);
+    /** Waits until the task with the given ticket has been run. */
+    void wait(long long ticket);
+    /** Waits until every queued task has been run. */
+    void drain();
+
+    /** A summary of the output thread's work in the status report style. */
+    std::string getReport();
+
+  private:
+    static void* threadMain(void* arg);
+    void processTasks();
+    RealType getWallTime();
+
+    std::deque<OutputTask*> queue_;
+    long long submitted_;
+    long long completed_;
+    bool stopping_;
+
+    unsigned long long bytesWritten_;
+    int maxDepth_;               /**< largest number of queued tasks */
+    int nStalls_;                /**< waits that actually blocked */
+    RealType stallTime_;         /**< wall time spent in those waits */
+
+    // the pthread state lives in AsyncOutput.cpp:
+    struct ThreadState;
+    ThreadState* thread_;
+  };
+}
+#endif
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2009 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *                                                                      
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).             
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).          
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).          
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#ifndef IO_BINARYDUMP_HPP
+#define IO_BINARYDUMP_HPP
+
+#include <cstring>
+#include <string>
+#include "config.h"
+#include "brains/DataStorage.hpp"
+
+namespace OpenMD {
+
+  /**
+   * @namespace BinaryDump
+   * Layout of the binary trajectory format written by DumpWriter when
+   * dumpFileFormat = "BINARY" and read transparently by DumpReader.
+   *
+   * The file starts with the same text header as a text dump (with
+   * format=binary on the opening tag) so that SimCreator can parse
+   * the MetaData block unchanged.  Every frame that follows is:
+   *
+   *   char[4]  "OMDF"
+   *   int32    byte order marker (0x01020304)
+   *   uint32   StuntDouble field mask (DataStorage layout bits)
+   *   uint32   site field mask (DataStorage layout bits)
+   *   int32    number of StuntDouble records
+   *   int32    number of site records
+   *   double   position precision (0 = positions stored as doubles)
+   *   double   time, Hmat(9), thermostat(2), barostat(9)
+   *   uint64   total size of the frame in bytes
+   *
+   * followed by fixed-width StuntDouble records (int32 index, then the
+   * fields in the mask in the order p v q j f t), and fixed-width site
+   * records (int32 index, int32 site index or -1 for the object
+   * itself, then the fields in the order c w g e s u d).  Fields that
+   * do not apply to an object (e.g. the quaternion of an atom) are
+   * zero-filled so every record in a frame has the same width.
+   *
+   * When the file is closed, a frame index is appended:
+   *
+   *   (int64 offset, double time) for every frame
+   *   int64    number of frames
+   *   int64    offset of the start of the index
+   *   char[8]  "OMDINDEX"
+   *
+   * so that readers can locate any frame without scanning the file.
+   * Truncated files (no index) are still readable by walking the
+   * frame sizes.
+   */
+  namespace BinaryDump {
+
+    const char frameMagic[] = "OMDF";
+    const char indexMagic[] = "OMDINDEX";
+    const int byteOrderMarker = 0x01020304;
+
+    /** Size of the fixed part of every frame. */
+    const int frameHeaderSize = 4 + 4 + 4 + 4 + 4 + 4 + 8 + 8 * 21 + 8;
+    /** Size of the index trailer (frame count, index offset, magic). */
+    const int indexTrailerSize = 8 + 8 + 8;
+
+    const unsigned int sdFields = DataStorage::dslPosition |
+      DataStorage::dslVelocity | DataStorage::dslAmat |
+      DataStorage::dslAngularMomentum | DataStorage::dslForce |
+      DataStorage::dslTorque;
+
+    const unsigned int siteFields = DataStorage::dslFlucQPosition |
+      DataStorage::dslFlucQVelocity | DataStorage::dslFlucQForce |
+      DataStorage::dslElectricField | DataStorage::dslSitePotential |
+      DataStorage::dslParticlePot | DataStorage::dslDensity;
+
+    inline int sdRecordSize(unsigned int mask, bool quantized) {
+      int size = 4;
+      if (mask & DataStorage::dslPosition) size += quantized ? 12 : 24;
+      if (mask & DataStorage::dslVelocity) size += 24;
+      if (mask & DataStorage::dslAmat) size += 32;
+      if (mask & DataStorage::dslAngularMomentum) size += 24;
+      if (mask & DataStorage::dslForce) size += 24;
+      if (mask & DataStorage::dslTorque) size += 24;
+      return size;
+    }
+
+    inline int siteRecordSize(unsigned int mask) {
+      int size = 8;
+      if (mask & DataStorage::dslFlucQPosition) size += 8;
+      if (mask & DataStorage::dslFlucQVelocity) size += 8;
+      if (mask & DataStorage::dslFlucQForce) size += 8;
+      if (mask & DataStorage::dslElectricField) size += 24;
+      if (mask & DataStorage::dslSitePotential) size += 8;
+      if (mask & DataStorage::dslParticlePot) size += 8;
+      if (mask & DataStorage::dslDensity) size += 8;
+      return size;
+    }
+
+    template<typename T>
+    inline void put(std::string& buf, T value) {
+      buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    inline T get(const char*& p) {
+      T value;
+      memcpy(&value, p, sizeof(T));
+      p += sizeof(T);
+      return value;
+    }
+  }
+}
+
+#endif
@@ -63,13 +63,18 @@
 #include "utils/MemoryUtils.hpp" 
 #include "utils/StringTokenizer.hpp" 
 #include "brains/Thermo.hpp"
+#include "io/BinaryDump.hpp"
  
  
 namespace OpenMD { 
    
   DumpReader::DumpReader(SimInfo* info, const std::string& filename) 
-    : info_(info), filename_(filename), isScanned_(false), nframes_(0),
-      needCOMprops_(false) { 
+    : info_(info), filename_(filename), isScanned_(false), binary_(false),
+      gzipped_(false), dataSize_(0), nframes_(0), needCOMprops_(false) { 
+
+#ifdef HAVE_LIBZ
+    gzIndex_ = NULL;
+#endif
     
 #ifdef IS_MPI     
     if (worldRank == 0) { 
@@ -85,9 +90,34 @@ namespace OpenMD {
 	painCave.isFatal = 1; 
 	simError(); 
       } 
+
+      // gzip files start with 0x1f 0x8b, and binary dumps announce
+      // themselves on the opening tag:
+      inFile_->getline(buffer, bufferSize);
+      std::string line = buffer;
+      if (line.size() >= 2 && (unsigned char)line[0] == 0x1f &&
+          (unsigned char)line[1] == 0x8b) {
+        gzipped_ = true;
+#ifdef HAVE_LIBZ
+        gzIndex_ = new GzIndex(filename_);
+#else
+        sprintf(painCave.errMsg, 
+                "DumpReader: %s is compressed, but OpenMD was built\n"
+                "\twithout zlib support.\n", filename_.c_str()); 
+        painCave.isFatal = 1; 
+        simError(); 
+#endif
+      } else {
+        binary_ = (line.find("format=binary") != std::string::npos);
+      }
+      inFile_->clear();
+      inFile_->seekg(0);
       
 #ifdef IS_MPI       
     }     
+    int isBinary = binary_;
+    MPI_Bcast(&isBinary, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    binary_ = isBinary;
     strcpy(checkPointMsg, "Dump file opened for reading successfully."); 
     errorCheckPoint();     
 #endif 
@@ -102,6 +132,9 @@ namespace OpenMD {
 #endif
 
       delete inFile_; 
+#ifdef HAVE_LIBZ
+      delete gzIndex_;
+#endif
       
 #ifdef IS_MPI       
     }     
@@ -122,66 +155,21 @@ namespace OpenMD {
    
   void DumpReader::scanFile(void) { 
 
-    std::streampos prevPos;
-    std::streampos  currPos; 
-    
+    if (binary_) {
+      scanBinaryFile();
+      return;
+    }
+
 #ifdef IS_MPI     
     if (worldRank == 0) { 
 #endif // is_mpi 
-      
-      currPos = inFile_->tellg();
-      prevPos = currPos;
-      bool foundOpenSnapshotTag = false;
-      bool foundClosedSnapshotTag = false;
 
-      int lineNo = 0; 
-      while(inFile_->getline(buffer, bufferSize)) {
-        ++lineNo;
-        
-        std::string line = buffer;
-        currPos = inFile_->tellg(); 
-        if (line.find("<Snapshot>")!= std::string::npos) {
-          if (foundOpenSnapshotTag) {
-            sprintf(painCave.errMsg, 
-                    "DumpReader:<Snapshot> is multiply nested at line %d "
-                    "in %s \n", lineNo, filename_.c_str()); 
-            painCave.isFatal = 1; 
-            simError();           
-          }
-          foundOpenSnapshotTag = true;
-          foundClosedSnapshotTag = false;
-          framePos_.push_back(prevPos);
-          
-        } else if (line.find("</Snapshot>") != std::string::npos){
-          if (!foundOpenSnapshotTag) {
-            sprintf(painCave.errMsg, 
-                    "DumpReader:</Snapshot> appears before <Snapshot> at "
-                    "line %d in %s \n", lineNo, filename_.c_str()); 
-            painCave.isFatal = 1; 
-            simError(); 
-          }
-          
-          if (foundClosedSnapshotTag) {
-            sprintf(painCave.errMsg, 
-                    "DumpReader:</Snapshot> appears multiply nested at "
-                    "line %d in %s \n", lineNo, filename_.c_str()); 
-            painCave.isFatal = 1; 
-            simError(); 
-          }
-          foundClosedSnapshotTag = true;
-          foundOpenSnapshotTag = false;
-        }
-        prevPos = currPos;
-      }
-      
-      // only found <Snapshot> for the last frame means the file is
-      // corrupted, we should discard it and give a warning message
-      if (foundOpenSnapshotTag) {
-        sprintf(painCave.errMsg, 
-                "DumpReader: last frame in %s is invalid\n", filename_.c_str());
-        painCave.isFatal = 0; 
-        simError();       
-        framePos_.pop_back();
+      // Reuse the frame index from an earlier scan if the file hasn't
+      // changed since then.  Single-frame (.omd, .eor) files are cheap
+      // to scan and don't get an index:
+      if (!loadIndex()) {
+        scanText();
+        if (framePos_.size() > 1) saveIndex();
       }
       
       nframes_ = framePos_.size(); 
@@ -201,6 +189,232 @@ namespace OpenMD {
     
     isScanned_ = true; 
   } 
+
+  bool DumpReader::readChunk(std::string& chunk) {
+#ifdef HAVE_LIBZ
+    if (gzipped_) {
+      bool more = gzIndex_->scanNext(chunk);
+      if (!more && gzIndex_->hasError()) {
+        sprintf(painCave.errMsg, 
+                "DumpReader: the compressed data in %s ends early\n",
+                filename_.c_str()); 
+        painCave.isFatal = 0; 
+        simError();
+      }
+      return more;
+    }
+#endif
+    const int chunkSize = 1048576;
+    chunk.resize(chunkSize);
+    inFile_->read(&chunk[0], chunkSize);
+    chunk.resize(inFile_->gcount());
+    return !chunk.empty();
+  }
+
+  void DumpReader::scanText(void) { 
+
+    framePos_.clear();
+    frameTimes_.clear();
+
+#ifdef HAVE_LIBZ
+    if (gzipped_ && !gzIndex_->beginScan()) {
+      sprintf(painCave.errMsg, 
+              "DumpReader: Cannot open file: %s\n", filename_.c_str()); 
+      painCave.isFatal = 1; 
+      simError(); 
+    }
+#endif
+    inFile_->clear();
+    inFile_->seekg(0);
+
+    bool foundOpenSnapshotTag = false;
+    bool foundClosedSnapshotTag = false;
+    bool needTime = false;
+
+    std::string chunk;
+    std::string line;
+    long long chunkStart = 0;
+    long long lineStart = 0;
+    int lineNo = 0; 
+    bool more = true;
+
+    while (more) {
+      more = readChunk(chunk);
+      std::size_t pos = 0;
+      std::size_t eol = 0;
+
+      while (pos < chunk.size() || (!more && !line.empty())) {
+        if (more) {
+          eol = chunk.find('\n', pos);
+          if (eol == std::string::npos) {
+            line.append(chunk, pos, std::string::npos);
+            break;
+          }
+          line.append(chunk, pos, eol - pos);
+        }
+        ++lineNo;
+
+        if (line.find('<') != std::string::npos) {
+          if (line.find("<Snapshot>")!= std::string::npos) {
+            if (foundOpenSnapshotTag) {
+              sprintf(painCave.errMsg, 
+                      "DumpReader:<Snapshot> is multiply nested at line %d "
+                      "in %s \n", lineNo, filename_.c_str()); 
+              painCave.isFatal = 1; 
+              simError();           
+            }
+            foundOpenSnapshotTag = true;
+            foundClosedSnapshotTag = false;
+            framePos_.push_back(lineStart);
+            frameTimes_.push_back(0.0);
+            needTime = true;
+            
+          } else if (line.find("</Snapshot>") != std::string::npos){
+            if (!foundOpenSnapshotTag) {
+              sprintf(painCave.errMsg, 
+                      "DumpReader:</Snapshot> appears before <Snapshot> at "
+                      "line %d in %s \n", lineNo, filename_.c_str()); 
+              painCave.isFatal = 1; 
+              simError(); 
+            }
+            
+            if (foundClosedSnapshotTag) {
+              sprintf(painCave.errMsg, 
+                      "DumpReader:</Snapshot> appears multiply nested at "
+                      "line %d in %s \n", lineNo, filename_.c_str()); 
+              painCave.isFatal = 1; 
+              simError(); 
+            }
+            foundClosedSnapshotTag = true;
+            foundOpenSnapshotTag = false;
+          }
+        } else if (needTime) {
+          std::size_t t = line.find("Time:");
+          if (t != std::string::npos) {
+            frameTimes_.back() = atof(line.c_str() + t + 5);
+            needTime = false;
+          }
+        }
+
+        line.clear();
+        if (!more) break;
+        pos = eol + 1;
+        lineStart = chunkStart + pos;
+      }
+      chunkStart += chunk.size();
+    }
+    dataSize_ = chunkStart;
+      
+    // only found <Snapshot> for the last frame means the file is
+    // corrupted, we should discard it and give a warning message
+    if (foundOpenSnapshotTag) {
+      sprintf(painCave.errMsg, 
+              "DumpReader: last frame in %s is invalid\n", filename_.c_str());
+      painCave.isFatal = 0; 
+      simError();       
+      framePos_.pop_back();
+      frameTimes_.pop_back();
+    }
+  }
+
+  /**
+   * The index sidecar (filename.idx) holds the size and modification
+   * time of the dump file it describes, the offset and time of every
+   * frame, and for compressed files the inflate access points.
+   */
+  static const char indexMagic[] = "OpenMD frame index 1\n";
+
+  bool DumpReader::loadIndex() {
+    struct stat status;
+    if (stat(filename_.c_str(), &status) != 0) return false;
+
+    std::ifstream idx((filename_ + ".idx").c_str(),
+                      ifstream::in | ifstream::binary);
+    if (!idx) return false;
+
+    char magic[sizeof(indexMagic)];
+    idx.read(magic, sizeof(indexMagic));
+    long long fileSize, fileTime, nFrames;
+    int compressed;
+    idx.read(reinterpret_cast<char*>(&fileSize), sizeof(fileSize));
+    idx.read(reinterpret_cast<char*>(&fileTime), sizeof(fileTime));
+    idx.read(reinterpret_cast<char*>(&compressed), sizeof(compressed));
+    idx.read(reinterpret_cast<char*>(&dataSize_), sizeof(dataSize_));
+    idx.read(reinterpret_cast<char*>(&nFrames), sizeof(nFrames));
+
+    if (!idx.good() || memcmp(magic, indexMagic, sizeof(indexMagic)) != 0 ||
+        fileSize != (long long) status.st_size ||
+        fileTime != (long long) status.st_mtime ||
+        compressed != int(gzipped_) || nFrames < 0) {
+      return false;
+    }
+
+    std::vector<long long> offsets(nFrames);
+    std::vector<double> times(nFrames);
+    for (long long i = 0; i < nFrames; i++) {
+      idx.read(reinterpret_cast<char*>(&offsets[i]), sizeof(long long));
+      idx.read(reinterpret_cast<char*>(&times[i]), sizeof(double));
+    }
+    if (!idx.good()) return false;
+
+#ifdef HAVE_LIBZ
+    if (gzipped_ && !gzIndex_->read(idx)) return false;
+#endif
+
+    framePos_.assign(offsets.begin(), offsets.end());
+    frameTimes_.assign(times.begin(), times.end());
+    return true;
+  }
+
+  void DumpReader::saveIndex() {
+    struct stat status;
+    if (stat(filename_.c_str(), &status) != 0) return;
+
+    // the trajectory may live in a read-only location, in which case
+    // we just do without the index:
+    std::ofstream idx((filename_ + ".idx").c_str(),
+                      ofstream::out | ofstream::binary);
+    if (!idx) return;
+
+    long long fileSize = status.st_size;
+    long long fileTime = status.st_mtime;
+    long long nFrames = framePos_.size();
+    int compressed = gzipped_;
+
+    idx.write(indexMagic, sizeof(indexMagic));
+    idx.write(reinterpret_cast<char*>(&fileSize), sizeof(fileSize));
+    idx.write(reinterpret_cast<char*>(&fileTime), sizeof(fileTime));
+    idx.write(reinterpret_cast<char*>(&compressed), sizeof(compressed));
+    idx.write(reinterpret_cast<char*>(&dataSize_), sizeof(dataSize_));
+    idx.write(reinterpret_cast<char*>(&nFrames), sizeof(nFrames));
+    for (long long i = 0; i < nFrames; i++) {
+      long long offset = framePos_[i];
+      double time = frameTimes_[i];
+      idx.write(reinterpret_cast<char*>(&offset), sizeof(offset));
+      idx.write(reinterpret_cast<char*>(&time), sizeof(time));
+    }
+#ifdef HAVE_LIBZ
+    if (gzipped_) gzIndex_->write(idx);
+#endif
+  }
+
+  std::string DumpReader::readCompressedFrame(int whichFrame) {
+    std::string frame;
+#ifdef HAVE_LIBZ
+    long long start = framePos_[whichFrame];
+    long long end = (whichFrame + 1 < int(framePos_.size())) ?
+      (long long) framePos_[whichFrame + 1] : dataSize_;
+
+    if (!gzIndex_->extract(start, end - start, frame)) {
+      sprintf(painCave.errMsg, 
+              "DumpReader Error: could not decompress frame %d of %s\n",
+              whichFrame, filename_.c_str()); 
+      painCave.isFatal = 1; 
+      simError(); 
+    }
+#endif
+    return frame;
+  }
    
   void DumpReader::readFrame(int whichFrame) { 
     if (!isScanned_) 
@@ -254,11 +468,22 @@ namespace OpenMD {
   void DumpReader::readSet(int whichFrame) {     
     std::string line;
 
+    if (binary_) {
+      readBinarySet(whichFrame);
+      return;
+    }
+
 #ifndef IS_MPI 
-    inFile_->clear();  
-    inFile_->seekg(framePos_[whichFrame]); 
+    std::istringstream compressedFrame;
+    if (gzipped_) {
+      compressedFrame.str(readCompressedFrame(whichFrame));
+    } else {
+      inFile_->clear();  
+      inFile_->seekg(framePos_[whichFrame]); 
+    }
 
-    std::istream& inputStream = *inFile_;     
+    std::istream& inputStream = gzipped_ ?
+      static_cast<std::istream&>(compressedFrame) : *inFile_;
 #else
     
     int primaryNode = 0;
@@ -266,17 +491,21 @@ namespace OpenMD {
     if (worldRank == primaryNode) {
       std::string sendBuffer;
 
-      inFile_->clear();  
-      inFile_->seekg(framePos_[whichFrame]); 
+      if (gzipped_) {
+        sendBuffer = readCompressedFrame(whichFrame);
+      } else {
+        inFile_->clear();  
+        inFile_->seekg(framePos_[whichFrame]); 
       
-      while (inFile_->getline(buffer, bufferSize)) {
+        while (inFile_->getline(buffer, bufferSize)) {
 
-        line = buffer;
-        sendBuffer += line;
-        sendBuffer += '\n';
-        if (line.find("</Snapshot>") != std::string::npos) {
-          break;
-        }        
+          line = buffer;
+          sendBuffer += line;
+          sendBuffer += '\n';
+          if (line.find("</Snapshot>") != std::string::npos) {
+            break;
+          }        
+        }
       }
 
       int sendBufferSize = sendBuffer.size();
@@ -807,4 +1036,344 @@ namespace OpenMD {
       } 
     }
   }   
-}//end namespace OpenMD 
+
+  void DumpReader::scanBinaryFile(void) {
+
+#ifdef IS_MPI
+    if (worldRank == 0) {
+#endif // is_mpi
+
+      // skip the text header:
+      inFile_->clear();
+      inFile_->seekg(0);
+      bool foundMetaDataEnd = false;
+      while (inFile_->getline(buffer, bufferSize)) {
+        std::string line = buffer;
+        if (line.find("</MetaData>") != std::string::npos) {
+          foundMetaDataEnd = true;
+          break;
+        }
+      }
+      if (!foundMetaDataEnd) {
+        sprintf(painCave.errMsg,
+                "DumpReader: %s has no closed MetaData block\n",
+                filename_.c_str());
+        painCave.isFatal = 1;
+        simError();
+      }
+      long long dataStart = (long long) inFile_->tellg();
+
+      inFile_->clear();
+      inFile_->seekg(0, std::ios::end);
+      long long fileSize = (long long) inFile_->tellg();
+
+      // If the writer closed the file normally, the frame index is at
+      // the end and no scanning is required:
+      bool haveIndex = false;
+      if (fileSize - dataStart >= BinaryDump::indexTrailerSize) {
+        char trailer[BinaryDump::indexTrailerSize];
+        inFile_->seekg(fileSize - BinaryDump::indexTrailerSize);
+        inFile_->read(trailer, BinaryDump::indexTrailerSize);
+        const char* p = trailer;
+        long long nFrames = BinaryDump::get<long long>(p);
+        long long indexStart = BinaryDump::get<long long>(p);
+
+        if (inFile_->good() && strncmp(p, BinaryDump::indexMagic, 8) == 0 &&
+            nFrames >= 0 && indexStart >= dataStart &&
+            indexStart + nFrames * 16 + BinaryDump::indexTrailerSize ==
+            fileSize) {
+          std::vector<char> index(nFrames * 16 + 1);
+          inFile_->seekg(indexStart);
+          inFile_->read(&index[0], nFrames * 16);
+          p = &index[0];
+          for (long long i = 0; i < nFrames; i++) {
+            framePos_.push_back(BinaryDump::get<long long>(p));
+            BinaryDump::get<double>(p);
+          }
+          haveIndex = true;
+        }
+      }
+
+      if (!haveIndex) {
+        // The run did not finish (or the index is damaged), so walk
+        // the frames using the sizes stored in each frame header:
+        char header[BinaryDump::frameHeaderSize];
+        long long pos = dataStart;
+        while (pos + BinaryDump::frameHeaderSize <= fileSize) {
+          inFile_->clear();
+          inFile_->seekg(pos);
+          inFile_->read(header, BinaryDump::frameHeaderSize);
+          if (!inFile_->good() ||
+              strncmp(header, BinaryDump::frameMagic, 4) != 0)
+            break;
+          const char* p = header + BinaryDump::frameHeaderSize - 8;
+          long long frameBytes = (long long) BinaryDump::get<unsigned long long>(p);
+          if (frameBytes < BinaryDump::frameHeaderSize ||
+              pos + frameBytes > fileSize) {
+            sprintf(painCave.errMsg,
+                    "DumpReader: last frame in %s is invalid\n",
+                    filename_.c_str());
+            painCave.isFatal = 0;
+            simError();
+            break;
+          }
+          framePos_.push_back(pos);
+          pos += frameBytes;
+        }
+      }
+
+      nframes_ = framePos_.size();
+
+      if (nframes_ == 0) {
+        sprintf(painCave.errMsg,
+                "DumpReader: %s does not contain a valid frame\n",
+                filename_.c_str());
+        painCave.isFatal = 1;
+        simError();
+      }
+
+#ifdef IS_MPI
+    }
+    MPI_Bcast(&nframes_, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif // is_mpi
+
+    isScanned_ = true;
+  }
+
+  void DumpReader::readBinarySet(int whichFrame) {
+
+    std::vector<char> frame;
+    int frameSize = 0;
+
+#ifdef IS_MPI
+    int primaryNode = 0;
+    if (worldRank == primaryNode) {
+#endif
+      char header[BinaryDump::frameHeaderSize];
+      inFile_->clear();
+      inFile_->seekg(framePos_[whichFrame]);
+      inFile_->read(header, BinaryDump::frameHeaderSize);
+      const char* hp = header + BinaryDump::frameHeaderSize - 8;
+      frameSize = (int) BinaryDump::get<unsigned long long>(hp);
+
+      frame.resize(frameSize);
+      inFile_->seekg(framePos_[whichFrame]);
+      inFile_->read(&frame[0], frameSize);
+      if (!inFile_->good()) {
+        sprintf(painCave.errMsg,
+                "DumpReader Error: could not read frame %d of %s\n",
+                whichFrame, filename_.c_str());
+        painCave.isFatal = 1;
+        simError();
+      }
+#ifdef IS_MPI
+    }
+    MPI_Bcast(&frameSize, 1, MPI_INT, primaryNode, MPI_COMM_WORLD);
+    if (worldRank != primaryNode) frame.resize(frameSize);
+    MPI_Bcast(&frame[0], frameSize, MPI_CHAR, primaryNode, MPI_COMM_WORLD);
+#endif
+
+    const char* p = &frame[0];
+    if (strncmp(p, BinaryDump::frameMagic, 4) != 0) {
+      sprintf(painCave.errMsg,
+              "DumpReader Error: frame %d of %s is not a binary frame\n",
+              whichFrame, filename_.c_str());
+      painCave.isFatal = 1;
+      simError();
+    }
+    p += 4;
+
+    if (BinaryDump::get<int>(p) != BinaryDump::byteOrderMarker) {
+      sprintf(painCave.errMsg,
+              "DumpReader Error: %s was written on a machine with a\n"
+              "\tdifferent byte order.  Convert it to a text dump with\n"
+              "\tomd2omd on the original machine.\n", filename_.c_str());
+      painCave.isFatal = 1;
+      simError();
+    }
+
+    unsigned int sdMask = BinaryDump::get<unsigned int>(p);
+    unsigned int siteMask = BinaryDump::get<unsigned int>(p);
+    int nSD = BinaryDump::get<int>(p);
+    int nSites = BinaryDump::get<int>(p);
+    RealType precision = BinaryDump::get<double>(p);
+
+    Snapshot* s = info_->getSnapshotManager()->getCurrentSnapshot();
+    // We're about to overwrite all frame properties, so clear out any
+    // derived properties from previous use:
+    s->clearDerivedProperties();
+
+    s->setTime(BinaryDump::get<double>(p));
+    Mat3x3d hmat;
+    for (unsigned int i = 0; i < 3; i++)
+      for (unsigned int j = 0; j < 3; j++)
+        hmat(i, j) = BinaryDump::get<double>(p);
+    s->setHmat(hmat);
+    pair<RealType, RealType> thermostat;
+    thermostat.first = BinaryDump::get<double>(p);
+    thermostat.second = BinaryDump::get<double>(p);
+    s->setThermostat(thermostat);
+    Mat3x3d eta;
+    for (unsigned int i = 0; i < 3; i++)
+      for (unsigned int j = 0; j < 3; j++)
+        eta(i, j) = BinaryDump::get<double>(p);
+    s->setBarostat(eta);
+    BinaryDump::get<unsigned long long>(p);
+
+    if (needQuaternion_ && !(sdMask & DataStorage::dslAmat)) {
+      sprintf(painCave.errMsg,
+              "DumpReader Error: Directional StuntDoubles in %s have no\n"
+              "\tQuaternion Field.\n", filename_.c_str());
+      painCave.isFatal = 1;
+      simError();
+    }
+
+    bool quantized = precision > 0.0;
+    int sdRecordSize = BinaryDump::sdRecordSize(sdMask, quantized);
+    int siteRecordSize = BinaryDump::siteRecordSize(siteMask);
+
+    for (int i = 0; i < nSD; i++) {
+      parseBinaryRecord(p, sdMask, quantized, precision);
+      p += sdRecordSize;
+    }
+    for (int i = 0; i < nSites; i++) {
+      parseBinarySiteRecord(p, siteMask);
+      p += siteRecordSize;
+    }
+
+    if (nSD != info_->getNGlobalIntegrableObjects()) {
+      sprintf(painCave.errMsg,
+              "DumpReader Error: Number of parsed StuntDouble records (%d)\n"
+              "\tis not the same as the expected number of Objects (%d)\n",
+              nSD, info_->getNGlobalIntegrableObjects() );
+      painCave.isFatal = 1;
+      simError();
+    }
+  }
+
+  void DumpReader::parseBinaryRecord(const char* p, unsigned int mask,
+                                     bool quantized, RealType precision) {
+
+    int index = BinaryDump::get<int>(p);
+    StuntDouble* sd = info_->getIOIndexToIntegrableObject(index);
+    if (sd == NULL) {
+      return;
+    }
+
+    Vector3d pos;
+    if (quantized) {
+      for (unsigned int i = 0; i < 3; i++)
+        pos[i] = RealType(BinaryDump::get<int>(p)) * precision;
+    } else {
+      for (unsigned int i = 0; i < 3; i++)
+        pos[i] = BinaryDump::get<double>(p);
+    }
+    if (needPos_) sd->setPos(pos);
+
+    Vector3d vel;
+    for (unsigned int i = 0; i < 3; i++)
+      vel[i] = BinaryDump::get<double>(p);
+    if (needVel_) sd->setVel(vel);
+
+    if (mask & DataStorage::dslAmat) {
+      Quat4d q;
+      for (unsigned int i = 0; i < 4; i++)
+        q[i] = BinaryDump::get<double>(p);
+      if (sd->isDirectional()) {
+        if (q.length() < OpenMD::epsilon) {
+          sprintf(painCave.errMsg,
+                  "DumpReader Error: initial quaternion error "
+                  "(q0^2 + q1^2 + q2^2 + q3^2) ~ 0\n");
+          painCave.isFatal = 1;
+          simError();
+        }
+        q.normalize();
+        if (needQuaternion_) sd->setQ(q);
+      }
+    }
+
+    if (mask & DataStorage::dslAngularMomentum) {
+      Vector3d ji;
+      for (unsigned int i = 0; i < 3; i++)
+        ji[i] = BinaryDump::get<double>(p);
+      if (sd->isDirectional() && needAngMom_) sd->setJ(ji);
+    }
+
+    if (mask & DataStorage::dslForce) {
+      Vector3d force;
+      for (unsigned int i = 0; i < 3; i++)
+        force[i] = BinaryDump::get<double>(p);
+      sd->setFrc(force);
+    }
+
+    if (mask & DataStorage::dslTorque) {
+      Vector3d torque;
+      for (unsigned int i = 0; i < 3; i++)
+        torque[i] = BinaryDump::get<double>(p);
+      if (sd->isDirectional()) sd->setTrq(torque);
+    }
+
+    if (sd->isRigidBody()) {
+      RigidBody* rb = static_cast<RigidBody*>(sd);
+      if (needPos_) {
+        // This should let us use various atom-based selections even
+        // if we have only rigid bodies:
+        rb->updateAtoms();
+      }
+      if (needVel_) {
+        rb->updateAtomVel();
+      }
+    }
+  }
+
+  void DumpReader::parseBinarySiteRecord(const char* p, unsigned int mask) {
+
+    int index = BinaryDump::get<int>(p);
+    int siteIndex = BinaryDump::get<int>(p);
+
+    StuntDouble* sd = info_->getIOIndexToIntegrableObject(index);
+    if (sd == NULL) {
+      return;
+    }
+
+    if (siteIndex >= 0 && sd->isRigidBody()) {
+      RigidBody* rb = static_cast<RigidBody*>(sd);
+      // ignore sites inherited from other models:
+      if (siteIndex >= int(rb->getNumAtoms())) {
+        return;
+      }
+      sd = rb->getAtoms()[siteIndex];
+    }
+
+    bool isFlucQ = sd->isAtom() &&
+      dynamic_cast<Atom *>(sd)->isFluctuatingCharge();
+
+    if (mask & DataStorage::dslFlucQPosition) {
+      RealType flucQPos = BinaryDump::get<double>(p);
+      if (isFlucQ) sd->setFlucQPos(flucQPos);
+    }
+    if (mask & DataStorage::dslFlucQVelocity) {
+      RealType flucQVel = BinaryDump::get<double>(p);
+      if (isFlucQ) sd->setFlucQVel(flucQVel);
+    }
+    if (mask & DataStorage::dslFlucQForce) {
+      RealType flucQFrc = BinaryDump::get<double>(p);
+      if (isFlucQ) sd->setFlucQFrc(flucQFrc);
+    }
+    if (mask & DataStorage::dslElectricField) {
+      Vector3d eField;
+      for (unsigned int i = 0; i < 3; i++)
+        eField[i] = BinaryDump::get<double>(p);
+      sd->setElectricField(eField);
+    }
+    if (mask & DataStorage::dslSitePotential) {
+      sd->setSitePotential(BinaryDump::get<double>(p));
+    }
+    if (mask & DataStorage::dslParticlePot) {
+      sd->setParticlePot(BinaryDump::get<double>(p));
+    }
+    if (mask & DataStorage::dslDensity) {
+      sd->setDensity(BinaryDump::get<double>(p));
+    }
+  }
+}//end namespace OpenMD
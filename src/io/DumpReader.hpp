@@ -54,6 +54,9 @@
 #include <string> 
 #include "brains/SimInfo.hpp" 
 #include "primitives/StuntDouble.hpp" 
+#ifdef HAVE_LIBZ
+#include "io/GzIndex.hpp"
+#endif
 namespace OpenMD { 
  
   /** 
@@ -80,23 +83,42 @@ namespace OpenMD {
   protected: 
  
     void scanFile();  
+    void scanText();
+    bool readChunk(std::string& chunk);
+    bool loadIndex();
+    void saveIndex();
+    std::string readCompressedFrame(int whichFrame);
     void readSet(int whichFrame); 
     virtual void parseDumpLine(const std::string&); 
     virtual void parseSiteLine(const std::string&);  
     virtual void readFrameProperties(std::istream& inputStream);
     int readStuntDoubles(std::istream& inputStream);
     void readSiteData(std::istream& inputStream);
+
+    // binary trajectory format (see io/BinaryDump.hpp)
+    void scanBinaryFile();
+    void readBinarySet(int whichFrame);
+    void parseBinaryRecord(const char* p, unsigned int mask, bool quantized,
+                           RealType precision);
+    void parseBinarySiteRecord(const char* p, unsigned int mask);
          
     SimInfo* info_; 
  
     std::string filename_; 
     bool isScanned_; 
+    bool binary_;
+    bool gzipped_;
+    long long dataSize_;  /**< length of the (uncompressed) text */
  
     int nframes_; 
  
     std::istream* inFile_; 
      
     std::vector<std::streampos> framePos_; 
+    std::vector<RealType> frameTimes_;
+#ifdef HAVE_LIBZ
+    GzIndex* gzIndex_;
+#endif
  
     bool needPos_; 
     bool needVel_; 
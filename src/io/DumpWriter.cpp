@@ -50,10 +50,14 @@
 #include "primitives/Molecule.hpp"
 #include "utils/simError.h"
 #include "io/basic_teebuf.hpp"
-#ifdef HAVE_ZLIB
+#ifdef HAVE_LIBZ
 #include "io/gzstream.hpp"
 #endif
 #include "io/Globals.hpp"
+#include "io/BinaryDump.hpp"
+#include "utils/CaseConversion.hpp"
+#include <climits>
+#include <sstream>
 
 #ifdef _MSC_VER
 #define isnan(x) _isnan((x))
@@ -66,9 +70,20 @@
 using namespace std;
 namespace OpenMD {
 
+#ifdef IS_MPI
+  struct DumpWriter::ParallelFiles {
+    MPI_File dump;
+    MPI_Offset offset;         /**< end of the dump file so far */
+    MPI_File eor;
+    bool eorPending;           /**< eor writes still in flight */
+    std::string eorParts[2];
+    MPI_Request eorRequests[2];
+  };
+#endif
+
   DumpWriter::DumpWriter(SimInfo* info)
     : info_(info), filename_(info->getDumpFileName()),
-      eorFilename_(info->getFinalConfigFileName()){
+      eorFilename_(info->getFinalConfigFileName()), async_(NULL) {
 
     Globals* simParams = info->getSimParams();
     needCompression_   = simParams->getCompressDumpFile();
@@ -86,39 +101,22 @@ namespace OpenMD {
       doSiteData_ = false;
     }
 
+    setupDumpFormat(simParams);
+
     createDumpFile_ = true;
 #ifdef HAVE_LIBZ
     if (needCompression_) {
-      filename_ += ".gz";
+      if (!binary_) filename_ += ".gz";
       eorFilename_ += ".gz";
     }
 #endif
 
-#ifdef IS_MPI
-
-    if (worldRank == 0) {
-#endif // is_mpi
-
-      dumpFile_ = createOStream(filename_);
-
-      if (!dumpFile_) {
-        sprintf(painCave.errMsg, "Could not open \"%s\" for dump output.\n",
-                filename_.c_str());
-        painCave.isFatal = 1;
-        simError();
-      }
-
-#ifdef IS_MPI
-
-    }
-
-#endif // is_mpi
-
+    openDumpFile();
   }
 
 
   DumpWriter::DumpWriter(SimInfo* info, const std::string& filename)
-    : info_(info), filename_(filename){
+    : info_(info), filename_(filename), async_(NULL) {
 
     Globals* simParams = info->getSimParams();
     eorFilename_ = filename_.substr(0, filename_.rfind(".")) + ".eor";
@@ -138,40 +136,22 @@ namespace OpenMD {
       doSiteData_ = false;
     }
 
+    setupDumpFormat(simParams);
+
     createDumpFile_ = true;
 #ifdef HAVE_LIBZ
     if (needCompression_) {
-      filename_ += ".gz";
+      if (!binary_) filename_ += ".gz";
       eorFilename_ += ".gz";
     }
 #endif
 
-#ifdef IS_MPI
-
-    if (worldRank == 0) {
-#endif // is_mpi
-
-
-      dumpFile_ = createOStream(filename_);
-
-      if (!dumpFile_) {
-        sprintf(painCave.errMsg, "Could not open \"%s\" for dump output.\n",
-                filename_.c_str());
-        painCave.isFatal = 1;
-        simError();
-      }
-
-#ifdef IS_MPI
-
-    }
-
-#endif // is_mpi
-
+    openDumpFile();
   }
 
   DumpWriter::DumpWriter(SimInfo* info, const std::string& filename,
                          bool writeDumpFile)
-    : info_(info), filename_(filename) {
+    : info_(info), filename_(filename), async_(NULL) {
 
     Globals* simParams = info->getSimParams();
     eorFilename_ = filename_.substr(0, filename_.rfind(".")) + ".eor";
@@ -191,54 +171,121 @@ namespace OpenMD {
       doSiteData_ = false;
     }
 
+    setupDumpFormat(simParams);
+
 #ifdef HAVE_LIBZ
     if (needCompression_) {
-      filename_ += ".gz";
+      if (!binary_) filename_ += ".gz";
       eorFilename_ += ".gz";
     }
 #endif
 
-#ifdef IS_MPI
+    createDumpFile_ = writeDumpFile;
+    openDumpFile();
+  }
 
-    if (worldRank == 0) {
-#endif // is_mpi
+  DumpWriter::~DumpWriter() {
 
-      createDumpFile_ = writeDumpFile;
-      if (createDumpFile_) {
-        dumpFile_ = createOStream(filename_);
+    if (async_ != NULL) {
+      // everything staged so far has to be on disk before the closing:
+      async_->drain();
+      delete staged_[0];
+      delete staged_[1];
+    }
 
-        if (!dumpFile_) {
-          sprintf(painCave.errMsg, "Could not open \"%s\" for dump output.\n",
-                  filename_.c_str());
-          painCave.isFatal = 1;
-          simError();
+#ifdef IS_MPI
+    finishEor();
+
+    if (collective_) {
+      if (createDumpFile_) {
+        if (worldRank == 0) {
+          std::string closing = binary_ ?
+            prepareBinaryIndex(parallel_->offset) :
+            std::string("</OpenMD>\n");
+          MPI_Status status;
+          MPI_File_write_at(parallel_->dump, parallel_->offset,
+                            (void*)closing.data(), closing.size(), MPI_CHAR,
+                            &status);
         }
+        MPI_File_close(&parallel_->dump);
+      }
+      delete parallel_;
+      return;
+    }
+    delete parallel_;
+
+    if (worldRank == 0) {
+#endif // is_mpi
+      if (createDumpFile_){
+        if (binary_)
+          writeBinaryIndex(*dumpFile_);
+        else
+          writeClosing(*dumpFile_);
+        delete dumpFile_;
       }
 #ifdef IS_MPI
 
     }
 
-
 #endif // is_mpi
 
   }
 
-  DumpWriter::~DumpWriter() {
+  void DumpWriter::openDumpFile() {
+    dumpFile_ = NULL;
 
 #ifdef IS_MPI
+    // A compressed stream can't be written in pieces, so compressed
+    // text dumps are still gathered on the primary node:
+    collective_ = binary_ || !needCompression_;
+    parallel_ = new ParallelFiles;
+    parallel_->eorPending = false;
+
+    if (collective_) {
+      if (!createDumpFile_) return;
+
+      int err = MPI_File_open(MPI_COMM_WORLD, (char*)filename_.c_str(),
+                              MPI_MODE_WRONLY | MPI_MODE_CREATE,
+                              MPI_INFO_NULL, &parallel_->dump);
+      if (err != MPI_SUCCESS) {
+        sprintf(painCave.errMsg, "Could not open \"%s\" for dump output.\n",
+                filename_.c_str());
+        painCave.isFatal = 1;
+        simError();
+      }
+      MPI_File_set_size(parallel_->dump, 0);
+
+      // the MetaData is only complete on the primary node:
+      long long headerSize = 0;
+      if (worldRank == 0) {
+        std::string header = prepareHeader(binary_);
+        MPI_Status status;
+        MPI_File_write_at(parallel_->dump, 0, (void*)header.data(),
+                          header.size(), MPI_CHAR, &status);
+        headerSize = header.size();
+      }
+      MPI_Bcast(&headerSize, 1, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+      parallel_->offset = headerSize;
+      return;
+    }
 
     if (worldRank == 0) {
 #endif // is_mpi
-      if (createDumpFile_){
-        writeClosing(*dumpFile_);
-        delete dumpFile_;
+
+      if (createDumpFile_) {
+        dumpFile_ = createOStream(filename_, binary_);
+
+        if (!dumpFile_) {
+          sprintf(painCave.errMsg, "Could not open \"%s\" for dump output.\n",
+                  filename_.c_str());
+          painCave.isFatal = 1;
+          simError();
+        }
       }
-#ifdef IS_MPI
 
+#ifdef IS_MPI
     }
-
 #endif // is_mpi
-
   }
 
   void DumpWriter::writeFrameProperties(std::ostream& os, Snapshot* s) {
@@ -315,11 +362,7 @@ namespace OpenMD {
     os << "    </FrameData>\n";
   }
 
-  void DumpWriter::writeFrame(std::ostream& os) {
-
-#ifdef IS_MPI
-    MPI_Status istatus;
-#endif
+  void DumpWriter::writeFrame(std::ostream& os, Snapshot* s) {
 
     Molecule* mol;
     StuntDouble* sd;
@@ -327,10 +370,9 @@ namespace OpenMD {
     Molecule::IntegrableObjectIterator ii;
     RigidBody::AtomIterator ai;
 
-#ifndef IS_MPI
     os << "  <Snapshot>\n";
 
-    writeFrameProperties(os, info_->getSnapshotManager()->getCurrentSnapshot());
+    writeFrameProperties(os, s);
 
     os << "    <StuntDoubles>\n";
     for (mol = info_->beginMolecule(mi); mol != NULL;
@@ -338,7 +380,7 @@ namespace OpenMD {
 
       for (sd = mol->beginIntegrableObject(ii); sd != NULL;
            sd = mol->nextIntegrableObject(ii)) {
-          os << prepareDumpLine(sd);
+          os << prepareDumpLine(sd, s);
 
       }
     }
@@ -354,7 +396,7 @@ namespace OpenMD {
 
           int ioIndex = sd->getGlobalIntegrableObjectIndex();
           // do one for the IO itself
-          os << prepareSiteLine(sd, ioIndex, 0);
+          os << prepareSiteLine(sd, ioIndex, 0, s);
 
           if (sd->isRigidBody()) {
 
@@ -362,7 +404,7 @@ namespace OpenMD {
             int siteIndex = 0;
             for (Atom* atom = rb->beginAtom(ai); atom != NULL;
                  atom = rb->nextAtom(ai)) {
-              os << prepareSiteLine(atom, ioIndex, siteIndex);
+              os << prepareSiteLine(atom, ioIndex, siteIndex, s);
               siteIndex++;
             }
           }
@@ -374,179 +416,21 @@ namespace OpenMD {
 
     os.flush();
     os.rdbuf()->pubsync();
-#else
-
-    const int primaryNode = 0;
-    int worldRank;
-    int nProc;
-
-    MPI_Comm_size( MPI_COMM_WORLD, &nProc);
-    MPI_Comm_rank( MPI_COMM_WORLD, &worldRank);
-
-
-    if (worldRank == primaryNode) {
-      os << "  <Snapshot>\n";
-      writeFrameProperties(os,
-                           info_->getSnapshotManager()->getCurrentSnapshot());
-      os << "    <StuntDoubles>\n";
-    }
-
-    //every node prepares the dump lines for integrable objects belong to itself
-    std::string buffer;
-    for (mol = info_->beginMolecule(mi); mol != NULL;
-         mol = info_->nextMolecule(mi)) {
-      for (sd = mol->beginIntegrableObject(ii); sd != NULL;
-           sd = mol->nextIntegrableObject(ii)) {
-        buffer += prepareDumpLine(sd);
-      }
-    }
-
-    if (worldRank == primaryNode) {
-      os << buffer;
-
-      for (int i = 1; i < nProc; ++i) {
-        // tell processor i to start sending us data:
-
-        MPI_Bcast(&i, 1, MPI_INT, primaryNode, MPI_COMM_WORLD);
-
-        // receive the length of the string buffer that was
-        // prepared by processor i:
-        int recvLength;
-        MPI_Recv(&recvLength, 1, MPI_INT, i, MPI_ANY_TAG, MPI_COMM_WORLD,
-                 &istatus);
-
-        // create a buffer to receive the data
-        char* recvBuffer = new char[recvLength];
-        if (recvBuffer == NULL) {
-        } else {
-          // receive the data:
-          MPI_Recv(recvBuffer, recvLength, MPI_CHAR, i,
-                               MPI_ANY_TAG, MPI_COMM_WORLD, &istatus);
-          // send it to the file:
-          os << recvBuffer;
-          // get rid of the receive buffer:
-          delete [] recvBuffer;
-        }
-      }
-    } else {
-      int sendBufferLength = buffer.size() + 1;
-      int myturn = 0;
-      for (int i = 1; i < nProc; ++i){
-        // wait for the primary node to call our number:
-        MPI_Bcast(&myturn, 1, MPI_INT, primaryNode, MPI_COMM_WORLD);
-        if (myturn == worldRank){
-          // send the length of our buffer:
-
-          MPI_Send(&sendBufferLength, 1, MPI_INT, primaryNode, 0, MPI_COMM_WORLD);
-
-          // send our buffer:
-          MPI_Send((void *)buffer.c_str(), sendBufferLength,
-                   MPI_CHAR, primaryNode, 0, MPI_COMM_WORLD);
-
-        }
-      }
-    }
-
-    if (worldRank == primaryNode) {
-      os << "    </StuntDoubles>\n";
-    }
-
-    if (doSiteData_) {
-      if (worldRank == primaryNode) {
-        os << "    <SiteData>\n";
-      }
-      buffer.clear();
-      for (mol = info_->beginMolecule(mi); mol != NULL;
-           mol = info_->nextMolecule(mi)) {
-
-        for (sd = mol->beginIntegrableObject(ii); sd != NULL;
-             sd = mol->nextIntegrableObject(ii)) {
-
-          int ioIndex = sd->getGlobalIntegrableObjectIndex();
-          // do one for the IO itself
-          buffer += prepareSiteLine(sd, ioIndex, 0);
-
-          if (sd->isRigidBody()) {
-
-            RigidBody* rb = static_cast<RigidBody*>(sd);
-            int siteIndex = 0;
-            for (Atom* atom = rb->beginAtom(ai); atom != NULL;
-                 atom = rb->nextAtom(ai)) {
-              buffer += prepareSiteLine(atom, ioIndex, siteIndex);
-              siteIndex++;
-            }
-          }
-        }
-      }
-
-      if (worldRank == primaryNode) {
-        os << buffer;
-
-        for (int i = 1; i < nProc; ++i) {
-
-          // tell processor i to start sending us data:
-          MPI_Bcast(&i, 1, MPI_INT, primaryNode, MPI_COMM_WORLD);
-
-          // receive the length of the string buffer that was
-          // prepared by processor i:
-          int recvLength;
-          MPI_Recv(&recvLength, 1, MPI_INT, i, MPI_ANY_TAG, MPI_COMM_WORLD,
-                   &istatus);
-
-          // create a buffer to receive the data
-          char* recvBuffer = new char[recvLength];
-          if (recvBuffer == NULL) {
-          } else {
-            // receive the data:
-            MPI_Recv(recvBuffer, recvLength, MPI_CHAR, i,
-                     MPI_ANY_TAG, MPI_COMM_WORLD, &istatus);
-            // send it to the file:
-            os << recvBuffer;
-            // get rid of the receive buffer:
-            delete [] recvBuffer;
-          }
-        }
-      } else {
-        int sendBufferLength = buffer.size() + 1;
-        int myturn = 0;
-        for (int i = 1; i < nProc; ++i){
-          // wait for the primary node to call our number:
-          MPI_Bcast(&myturn, 1, MPI_INT, primaryNode, MPI_COMM_WORLD);
-          if (myturn == worldRank){
-            // send the length of our buffer:
-            MPI_Send(&sendBufferLength, 1, MPI_INT, primaryNode, 0, MPI_COMM_WORLD);
-            // send our buffer:
-            MPI_Send((void *)buffer.c_str(), sendBufferLength,
-                     MPI_CHAR, primaryNode, 0, MPI_COMM_WORLD);
-          }
-        }
-      }
-
-      if (worldRank == primaryNode) {
-        os << "    </SiteData>\n";
-      }
-    }
-
-    if (worldRank == primaryNode) {
-      os << "  </Snapshot>\n";
-      os.flush();
-      os.rdbuf()->pubsync();
-    }
-
-#endif // is_mpi
 
   }
 
-  std::string DumpWriter::prepareDumpLine(StuntDouble* sd) {
+  std::string DumpWriter::prepareDumpLine(StuntDouble* sd, Snapshot* s) {
 
     int index = sd->getGlobalIntegrableObjectIndex();
+    DataStorage& data = s->*(sd->getStorage());
+    int localIndex = sd->getLocalIndex();
     std::string type("pv");
     std::string line;
     char tempBuffer[4096];
 
     Vector3d pos;
     Vector3d vel;
-    pos = sd->getPos();
+    pos = data.position[localIndex];
 
     if (isinf(pos[0]) || isnan(pos[0]) ||
         isinf(pos[1]) || isnan(pos[1]) ||
@@ -558,7 +442,7 @@ namespace OpenMD {
       simError();
     }
 
-    vel = sd->getVel();
+    vel = data.velocity[localIndex];
 
     if (isinf(vel[0]) || isnan(vel[0]) ||
         isinf(vel[1]) || isnan(vel[1]) ||
@@ -579,7 +463,7 @@ namespace OpenMD {
       type += "qj";
       Quat4d q;
       Vector3d ji;
-      q = sd->getQ();
+      q = data.aMat[localIndex].toQuaternion();
 
       if (isinf(q[0]) || isnan(q[0]) ||
           isinf(q[1]) || isnan(q[1]) ||
@@ -592,7 +476,7 @@ namespace OpenMD {
         simError();
       }
 
-      ji = sd->getJ();
+      ji = data.angularMomentum[localIndex];
 
       if (isinf(ji[0]) || isnan(ji[0]) ||
           isinf(ji[1]) || isnan(ji[1]) ||
@@ -612,7 +496,7 @@ namespace OpenMD {
 
     if (needForceVector_) {
       type += "f";
-      Vector3d frc = sd->getFrc();
+      Vector3d frc = data.force[localIndex];
       if (isinf(frc[0]) || isnan(frc[0]) ||
           isinf(frc[1]) || isnan(frc[1]) ||
           isinf(frc[2]) || isnan(frc[2]) ) {
@@ -628,7 +512,7 @@ namespace OpenMD {
 
       if (sd->isDirectional()) {
         type += "t";
-        Vector3d trq = sd->getTrq();
+        Vector3d trq = data.torque[localIndex];
         if (isinf(trq[0]) || isnan(trq[0]) ||
             isinf(trq[1]) || isnan(trq[1]) ||
             isinf(trq[2]) || isnan(trq[2]) ) {
@@ -649,8 +533,10 @@ namespace OpenMD {
   }
 
   std::string DumpWriter::prepareSiteLine(StuntDouble* sd, int ioIndex,
-                                          int siteIndex) {
+                                          int siteIndex, Snapshot* s) {
     int storageLayout = info_->getSnapshotManager()->getStorageLayout();
+    DataStorage& data = s->*(sd->getStorage());
+    int localIndex = sd->getLocalIndex();
 
     std::string id;
     std::string type;
@@ -668,7 +554,7 @@ namespace OpenMD {
     if (needFlucQ_) {
       if (storageLayout & DataStorage::dslFlucQPosition) {
         type += "c";
-        RealType fqPos = sd->getFlucQPos();
+        RealType fqPos = data.flucQPos[localIndex];
         if (isinf(fqPos) || isnan(fqPos) ) {
           sprintf( painCave.errMsg,
                    "DumpWriter detected a numerical error writing the"
@@ -682,7 +568,7 @@ namespace OpenMD {
 
       if (storageLayout & DataStorage::dslFlucQVelocity) {
         type += "w";
-        RealType fqVel = sd->getFlucQVel();
+        RealType fqVel = data.flucQVel[localIndex];
         if (isinf(fqVel) || isnan(fqVel) ) {
           sprintf( painCave.errMsg,
                    "DumpWriter detected a numerical error writing the"
@@ -697,7 +583,7 @@ namespace OpenMD {
       if (needForceVector_) {
         if (storageLayout & DataStorage::dslFlucQForce) {
           type += "g";
-          RealType fqFrc = sd->getFlucQFrc();
+          RealType fqFrc = data.flucQFrc[localIndex];
           if (isinf(fqFrc) || isnan(fqFrc) ) {
             sprintf( painCave.errMsg,
                      "DumpWriter detected a numerical error writing the"
@@ -714,7 +600,7 @@ namespace OpenMD {
     if (needElectricField_) {
       if (storageLayout & DataStorage::dslElectricField) {
         type += "e";
-        Vector3d eField= sd->getElectricField();
+        Vector3d eField = data.electricField[localIndex];
         if (isinf(eField[0]) || isnan(eField[0]) ||
             isinf(eField[1]) || isnan(eField[1]) ||
             isinf(eField[2]) || isnan(eField[2]) ) {
@@ -733,7 +619,7 @@ namespace OpenMD {
     if (needSitePotential_) {
       if (storageLayout & DataStorage::dslSitePotential) {
         type += "s";
-        RealType sPot = sd->getSitePotential();
+        RealType sPot = data.sitePotential[localIndex];
         if (isinf(sPot) || isnan(sPot) ) {
           sprintf( painCave.errMsg,
                    "DumpWriter detected a numerical error writing the"
@@ -749,7 +635,7 @@ namespace OpenMD {
     if (needParticlePot_) {
       if (storageLayout & DataStorage::dslParticlePot) {
         type += "u";
-        RealType particlePot = sd->getParticlePot();
+        RealType particlePot = data.particlePot[localIndex];
         if (isinf(particlePot) || isnan(particlePot)) {
           sprintf( painCave.errMsg,
                    "DumpWriter detected a numerical error writing the particle "
@@ -765,7 +651,7 @@ namespace OpenMD {
     if (needDensity_) {
       if (storageLayout & DataStorage::dslDensity) {
         type += "d";
-        RealType density = sd->getDensity();
+        RealType density = data.density[localIndex];
         if (isinf(density) || isnan(density)) {
           sprintf( painCave.errMsg,
                    "DumpWriter detected a numerical error writing the density "
@@ -783,90 +669,744 @@ namespace OpenMD {
   }
 
   void DumpWriter::writeDump() {
-    writeFrame(*dumpFile_);
+#ifdef IS_MPI
+    if (binary_) {
+      writeParallelBinaryFrame();
+    } else {
+      std::string parts[2];
+      prepareFrameParts(parts);
+      writeParallelDump(parts);
+    }
+#else
+    if (async_ != NULL) {
+      submitFrame(true, false);
+      return;
+    }
+
+    Snapshot* s = info_->getSnapshotManager()->getCurrentSnapshot();
+    if (binary_)
+      writeBinaryFrame(*dumpFile_, s);
+    else
+      writeFrame(*dumpFile_, s);
+#endif
   }
 
   void DumpWriter::writeEor() {
-
-    std::ostream* eorStream = NULL;
-
 #ifdef IS_MPI
-    if (worldRank == 0) {
+    std::string parts[2];
+    prepareFrameParts(parts);
+    writeParallelEor(parts);
+#else
+    if (async_ != NULL) {
+      submitFrame(false, true);
+      return;
+    }
+
+    std::ostream* eorStream = createOStream(eorFilename_);
+    writeFrame(*eorStream, info_->getSnapshotManager()->getCurrentSnapshot());
+    writeClosing(*eorStream);
+    delete eorStream;
 #endif // is_mpi
+  }
 
-      eorStream = createOStream(eorFilename_);
 
+  void DumpWriter::writeDumpAndEor() {
 #ifdef IS_MPI
+    // the text of the frame is prepared once for both files:
+    std::string parts[2];
+    if (binary_)
+      writeParallelBinaryFrame();
+    prepareFrameParts(parts);
+    if (!binary_)
+      writeParallelDump(parts);
+    writeParallelEor(parts);
+#else
+    if (async_ != NULL) {
+      submitFrame(true, true);
+      return;
+    }
+
+    Snapshot* s = info_->getSnapshotManager()->getCurrentSnapshot();
+    if (binary_) {
+      // the binary dump and the text eor can't share a tee'd stream:
+      writeBinaryFrame(*dumpFile_, s);
+      writeEor();
+      return;
     }
+
+    std::vector<std::streambuf*> buffers;
+    buffers.push_back(dumpFile_->rdbuf());
+    std::ostream* eorStream = createOStream(eorFilename_);
+    buffers.push_back(eorStream->rdbuf());
+
+    TeeBuf tbuf(buffers.begin(), buffers.end());
+
+    std::ostream os(&tbuf);
+    writeFrame(os, s);
+
+    writeClosing(*eorStream);
+    delete eorStream;
+#endif // is_mpi
+  }
+
+  std::string DumpWriter::prepareHeader(bool binary) {
+    std::ostringstream header;
+    if (binary)
+      header << "<OpenMD version=2 format=binary>" << std::endl;
+    else
+      header << "<OpenMD version=2>" << std::endl;
+    header << "  <MetaData>" << std::endl;
+    header << info_->getRawMetaData();
+    header << "  </MetaData>" << std::endl;
+    return header.str();
+  }
+
+  std::ostream* DumpWriter::createOStream(const std::string& filename,
+                                          bool binary) {
+
+    std::ostream* newOStream;
+
+    if (binary) {
+      newOStream = new std::ofstream(filename.c_str(),
+                                     std::ios::out | std::ios::binary);
+    } else {
+#ifdef HAVE_LIBZ
+      if (needCompression_) {
+        newOStream = new ogzstream(filename.c_str());
+      } else {
+        newOStream = new std::ofstream(filename.c_str());
+      }
+#else
+      newOStream = new std::ofstream(filename.c_str());
 #endif
+    }
 
-    writeFrame(*eorStream);
+    //write out MetaData first
+    (*newOStream) << prepareHeader(binary);
+    return newOStream;
+  }
 
-#ifdef IS_MPI
-    if (worldRank == 0) {
+  void DumpWriter::writeClosing(std::ostream& os) {
+
+    os << "</OpenMD>\n";
+    os.flush();
+  }
+
+  void DumpWriter::setupDumpFormat(Globals* simParams) {
+    std::string format = simParams->getDumpFileFormat();
+    toUpper(format);
+    binary_ = (format == "BINARY");
+
+    posPrecision_ = 0.0;
+    if (binary_ && simParams->haveDumpPositionPrecision())
+      posPrecision_ = simParams->getDumpPositionPrecision();
+
+    if (binary_ && needCompression_) {
+      sprintf(painCave.errMsg,
+              "DumpWriter: compressDumpFile is ignored for binary dump files.\n"
+              "\tOnly the end-of-run (eor) file will be compressed.  Use\n"
+              "\tdumpPositionPrecision to reduce the size of the dump.\n");
+      painCave.isFatal = 0;
+      painCave.severity = OPENMD_INFO;
+      simError();
+    }
+  }
+
+  void DumpWriter::writeBinaryFrame(std::ostream& os, Snapshot* s) {
+    unsigned int sdMask, siteMask;
+    std::string sdBuffer;
+    std::string siteBuffer;
+
+    prepareBinaryBuffers(sdMask, siteMask, sdBuffer, siteBuffer, s);
+
+    int sdRecordSize = BinaryDump::sdRecordSize(sdMask, posPrecision_ > 0.0);
+    int siteRecordSize = BinaryDump::siteRecordSize(siteMask);
+    int nSD = sdBuffer.size() / sdRecordSize;
+    int nSites = siteMask ? siteBuffer.size() / siteRecordSize : 0;
+
+    unsigned long long frameBytes = BinaryDump::frameHeaderSize +
+      sdBuffer.size() + (nSites ? siteBuffer.size() : 0);
+
+    std::string header = prepareBinaryHeader(sdMask, siteMask, nSD, nSites,
+                                             frameBytes, s);
+
+    frameOffsets_.push_back((long long) os.tellp());
+    frameTimes_.push_back(s->getTime());
+
+    os.write(header.data(), header.size());
+    os.write(sdBuffer.data(), sdBuffer.size());
+    if (nSites) os.write(siteBuffer.data(), siteBuffer.size());
+    os.flush();
+    os.rdbuf()->pubsync();
+  }
+
+  void DumpWriter::prepareBinaryBuffers(unsigned int& sdMask,
+                                        unsigned int& siteMask,
+                                        std::string& sdBuffer,
+                                        std::string& siteBuffer,
+                                        Snapshot* s) {
+    Molecule* mol;
+    StuntDouble* sd;
+    SimInfo::MoleculeIterator mi;
+    Molecule::IntegrableObjectIterator ii;
+    RigidBody::AtomIterator ai;
+
+    unsigned int storageLayout = info_->getSnapshotManager()->getStorageLayout();
+
+    // The same fields that the text writer would emit (pvqjft), but
+    // chosen once per frame so that every record has the same width:
+    sdMask = DataStorage::dslPosition | DataStorage::dslVelocity;
+    if (storageLayout & DataStorage::dslAmat)
+      sdMask |= DataStorage::dslAmat | DataStorage::dslAngularMomentum;
+    if (needForceVector_) {
+      sdMask |= DataStorage::dslForce;
+      if (storageLayout & DataStorage::dslAmat)
+        sdMask |= DataStorage::dslTorque;
+    }
+
+    siteMask = 0;
+    if (needFlucQ_) {
+      siteMask |= storageLayout & (DataStorage::dslFlucQPosition |
+                                   DataStorage::dslFlucQVelocity);
+      if (needForceVector_)
+        siteMask |= storageLayout & DataStorage::dslFlucQForce;
+    }
+    if (needElectricField_)
+      siteMask |= storageLayout & DataStorage::dslElectricField;
+    if (needSitePotential_)
+      siteMask |= storageLayout & DataStorage::dslSitePotential;
+    if (needParticlePot_)
+      siteMask |= storageLayout & DataStorage::dslParticlePot;
+    if (needDensity_)
+      siteMask |= storageLayout & DataStorage::dslDensity;
+
+    sdBuffer.clear();
+    siteBuffer.clear();
+
+    for (mol = info_->beginMolecule(mi); mol != NULL;
+         mol = info_->nextMolecule(mi)) {
+      for (sd = mol->beginIntegrableObject(ii); sd != NULL;
+           sd = mol->nextIntegrableObject(ii)) {
+
+        prepareBinaryRecord(sd, sdMask, sdBuffer, s);
+
+        if (siteMask) {
+          int ioIndex = sd->getGlobalIntegrableObjectIndex();
+          prepareBinarySiteRecord(sd, ioIndex, -1, siteMask, siteBuffer, s);
+
+          if (sd->isRigidBody()) {
+            RigidBody* rb = static_cast<RigidBody*>(sd);
+            int siteIndex = 0;
+            for (Atom* atom = rb->beginAtom(ai); atom != NULL;
+                 atom = rb->nextAtom(ai)) {
+              prepareBinarySiteRecord(atom, ioIndex, siteIndex, siteMask,
+                                      siteBuffer, s);
+              siteIndex++;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  std::string DumpWriter::prepareBinaryHeader(unsigned int sdMask,
+                                              unsigned int siteMask,
+                                              int nSD, int nSites,
+                                              unsigned long long frameBytes,
+                                              Snapshot* s) {
+    RealType currentTime = s->getTime();
+    Mat3x3d hmat = s->getHmat();
+    pair<RealType, RealType> thermostat = s->getThermostat();
+    Mat3x3d eta = s->getBarostat();
+
+    if (isinf(currentTime) || isnan(currentTime)) {
+      sprintf( painCave.errMsg,
+               "DumpWriter detected a numerical error writing the time");
+      painCave.isFatal = 1;
+      simError();
+    }
+
+    std::string header;
+    header.reserve(BinaryDump::frameHeaderSize);
+    header.append(BinaryDump::frameMagic, 4);
+    BinaryDump::put<int>(header, BinaryDump::byteOrderMarker);
+    BinaryDump::put<unsigned int>(header, sdMask);
+    BinaryDump::put<unsigned int>(header, siteMask);
+    BinaryDump::put<int>(header, nSD);
+    BinaryDump::put<int>(header, nSites);
+    BinaryDump::put<double>(header, posPrecision_);
+    BinaryDump::put<double>(header, currentTime);
+    for (unsigned int i = 0; i < 3; i++)
+      for (unsigned int j = 0; j < 3; j++)
+        BinaryDump::put<double>(header, hmat(i, j));
+    BinaryDump::put<double>(header, thermostat.first);
+    BinaryDump::put<double>(header, thermostat.second);
+    for (unsigned int i = 0; i < 3; i++)
+      for (unsigned int j = 0; j < 3; j++)
+        BinaryDump::put<double>(header, eta(i, j));
+    BinaryDump::put<unsigned long long>(header, frameBytes);
+    return header;
+  }
+
+  void DumpWriter::prepareBinaryRecord(StuntDouble* sd, unsigned int mask,
+                                       std::string& buf, Snapshot* s) {
+
+    int index = sd->getGlobalIntegrableObjectIndex();
+    bool directional = sd->isDirectional();
+    DataStorage& data = s->*(sd->getStorage());
+    int localIndex = sd->getLocalIndex();
+
+    Vector3d pos = data.position[localIndex];
+    Vector3d vel = data.velocity[localIndex];
+    Quat4d q(0.0);
+    Vector3d ji(0.0);
+    Vector3d frc(0.0);
+    Vector3d trq(0.0);
+    if (directional) {
+      q = data.aMat[localIndex].toQuaternion();
+      ji = data.angularMomentum[localIndex];
+    }
+    if (mask & DataStorage::dslForce) frc = data.force[localIndex];
+    if (directional && (mask & DataStorage::dslTorque))
+      trq = data.torque[localIndex];
+
+    for (unsigned int i = 0; i < 3; i++) {
+      if (isinf(pos[i]) || isnan(pos[i]) || isinf(vel[i]) || isnan(vel[i]) ||
+          isinf(ji[i]) || isnan(ji[i]) || isinf(frc[i]) || isnan(frc[i]) ||
+          isinf(trq[i]) || isnan(trq[i]) || isinf(q[i]) || isnan(q[i])) {
+        sprintf( painCave.errMsg,
+                 "DumpWriter detected a numerical error writing the"
+                 " binary record for object %d", index);
+        painCave.isFatal = 1;
+        simError();
+      }
+    }
+
+    BinaryDump::put<int>(buf, index);
+
+    if (posPrecision_ > 0.0) {
+      for (unsigned int i = 0; i < 3; i++) {
+        RealType scaled = pos[i] / posPrecision_;
+        if (fabs(scaled) >= RealType(INT_MAX)) {
+          sprintf( painCave.errMsg,
+                   "DumpWriter: the position of object %d cannot be stored\n"
+                   "\twith a dumpPositionPrecision of %g\n",
+                   index, posPrecision_);
+          painCave.isFatal = 1;
+          simError();
+        }
+        BinaryDump::put<int>(buf, int(floor(scaled + 0.5)));
+      }
+    } else {
+      for (unsigned int i = 0; i < 3; i++) BinaryDump::put<double>(buf, pos[i]);
+    }
+    for (unsigned int i = 0; i < 3; i++) BinaryDump::put<double>(buf, vel[i]);
+
+    if (mask & DataStorage::dslAmat)
+      for (unsigned int i = 0; i < 4; i++) BinaryDump::put<double>(buf, q[i]);
+    if (mask & DataStorage::dslAngularMomentum)
+      for (unsigned int i = 0; i < 3; i++) BinaryDump::put<double>(buf, ji[i]);
+    if (mask & DataStorage::dslForce)
+      for (unsigned int i = 0; i < 3; i++) BinaryDump::put<double>(buf, frc[i]);
+    if (mask & DataStorage::dslTorque)
+      for (unsigned int i = 0; i < 3; i++) BinaryDump::put<double>(buf, trq[i]);
+  }
+
+  void DumpWriter::prepareBinarySiteRecord(StuntDouble* sd, int ioIndex,
+                                           int siteIndex, unsigned int mask,
+                                           std::string& buf, Snapshot* s) {
+    RealType fqPos(0.0), fqVel(0.0), fqFrc(0.0);
+    RealType sPot(0.0), particlePot(0.0), density(0.0);
+    Vector3d eField(0.0);
+    DataStorage& data = s->*(sd->getStorage());
+    int i = sd->getLocalIndex();
+
+    if (mask & DataStorage::dslFlucQPosition) fqPos = data.flucQPos[i];
+    if (mask & DataStorage::dslFlucQVelocity) fqVel = data.flucQVel[i];
+    if (mask & DataStorage::dslFlucQForce) fqFrc = data.flucQFrc[i];
+    if (mask & DataStorage::dslElectricField) eField = data.electricField[i];
+    if (mask & DataStorage::dslSitePotential) sPot = data.sitePotential[i];
+    if (mask & DataStorage::dslParticlePot) particlePot = data.particlePot[i];
+    if (mask & DataStorage::dslDensity) density = data.density[i];
+
+    RealType sum = fqPos + fqVel + fqFrc + sPot + particlePot + density +
+      eField[0] + eField[1] + eField[2];
+    if (isinf(sum) || isnan(sum)) {
+      sprintf( painCave.errMsg,
+               "DumpWriter detected a numerical error writing the"
+               " binary site record for object %d %d", ioIndex, siteIndex);
+      painCave.isFatal = 1;
+      simError();
+    }
+
+    BinaryDump::put<int>(buf, ioIndex);
+    BinaryDump::put<int>(buf, siteIndex);
+    if (mask & DataStorage::dslFlucQPosition)
+      BinaryDump::put<double>(buf, fqPos);
+    if (mask & DataStorage::dslFlucQVelocity)
+      BinaryDump::put<double>(buf, fqVel);
+    if (mask & DataStorage::dslFlucQForce)
+      BinaryDump::put<double>(buf, fqFrc);
+    if (mask & DataStorage::dslElectricField)
+      for (unsigned int i = 0; i < 3; i++)
+        BinaryDump::put<double>(buf, eField[i]);
+    if (mask & DataStorage::dslSitePotential)
+      BinaryDump::put<double>(buf, sPot);
+    if (mask & DataStorage::dslParticlePot)
+      BinaryDump::put<double>(buf, particlePot);
+    if (mask & DataStorage::dslDensity)
+      BinaryDump::put<double>(buf, density);
+  }
+
+  void DumpWriter::writeBinaryIndex(std::ostream& os) {
+    std::string index = prepareBinaryIndex((long long) os.tellp());
+    os.write(index.data(), index.size());
+    os.flush();
+  }
+
+  std::string DumpWriter::prepareBinaryIndex(long long indexStart) {
+    std::string index;
+
+    for (unsigned int i = 0; i < frameOffsets_.size(); i++) {
+      BinaryDump::put<long long>(index, frameOffsets_[i]);
+      BinaryDump::put<double>(index, frameTimes_[i]);
+    }
+    BinaryDump::put<long long>(index, (long long) frameOffsets_.size());
+    BinaryDump::put<long long>(index, indexStart);
+    index.append(BinaryDump::indexMagic, 8);
+    return index;
+  }
+
+  void DumpWriter::setAsyncOutput(AsyncOutput* async) {
+#ifndef IS_MPI
+    // (every node takes part in writing a parallel frame, so those
+    // stay synchronous)
+    async_ = async;
+    staged_[0] = NULL;
+    staged_[1] = NULL;
+    stagedTicket_[0] = 0;
+    stagedTicket_[1] = 0;
+    nextStage_ = 0;
 #endif
+  }
+
+  /**
+   * Formats and writes one staged frame on the output thread.
+   */
+  class DumpWriter::FrameTask : public OutputTask {
+  public:
+    FrameTask(DumpWriter* writer, Snapshot* s, bool dump, bool eor) :
+      writer_(writer), s_(s), dump_(dump), eor_(eor) {}
+
+    unsigned long long run() {
+      return writer_->writeStagedFrame(s_, dump_, eor_);
+    }
+
+  private:
+    DumpWriter* writer_;
+    Snapshot* s_;
+    bool dump_;
+    bool eor_;
+  };
 
+  void DumpWriter::submitFrame(bool dump, bool eor) {
+    Snapshot* current = info_->getSnapshotManager()->getCurrentSnapshot();
+    int i = nextStage_;
+    nextStage_ = 1 - nextStage_;
+
+    if (staged_[i] == NULL) {
+      staged_[i] = new Snapshot(*current);
+    } else {
+      // This only stalls if the output thread is still busy with the
+      // frame that was staged here last time:
+      async_->wait(stagedTicket_[i]);
+      *staged_[i] = *current;
+    }
+
+    stagedTicket_[i] = async_->submit(new FrameTask(this, staged_[i],
+                                                    dump, eor));
+  }
+
+  unsigned long long DumpWriter::writeStagedFrame(Snapshot* s, bool dump,
+                                                  bool eor) {
+    unsigned long long bytes = 0;
+
+    if (dump && binary_) {
+      std::streampos start = dumpFile_->tellp();
+      writeBinaryFrame(*dumpFile_, s);
+      bytes += (unsigned long long) (dumpFile_->tellp() - start);
+      dump = false;
+    }
+    if (!dump && !eor) return bytes;
+
+    // the text of the frame is formatted once for both files:
+    std::ostringstream frame;
+    writeFrame(frame, s);
+    std::string text = frame.str();
+
+    if (dump) {
+      dumpFile_->write(text.data(), text.size());
+      dumpFile_->flush();
+      dumpFile_->rdbuf()->pubsync();
+      bytes += text.size();
+    }
+
+    if (eor) {
+      std::ostream* eorStream = createOStream(eorFilename_);
+      eorStream->write(text.data(), text.size());
       writeClosing(*eorStream);
       delete eorStream;
+      bytes += text.size();
+    }
+    return bytes;
+  }
 
 #ifdef IS_MPI
+
+  /**
+   * Each node formats the objects it owns into two pieces: the
+   * StuntDoubles lines and the SiteData lines.  The primary node's
+   * pieces also carry the frame header and the section tags, and the
+   * last node closes the snapshot, so a frame is just the first pieces
+   * of every node followed by the second pieces, in rank order.
+   */
+  void DumpWriter::prepareFrameParts(std::string* parts) {
+    Molecule* mol;
+    StuntDouble* sd;
+    SimInfo::MoleculeIterator mi;
+    Molecule::IntegrableObjectIterator ii;
+    RigidBody::AtomIterator ai;
+
+    int nProc;
+    MPI_Comm_size(MPI_COMM_WORLD, &nProc);
+
+    Snapshot* s = info_->getSnapshotManager()->getCurrentSnapshot();
+
+    parts[0].clear();
+    parts[1].clear();
+
+    if (worldRank == 0) {
+      std::ostringstream header;
+      header << "  <Snapshot>\n";
+      writeFrameProperties(header, s);
+      header << "    <StuntDoubles>\n";
+      parts[0] = header.str();
+
+      parts[1] = "    </StuntDoubles>\n";
+      if (doSiteData_) parts[1] += "    <SiteData>\n";
     }
-#endif // is_mpi
 
+    for (mol = info_->beginMolecule(mi); mol != NULL;
+         mol = info_->nextMolecule(mi)) {
+      for (sd = mol->beginIntegrableObject(ii); sd != NULL;
+           sd = mol->nextIntegrableObject(ii)) {
+        parts[0] += prepareDumpLine(sd, s);
+
+        if (doSiteData_) {
+          int ioIndex = sd->getGlobalIntegrableObjectIndex();
+          // do one for the IO itself
+          parts[1] += prepareSiteLine(sd, ioIndex, 0, s);
+
+          if (sd->isRigidBody()) {
+            RigidBody* rb = static_cast<RigidBody*>(sd);
+            int siteIndex = 0;
+            for (Atom* atom = rb->beginAtom(ai); atom != NULL;
+                 atom = rb->nextAtom(ai)) {
+              parts[1] += prepareSiteLine(atom, ioIndex, siteIndex, s);
+              siteIndex++;
+            }
+          }
+        }
+      }
+    }
+
+    if (worldRank == nProc - 1) {
+      if (doSiteData_) parts[1] += "    </SiteData>\n";
+      parts[1] += "  </Snapshot>\n";
+    }
   }
 
+  /**
+   * Lays out the pieces of every node after base: all of the nodes'
+   * first pieces in rank order, then all of their second pieces, and
+   * so on.  Returns the offsets of this node's pieces in offsets, and
+   * the end of the last piece.
+   */
+  MPI_Offset DumpWriter::getSliceOffsets(std::string* parts, int nParts,
+                                         MPI_Offset base,
+                                         std::vector<MPI_Offset>& offsets) {
+    int nProc;
+    MPI_Comm_size(MPI_COMM_WORLD, &nProc);
 
-  void DumpWriter::writeDumpAndEor() {
-    std::vector<std::streambuf*> buffers;
-    std::ostream* eorStream = NULL;
-#ifdef IS_MPI
+    std::vector<long long> myLengths(nParts);
+    std::vector<long long> lengths(nParts * nProc);
+    for (int p = 0; p < nParts; p++) myLengths[p] = parts[p].size();
+
+    MPI_Allgather(&myLengths[0], nParts, MPI_LONG_LONG, &lengths[0], nParts,
+                  MPI_LONG_LONG, MPI_COMM_WORLD);
+
+    offsets.resize(nParts);
+    MPI_Offset end = base;
+    for (int p = 0; p < nParts; p++) {
+      for (int i = 0; i < nProc; i++) {
+        if (i == worldRank) offsets[p] = end;
+        end += lengths[i * nParts + p];
+      }
+    }
+    return end;
+  }
+
+  /**
+   * Collects the pieces of every node on the primary node, where
+   * gathered[p] is the concatenation of all of the nodes' pieces p.
+   */
+  void DumpWriter::gatherParts(std::string* parts, int nParts,
+                               std::string* gathered) {
+    const int primaryNode = 0;
+    int nProc;
+    MPI_Comm_size(MPI_COMM_WORLD, &nProc);
+
+    for (int p = 0; p < nParts; p++) {
+      int myLength = parts[p].size();
+      std::vector<int> lengths(nProc, 0);
+      std::vector<int> displs(nProc, 0);
+      MPI_Gather(&myLength, 1, MPI_INT, &lengths[0], 1, MPI_INT,
+                 primaryNode, MPI_COMM_WORLD);
+
+      int total = 0;
+      if (worldRank == primaryNode) {
+        for (int i = 0; i < nProc; i++) {
+          displs[i] = total;
+          total += lengths[i];
+        }
+      }
+      std::vector<char> all(std::max(total, 1));
+      MPI_Gatherv((void*)parts[p].data(), myLength, MPI_CHAR, &all[0],
+                  &lengths[0], &displs[0], MPI_CHAR, primaryNode,
+                  MPI_COMM_WORLD);
+      if (worldRank == primaryNode) gathered[p].assign(&all[0], total);
+    }
+  }
+
+  void DumpWriter::writeParallelDump(std::string* parts) {
+    if (collective_) {
+      std::vector<MPI_Offset> offsets;
+      MPI_Offset end = getSliceOffsets(parts, 2, parallel_->offset, offsets);
+      MPI_Status status;
+      for (int p = 0; p < 2; p++)
+        MPI_File_write_at_all(parallel_->dump, offsets[p],
+                              (void*)parts[p].data(), parts[p].size(),
+                              MPI_CHAR, &status);
+      parallel_->offset = end;
+      return;
+    }
+
+    std::string frame[2];
+    gatherParts(parts, 2, frame);
     if (worldRank == 0) {
-#endif // is_mpi
-      buffers.push_back(dumpFile_->rdbuf());
-      eorStream = createOStream(eorFilename_);
-      buffers.push_back(eorStream->rdbuf());
-#ifdef IS_MPI
+      (*dumpFile_) << frame[0] << frame[1];
+      dumpFile_->flush();
+      dumpFile_->rdbuf()->pubsync();
     }
-#endif // is_mpi
+  }
 
-    TeeBuf tbuf(buffers.begin(), buffers.end());
-    std::ostream os(&tbuf);
-    writeFrame(os);
+  void DumpWriter::writeParallelBinaryFrame() {
+    unsigned int sdMask, siteMask;
+    std::string parts[2];
+    Snapshot* s = info_->getSnapshotManager()->getCurrentSnapshot();
+
+    prepareBinaryBuffers(sdMask, siteMask, parts[0], parts[1], s);
+
+    // Records are self-identifying, so each node's records can go
+    // anywhere in the frame.  The header has a fixed size and is
+    // filled in once the totals are known:
+    if (worldRank == 0)
+      parts[0].insert(0, BinaryDump::frameHeaderSize, '\0');
+
+    std::vector<MPI_Offset> offsets;
+    MPI_Offset end = getSliceOffsets(parts, 2, parallel_->offset, offsets);
 
-#ifdef IS_MPI
     if (worldRank == 0) {
-#endif // is_mpi
-      writeClosing(*eorStream);
-      delete eorStream;
-#ifdef IS_MPI
+      long long sdBytes = offsets[1] - parallel_->offset -
+        BinaryDump::frameHeaderSize;
+      long long siteBytes = end - offsets[1];
+      int nSD = sdBytes / BinaryDump::sdRecordSize(sdMask,
+                                                   posPrecision_ > 0.0);
+      int nSites = siteMask ? siteBytes / BinaryDump::siteRecordSize(siteMask)
+        : 0;
+      std::string header = prepareBinaryHeader(sdMask, siteMask, nSD, nSites,
+                                               end - parallel_->offset, s);
+      parts[0].replace(0, header.size(), header);
+
+      frameOffsets_.push_back((long long) parallel_->offset);
+      frameTimes_.push_back(s->getTime());
     }
-#endif // is_mpi
+
+    MPI_Status status;
+    for (int p = 0; p < 2; p++)
+      MPI_File_write_at_all(parallel_->dump, offsets[p],
+                            (void*)parts[p].data(), parts[p].size(),
+                            MPI_CHAR, &status);
+    parallel_->offset = end;
   }
 
-  std::ostream* DumpWriter::createOStream(const std::string& filename) {
+  /**
+   * The eor file is rewritten at every sample.  When it is not
+   * compressed, the writes are started without waiting for them, and
+   * are only completed before the next eor (or when the writer is
+   * destroyed), so the integrator can carry on in the meantime.
+   */
+  void DumpWriter::writeParallelEor(std::string* parts) {
+    int nProc;
+    MPI_Comm_size(MPI_COMM_WORLD, &nProc);
 
-    std::ostream* newOStream;
-#ifdef HAVE_ZLIB
     if (needCompression_) {
-      newOStream = new ogzstream(filename.c_str());
-    } else {
-      newOStream = new std::ofstream(filename.c_str());
+      std::string frame[2];
+      gatherParts(parts, 2, frame);
+      if (worldRank == 0) {
+        std::ostream* eorStream = createOStream(eorFilename_);
+        (*eorStream) << frame[0] << frame[1];
+        writeClosing(*eorStream);
+        delete eorStream;
+      }
+      return;
     }
-#else
-    newOStream = new std::ofstream(filename.c_str());
-#endif
-    //write out MetaData first
-    (*newOStream) << "<OpenMD version=2>" << std::endl;
-    (*newOStream) << "  <MetaData>" << std::endl;
-    (*newOStream) << info_->getRawMetaData();
-    (*newOStream) << "  </MetaData>" << std::endl;
-    return newOStream;
-  }
 
-  void DumpWriter::writeClosing(std::ostream& os) {
+    finishEor();
 
-    os << "</OpenMD>\n";
-    os.flush();
+    parallel_->eorParts[0] = parts[0];
+    parallel_->eorParts[1] = parts[1];
+    if (worldRank == 0) parallel_->eorParts[0].insert(0, prepareHeader(false));
+    if (worldRank == nProc - 1) parallel_->eorParts[1] += "</OpenMD>\n";
+
+    int err = MPI_File_open(MPI_COMM_WORLD, (char*)eorFilename_.c_str(),
+                            MPI_MODE_WRONLY | MPI_MODE_CREATE,
+                            MPI_INFO_NULL, &parallel_->eor);
+    if (err != MPI_SUCCESS) {
+      sprintf(painCave.errMsg, "Could not open \"%s\" for eor output.\n",
+              eorFilename_.c_str());
+      painCave.isFatal = 1;
+      simError();
+    }
+    MPI_File_set_size(parallel_->eor, 0);
+
+    std::vector<MPI_Offset> offsets;
+    getSliceOffsets(parallel_->eorParts, 2, 0, offsets);
+    for (int p = 0; p < 2; p++)
+      MPI_File_iwrite_at(parallel_->eor, offsets[p],
+                         (void*)parallel_->eorParts[p].data(),
+                         parallel_->eorParts[p].size(), MPI_CHAR,
+                         &parallel_->eorRequests[p]);
+    parallel_->eorPending = true;
+  }
+
+  void DumpWriter::finishEor() {
+    if (!parallel_->eorPending) return;
+    MPI_Waitall(2, parallel_->eorRequests, MPI_STATUSES_IGNORE);
+    MPI_File_close(&parallel_->eor);
+    parallel_->eorPending = false;
   }
 
+#endif // is_mpi
+
 }//end namespace OpenMD
@@ -55,10 +55,16 @@
 #include <cstdlib>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <vector>
+
+#ifdef IS_MPI
+#include <mpi.h>
+#endif
 
 #include "primitives/Atom.hpp"
 #include "brains/SimInfo.hpp"
 #include "brains/Thermo.hpp"
+#include "io/AsyncOutput.hpp"
 #include "primitives/StuntDouble.hpp"
 
 namespace OpenMD {
@@ -78,15 +84,65 @@ namespace OpenMD {
     void writeDumpAndEor();
     void writeDump();
     void writeEor();
+
+    /**
+     * Hands formatting and writing of the frames to an output thread.
+     * Each frame is staged in a copy of the current Snapshot (two are
+     * kept, so one can be staged while the other is being written).
+     * This is ignored in parallel, where the frames are written
+     * collectively.
+     */
+    void setAsyncOutput(AsyncOutput* async);
     
   private:  
         
-    void writeFrame(std::ostream& os);
+    void writeFrame(std::ostream& os, Snapshot* s);
     void writeFrameProperties(std::ostream& os, Snapshot* s);
-    std::string prepareDumpLine(StuntDouble* sd);
-    std::string prepareSiteLine(StuntDouble* sd, int ioIndex, int siteIndex);
-    std::ostream* createOStream(const std::string& filename);
+    std::string prepareDumpLine(StuntDouble* sd, Snapshot* s);
+    std::string prepareSiteLine(StuntDouble* sd, int ioIndex, int siteIndex,
+                                Snapshot* s);
+    std::ostream* createOStream(const std::string& filename,
+                                bool binary = false);
+    std::string prepareHeader(bool binary);
+    void openDumpFile();
     void writeClosing(std::ostream& os);
+
+    // binary trajectory format (see io/BinaryDump.hpp)
+    void setupDumpFormat(Globals* simParams);
+    void writeBinaryFrame(std::ostream& os, Snapshot* s);
+    void prepareBinaryBuffers(unsigned int& sdMask, unsigned int& siteMask,
+                              std::string& sdBuffer, std::string& siteBuffer,
+                              Snapshot* s);
+    std::string prepareBinaryHeader(unsigned int sdMask, unsigned int siteMask,
+                                    int nSD, int nSites,
+                                    unsigned long long frameBytes,
+                                    Snapshot* s);
+    void prepareBinaryRecord(StuntDouble* sd, unsigned int mask,
+                             std::string& buf, Snapshot* s);
+    void prepareBinarySiteRecord(StuntDouble* sd, int ioIndex, int siteIndex,
+                                 unsigned int mask, std::string& buf,
+                                 Snapshot* s);
+    void writeBinaryIndex(std::ostream& os);
+    std::string prepareBinaryIndex(long long indexStart);
+
+#ifdef IS_MPI
+    // parallel output: each node formats the objects it owns, and the
+    // pieces of a frame are laid out in the file in rank order.
+    void prepareFrameParts(std::string* parts);
+    MPI_Offset getSliceOffsets(std::string* parts, int nParts,
+                               MPI_Offset base,
+                               std::vector<MPI_Offset>& offsets);
+    void gatherParts(std::string* parts, int nParts, std::string* gathered);
+    void writeParallelDump(std::string* parts);
+    void writeParallelBinaryFrame();
+    void writeParallelEor(std::string* parts);
+    void finishEor();
+#endif
+
+    // asynchronous output (see setAsyncOutput):
+    class FrameTask;
+    void submitFrame(bool dump, bool eor);
+    unsigned long long writeStagedFrame(Snapshot* s, bool dump, bool eor);
     
     SimInfo* info_;
     std::string filename_;
@@ -101,6 +157,22 @@ namespace OpenMD {
     bool needDensity_;
     bool doSiteData_;
     bool createDumpFile_;
+
+    bool binary_;              /**< write the dump in the binary format */
+    RealType posPrecision_;    /**< position quantum (0 = lossless) */
+    std::vector<long long> frameOffsets_;
+    std::vector<RealType> frameTimes_;
+
+    // The layout of this class can't depend on IS_MPI, since it is
+    // also created from code that is compiled without it:
+    struct ParallelFiles;
+    ParallelFiles* parallel_;  /**< MPI-IO state (see DumpWriter.cpp) */
+    bool collective_;          /**< every node writes its own slice (MPI-IO) */
+
+    AsyncOutput* async_;       /**< output thread, or NULL */
+    Snapshot* staged_[2];      /**< frames waiting for the output thread */
+    long long stagedTicket_[2];
+    int nextStage_;
   };
 
 }
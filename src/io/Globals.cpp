@@ -88,6 +88,9 @@ namespace OpenMD {
     DefineOptionalParameter(ForceFieldVariant, "forceFieldVariant");
     DefineOptionalParameter(ForceFieldFileName, "forceFieldFileName");
     DefineOptionalParameter(DampingAlpha, "dampingAlpha");
+    DefineOptionalParameterWithDefaultValue(EwaldTolerance, "ewaldTolerance",
+                                            1.0e-5);
+    DefineOptionalParameter(SpmeOrder, "spmeOrder");
     DefineOptionalParameter(SurfaceTension, "surfaceTension");
     DefineOptionalParameter(PrintPressureTensor, "printPressureTensor");
     DefineOptionalParameter(PrintVirialTensor, "printVirialTensor");
@@ -132,6 +135,8 @@ namespace OpenMD {
                                             true);
     DefineOptionalParameterWithDefaultValue(UseLongRangeCorrections,
                                             "useLongRangeCorrections", true);
+    DefineOptionalParameterWithDefaultValue(UseDeterministicForces,
+                                            "useDeterministicForces", false);
     DefineOptionalParameterWithDefaultValue(UseInitalTime, "useInitialTime",
                                             false);
     DefineOptionalParameterWithDefaultValue(UseIntialExtendedSystemState,
@@ -149,6 +154,10 @@ namespace OpenMD {
     DefineOptionalParameterWithDefaultValue(Dielectric, "dielectric", 80.0);
     DefineOptionalParameterWithDefaultValue(CompressDumpFile,
                                             "compressDumpFile", false);
+    DefineOptionalParameterWithDefaultValue(AsyncOutput, "asyncOutput", false);
+    DefineOptionalParameterWithDefaultValue(DumpFileFormat, "dumpFileFormat",
+                                            "TEXT");
+    DefineOptionalParameter(DumpPositionPrecision, "dumpPositionPrecision");
     DefineOptionalParameterWithDefaultValue(PrintHeatFlux, "printHeatFlux",
                                             false);
     DefineOptionalParameterWithDefaultValue(OutputForceVector,
@@ -177,6 +186,13 @@ namespace OpenMD {
                                             "accumulateBoxDipole", false);
     DefineOptionalParameterWithDefaultValue(AccumulateBoxQuadrupole,
                                             "accumulateBoxQuadrupole", false);
+    DefineOptionalParameterWithDefaultValue(AccumulateStressCorrelation,
+                                            "accumulateStressCorrelation",
+                                            false);
+    DefineOptionalParameterWithDefaultValue(AccumulateCurrentCorrelation,
+                                            "accumulateCurrentCorrelation",
+                                            false);
+    DefineOptionalParameter(CorrelationSampleTime, "correlationSampleTime");
     DefineOptionalParameterWithDefaultValue(UseRestraints, "useRestraints",
                                             false);
     DefineOptionalParameterWithDefaultValue(Restraint_file, "Restraint_file",
@@ -239,6 +255,7 @@ namespace OpenMD {
     CheckParameter(SampleTime, isNonNegative());
     CheckParameter(ResetTime, isNonNegative());
     CheckParameter(StatusTime, isNonNegative());
+    CheckParameter(CorrelationSampleTime, isPositive());
     CheckParameter(CutoffRadius, isPositive());
     CheckParameter(SwitchingRadius, isNonNegative());
     CheckParameter(Dielectric, isPositive());
@@ -259,7 +276,8 @@ namespace OpenMD {
                    isEqualIgnoreCase("SHIFTED_POTENTIAL") ||
                    isEqualIgnoreCase("SHIFTED_FORCE") ||
                    isEqualIgnoreCase("TAYLOR_SHIFTED") ||
-                   isEqualIgnoreCase("EWALD_FULL"));
+                   isEqualIgnoreCase("EWALD_FULL") ||
+                   isEqualIgnoreCase("EWALD_SPME"));
     CheckParameter(ElectrostaticSummationMethod, isEqualIgnoreCase("NONE") ||
                    isEqualIgnoreCase("HARD") ||
                    isEqualIgnoreCase("SWITCHED") ||
@@ -274,7 +292,12 @@ namespace OpenMD {
                    isEqualIgnoreCase("FIFTH_ORDER_POLYNOMIAL"));
     CheckParameter(OrthoBoxTolerance, isPositive());
     CheckParameter(DampingAlpha,isNonNegative());
+    CheckParameter(EwaldTolerance, isPositive());
+    CheckParameter(SpmeOrder, isPositive());
     CheckParameter(SkinThickness, isPositive());
+    CheckParameter(DumpFileFormat, isEqualIgnoreCase("TEXT") ||
+                   isEqualIgnoreCase("BINARY"));
+    CheckParameter(DumpPositionPrecision, isPositive());
     CheckParameter(Viscosity, isNonNegative());
     CheckParameter(BeadSize, isPositive());
     CheckParameter(FrozenBufferRadius, isPositive());
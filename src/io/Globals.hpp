@@ -84,6 +84,7 @@ namespace OpenMD {
     DeclareParameter(TargetPressure, RealType);
     DeclareParameter(UseAtomicVirial, bool);
     DeclareParameter(UseLongRangeCorrections, bool);
+    DeclareParameter(UseDeterministicForces, bool);
     DeclareParameter(TauThermostat, RealType);
     DeclareParameter(TauBarostat, RealType);
     DeclareParameter(ZconsTime, RealType);
@@ -112,10 +113,15 @@ namespace OpenMD {
     DeclareParameter(UseSurfaceTerm, bool);
     DeclareParameter(UseSlabGeometry, bool);
     DeclareParameter(DampingAlpha, RealType);
+    DeclareParameter(EwaldTolerance, RealType);
+    DeclareParameter(SpmeOrder, int);
     DeclareParameter(Dielectric, RealType);
     DeclareParameter(CutoffMethod, std::string);
     DeclareParameter(SwitchingFunctionType, std::string);
     DeclareParameter(CompressDumpFile, bool);
+    DeclareParameter(AsyncOutput, bool);
+    DeclareAlterableParameter(DumpFileFormat, std::string);
+    DeclareAlterableParameter(DumpPositionPrecision, RealType);
     DeclareParameter(OutputForceVector, bool);
     DeclareParameter(OutputParticlePotential, bool);
     DeclareParameter(OutputElectricField, bool);
@@ -133,6 +139,9 @@ namespace OpenMD {
     DeclareParameter(LangevinBufferRadius, RealType);
     DeclareParameter(AccumulateBoxDipole, bool);
     DeclareParameter(AccumulateBoxQuadrupole, bool);
+    DeclareParameter(AccumulateStressCorrelation, bool);
+    DeclareParameter(AccumulateCurrentCorrelation, bool);
+    DeclareParameter(CorrelationSampleTime, RealType);
     DeclareParameter(NeighborListNeighbors, int);
     DeclareParameter(UseMultipleTemperatureMethod, bool);
     DeclareParameter(MTM_Ce, RealType);
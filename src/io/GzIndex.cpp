@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2009 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *                                                                      
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).             
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).          
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).          
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#define _LARGEFILE_SOURCE64
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include <cstring>
+#include <algorithm>
+#include "io/GzIndex.hpp"
+
+#ifdef _MSC_VER
+#define fseeko _fseeki64
+#endif
+
+namespace OpenMD {
+
+  template<typename T>
+  static void writeValue(std::ostream& os, T value) {
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template<typename T>
+  static bool readValue(std::istream& is, T& value) {
+    is.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return is.good();
+  }
+
+  GzIndex::GzIndex(const std::string& filename, long long span)
+    : filename_(filename), span_(span), scanFile_(NULL), scanning_(false),
+      error_(false), totalIn_(0), totalOut_(0), last_(0) {
+    memset(&strm_, 0, sizeof(strm_));
+  }
+
+  GzIndex::~GzIndex() {
+    if (scanning_) inflateEnd(&strm_);
+    if (scanFile_ != NULL) fclose(scanFile_);
+  }
+
+  bool GzIndex::beginScan() {
+    if (scanFile_ != NULL) fclose(scanFile_);
+    scanFile_ = fopen(filename_.c_str(), "rb");
+    if (scanFile_ == NULL) return false;
+
+    memset(&strm_, 0, sizeof(strm_));
+    memset(window_, 0, windowSize);
+    strm_.zalloc = Z_NULL;
+    strm_.zfree = Z_NULL;
+    strm_.opaque = Z_NULL;
+    strm_.avail_in = 0;
+    strm_.next_in = Z_NULL;
+    // 47 = 32 + 15: automatic zlib or gzip header detection
+    if (inflateInit2(&strm_, 47) != Z_OK) {
+      fclose(scanFile_);
+      scanFile_ = NULL;
+      return false;
+    }
+
+    points_.clear();
+    totalIn_ = 0;
+    totalOut_ = 0;
+    last_ = 0;
+    error_ = false;
+    scanning_ = true;
+    return true;
+  }
+
+  bool GzIndex::scanNext(std::string& chunk) {
+    chunk.clear();
+    if (!scanning_) return false;
+
+    if (strm_.avail_in == 0) {
+      strm_.avail_in = fread(input_, 1, chunkSize, scanFile_);
+      if (ferror(scanFile_) || strm_.avail_in == 0) {
+        // premature end of the compressed data:
+        error_ = true;
+        inflateEnd(&strm_);
+        scanning_ = false;
+        return false;
+      }
+      strm_.next_in = input_;
+    }
+
+    int ret;
+    do {
+      if (strm_.avail_out == 0) {
+        strm_.avail_out = windowSize;
+        strm_.next_out = window_;
+      }
+      unsigned char* start = strm_.next_out;
+
+      // inflate until the output buffer is full, the input is used up,
+      // or the end of a deflate block is reached:
+      totalIn_ += strm_.avail_in;
+      totalOut_ += strm_.avail_out;
+      ret = inflate(&strm_, Z_BLOCK);
+      totalIn_ -= strm_.avail_in;
+      totalOut_ -= strm_.avail_out;
+
+      chunk.append(reinterpret_cast<char*>(start), strm_.next_out - start);
+
+      if (ret == Z_NEED_DICT) ret = Z_DATA_ERROR;
+      if (ret == Z_MEM_ERROR || ret == Z_DATA_ERROR) {
+        error_ = true;
+        inflateEnd(&strm_);
+        scanning_ = false;
+        return false;
+      }
+      if (ret == Z_STREAM_END) break;
+
+      // At the end of a block (but not the last one), the inflater
+      // can be restarted given the bit offset and the 32 KB window:
+      if ((strm_.data_type & 128) && !(strm_.data_type & 64) &&
+          (totalOut_ == 0 || totalOut_ - last_ > span_)) {
+        addPoint(strm_.data_type & 7, totalIn_, totalOut_, strm_.avail_out);
+        last_ = totalOut_;
+      }
+    } while (strm_.avail_in != 0);
+
+    if (ret == Z_STREAM_END) {
+      inflateEnd(&strm_);
+      scanning_ = false;
+      fclose(scanFile_);
+      scanFile_ = NULL;
+    }
+    return true;
+  }
+
+  void GzIndex::addPoint(int bits, long long in, long long out,
+                         unsigned int left) {
+    AccessPoint p;
+    p.bits = bits;
+    p.in = in;
+    p.out = out;
+    p.window.resize(windowSize);
+    // the window is circular; left is the unused space at its end
+    if (left)
+      memcpy(&p.window[0], window_ + windowSize - left, left);
+    if (left < windowSize)
+      memcpy(&p.window[0] + left, window_, windowSize - left);
+    points_.push_back(p);
+  }
+
+  bool GzIndex::extract(long long offset, long long len, std::string& data) {
+    data.clear();
+    if (points_.empty() || offset < 0 || len < 0) return false;
+
+    // last access point at or before offset:
+    int k = 0;
+    int lo = 0;
+    int hi = points_.size() - 1;
+    while (lo <= hi) {
+      int mid = (lo + hi) / 2;
+      if (points_[mid].out <= offset) {
+        k = mid;
+        lo = mid + 1;
+      } else {
+        hi = mid - 1;
+      }
+    }
+    AccessPoint& p = points_[k];
+
+    FILE* in = fopen(filename_.c_str(), "rb");
+    if (in == NULL) return false;
+
+    z_stream strm;
+    memset(&strm, 0, sizeof(strm));
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    strm.avail_in = 0;
+    strm.next_in = Z_NULL;
+    if (inflateInit2(&strm, -15) != Z_OK) {   // raw inflate
+      fclose(in);
+      return false;
+    }
+
+    int ret = Z_OK;
+    if (fseeko(in, p.in - (p.bits ? 1 : 0), SEEK_SET) != 0) ret = Z_ERRNO;
+    if (ret == Z_OK && p.bits) {
+      int c = getc(in);
+      if (c == EOF)
+        ret = Z_DATA_ERROR;
+      else
+        inflatePrime(&strm, p.bits, c >> (8 - p.bits));
+    }
+    if (ret == Z_OK)
+      inflateSetDictionary(&strm, &p.window[0], windowSize);
+
+    std::vector<unsigned char> input(chunkSize);
+    std::vector<unsigned char> discard(windowSize);
+    long long skip = offset - p.out;
+    long long produced = 0;
+    data.resize(len);
+
+    while (ret == Z_OK && (skip > 0 || produced < len)) {
+      if (skip > 0) {
+        strm.next_out = &discard[0];
+        strm.avail_out = (uInt) std::min(skip, (long long) windowSize);
+      } else {
+        strm.next_out = reinterpret_cast<Bytef*>(&data[produced]);
+        strm.avail_out = (uInt) std::min(len - produced, 1LL << 30);
+      }
+      uInt requested = strm.avail_out;
+
+      while (strm.avail_out != 0) {
+        if (strm.avail_in == 0) {
+          strm.avail_in = fread(&input[0], 1, chunkSize, in);
+          if (ferror(in) || strm.avail_in == 0) {
+            ret = Z_DATA_ERROR;
+            break;
+          }
+          strm.next_in = &input[0];
+        }
+        ret = inflate(&strm, Z_NO_FLUSH);
+        if (ret == Z_NEED_DICT) ret = Z_DATA_ERROR;
+        if (ret != Z_OK) break;
+      }
+
+      uInt got = requested - strm.avail_out;
+      if (skip > 0)
+        skip -= got;
+      else
+        produced += got;
+    }
+
+    inflateEnd(&strm);
+    fclose(in);
+
+    data.resize(produced);
+    return (skip == 0 && produced == len);
+  }
+
+  void GzIndex::write(std::ostream& os) {
+    writeValue<long long>(os, totalOut_);
+    writeValue<long long>(os, (long long) points_.size());
+
+    std::vector<unsigned char> packed(compressBound(windowSize));
+    for (unsigned int i = 0; i < points_.size(); i++) {
+      uLongf packedSize = packed.size();
+      compress2(&packed[0], &packedSize, &points_[i].window[0], windowSize,
+                Z_DEFAULT_COMPRESSION);
+      writeValue<long long>(os, points_[i].out);
+      writeValue<long long>(os, points_[i].in);
+      writeValue<int>(os, points_[i].bits);
+      writeValue<int>(os, (int) packedSize);
+      os.write(reinterpret_cast<char*>(&packed[0]), packedSize);
+    }
+  }
+
+  bool GzIndex::read(std::istream& is) {
+    long long nPoints;
+    points_.clear();
+    if (!readValue(is, totalOut_) || !readValue(is, nPoints) || nPoints < 0)
+      return false;
+
+    std::vector<unsigned char> packed(compressBound(windowSize));
+    for (long long i = 0; i < nPoints; i++) {
+      AccessPoint p;
+      int packedSize;
+      if (!readValue(is, p.out) || !readValue(is, p.in) ||
+          !readValue(is, p.bits) || !readValue(is, packedSize))
+        return false;
+      if (packedSize <= 0 || packedSize > int(packed.size())) return false;
+      is.read(reinterpret_cast<char*>(&packed[0]), packedSize);
+      if (!is.good()) return false;
+
+      p.window.resize(windowSize);
+      uLongf windowLength = windowSize;
+      if (uncompress(&p.window[0], &windowLength, &packed[0], packedSize) !=
+          Z_OK || windowLength != (uLongf) windowSize)
+        return false;
+      points_.push_back(p);
+    }
+    return true;
+  }
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2009 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *                                                                      
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).             
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).          
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).          
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#ifndef IO_GZINDEX_HPP
+#define IO_GZINDEX_HPP
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+namespace OpenMD {
+
+  /**
+   * @class GzIndex GzIndex.hpp "io/GzIndex.hpp"
+   * Random access into a gzip compressed file.
+   *
+   * A single pass over the compressed file records access points at
+   * deflate block boundaries roughly every span bytes of uncompressed
+   * output.  Each access point stores the compressed and uncompressed
+   * offsets, the bit offset into the compressed byte, and the 32 KB
+   * of history needed to restart the inflater there.  Any range of
+   * the uncompressed data can then be extracted by inflating from the
+   * nearest access point, so the cost of a read no longer depends on
+   * where it is in the file.  This follows the zran example that is
+   * distributed with zlib.
+   */
+  class GzIndex {
+  public:
+    GzIndex(const std::string& filename, long long span = 4194304);
+    ~GzIndex();
+
+    /**
+     * Starts the indexing pass.  Returns false if the file can't be
+     * opened.
+     */
+    bool beginScan();
+
+    /**
+     * Inflates the next piece of the file during the indexing pass,
+     * recording access points as they are passed.  The new data is
+     * returned in chunk.  Returns false at the end of the compressed
+     * stream or on error (see hasError()).
+     */
+    bool scanNext(std::string& chunk);
+
+    /**
+     * Extracts len bytes of uncompressed data starting at the
+     * uncompressed offset.  Returns false on error.
+     */
+    bool extract(long long offset, long long len, std::string& data);
+
+    long long getUncompressedSize() { return totalOut_; }
+    int getNAccessPoints() { return points_.size(); }
+    bool hasError() { return error_; }
+
+    /** Serialization of the access points (windows are deflated) */
+    void write(std::ostream& os);
+    bool read(std::istream& is);
+
+  private:
+    static const int windowSize = 32768;
+    static const int chunkSize = 16384;
+
+    struct AccessPoint {
+      long long out;          /**< offset in the uncompressed data */
+      long long in;           /**< offset in the compressed file */
+      int bits;               /**< bits of the byte before in to use */
+      std::vector<unsigned char> window;
+    };
+
+    void addPoint(int bits, long long in, long long out, unsigned int left);
+
+    std::string filename_;
+    long long span_;
+    std::vector<AccessPoint> points_;
+
+    // state of the indexing pass:
+    FILE* scanFile_;
+    z_stream strm_;
+    bool scanning_;
+    bool error_;
+    long long totalIn_;
+    long long totalOut_;
+    long long last_;
+    unsigned char input_[chunkSize];
+    unsigned char window_[windowSize];
+  };
+}
+
+#endif
@@ -53,13 +53,14 @@
 #include "brains/Stats.hpp"
 #include "utils/simError.h"
 #include "utils/Revision.hpp"
+#include <sstream>
 
 using namespace std;
 
 namespace OpenMD {
 
   StatWriter::StatWriter( const std::string& filename, Stats* stats) :
-    stats_(stats){
+    stats_(stats), async_(NULL) {
     
 #ifdef IS_MPI
     if(worldRank == 0 ){
@@ -111,6 +112,7 @@ namespace OpenMD {
     if(worldRank == 0 ){
 #endif // is_mpi
 
+      if (async_ != NULL) async_->drain();
       statfile_.close();
 
 #ifdef IS_MPI
@@ -144,6 +146,26 @@ namespace OpenMD {
 #endif // is_mpi
   }
 
+  /**
+   * Writes one formatted line of the stat file on the output thread.
+   */
+  class StatWriter::LineTask : public OutputTask {
+  public:
+    LineTask(std::ofstream* statfile, const std::string& line) :
+      statfile_(statfile), line_(line) {}
+
+    unsigned long long run() {
+      (*statfile_) << line_;
+      statfile_->flush();
+      statfile_->rdbuf()->pubsync();
+      return line_.size();
+    }
+
+  private:
+    std::ofstream* statfile_;
+    std::string line_;
+  };
+
   void StatWriter::writeStat() {
 
 #ifdef IS_MPI
@@ -151,20 +173,21 @@ namespace OpenMD {
 #endif // is_mpi
 
       Stats::StatsBitSet mask = stats_->getStatsMask();
-      statfile_.precision( stats_->getPrecision() );
+      std::ostringstream line;
+      line.precision( stats_->getPrecision() );
 
       for (unsigned int i = 0; i < mask.size(); ++i) {
 	if (mask[i]) {
           if (stats_->getDataType(i) == "RealType")
-            writeReal(i);
+            writeReal(line, i);
           else if (stats_->getDataType(i) == "Vector3d")
-            writeVector(i);
+            writeVector(line, i);
           else if (stats_->getDataType(i) == "potVec")
-            writePotVec(i);
+            writePotVec(line, i);
           else if (stats_->getDataType(i) == "Mat3x3d")
-            writeMatrix(i);
+            writeMatrix(line, i);
           else if (stats_->getDataType(i) == "Array2d")
-            writeArray(i);
+            writeArray(line, i);
           else {
             sprintf( painCave.errMsg,
                      "StatWriter found an unknown data type for: %s ",
@@ -175,9 +198,15 @@ namespace OpenMD {
         }
       }
 
-      statfile_ << std::endl;
-      statfile_.flush();
-      statfile_.rdbuf()->pubsync();
+      line << std::endl;
+
+      if (async_ != NULL) {
+        async_->submit(new LineTask(&statfile_, line.str()));
+      } else {
+        statfile_ << line.str();
+        statfile_.flush();
+        statfile_.rdbuf()->pubsync();
+      }
 
 #ifdef IS_MPI
     }
@@ -185,13 +214,13 @@ namespace OpenMD {
 #endif // is_mpi
   }
 
-  void StatWriter::writeReal(int i) {
+  void StatWriter::writeReal(std::ostream& os, int i) {
 
     RealType s = stats_->getRealData(i);
 
 
     if (! std::isinf(s) && ! std::isnan(s)) {
-      statfile_ << "\t" << s;
+      os << "\t" << s;
     } else{
       sprintf( painCave.errMsg,
                "StatWriter detected a numerical error writing: %s ",
@@ -201,7 +230,7 @@ namespace OpenMD {
     }
   }
 
-  void StatWriter::writeVector(int i) {
+  void StatWriter::writeVector(std::ostream& os, int i) {
 
     Vector3d s = stats_->getVectorData(i);
     if (std::isinf(s[0]) || std::isnan(s[0]) ||
@@ -213,11 +242,11 @@ namespace OpenMD {
       painCave.isFatal = 1;
       simError();
     } else {
-      statfile_ << "\t" << s[0] << "\t" << s[1] << "\t" << s[2];
+      os << "\t" << s[0] << "\t" << s[1] << "\t" << s[2];
     }
   }
 
-  void StatWriter::writePotVec(int i) {
+  void StatWriter::writePotVec(std::ostream& os, int i) {
 
     potVec s = stats_->getPotVecData(i);
 
@@ -234,12 +263,12 @@ namespace OpenMD {
       simError();
     } else {
       for (unsigned int j = 0; j < N_INTERACTION_FAMILIES; j++) {
-        statfile_ << "\t" << s[j];
+        os << "\t" << s[j];
       }
     }
   }
 
-  void StatWriter::writeMatrix(int i) {
+  void StatWriter::writeMatrix(std::ostream& os, int i) {
 
     Mat3x3d s = stats_->getMatrixData(i);
 
@@ -252,13 +281,13 @@ namespace OpenMD {
           painCave.isFatal = 1;
           simError();
         } else {
-          statfile_ << "\t" << s(i1,j1);
+          os << "\t" << s(i1,j1);
         }
       }
     }
   }
 
-  void StatWriter::writeArray(int i) {
+  void StatWriter::writeArray(std::ostream& os, int i) {
     
     std::vector<RealType> s = stats_->getArrayData(i);
 
@@ -270,7 +299,7 @@ namespace OpenMD {
         painCave.isFatal = 1;
         simError();
       } else {
-        statfile_ << "\t" << s[j];
+        os << "\t" << s[j];
       }
     }    
   }
@@ -290,8 +319,11 @@ namespace OpenMD {
         simError();
       }
 
-      reportfile_ << stats_->getStatsReport();
-      std::cout << stats_->getStatsReport();        
+      std::string report = stats_->getStatsReport();
+      if (async_ != NULL) report += async_->getReport();
+
+      reportfile_ << report;
+      std::cout << report;
       reportfile_.close();
       
 #ifdef IS_MPI
@@ -44,6 +44,7 @@
 #define IO_STATWRITER_HPP
 
 #include "brains/Stats.hpp"
+#include "io/AsyncOutput.hpp"
 #include "utils/StringTokenizer.hpp"
 #include "utils/CaseConversion.hpp"
 #include "utils/simError.h"
@@ -62,20 +63,27 @@ namespace OpenMD {
     void writeStat();
     void writeStatReport();
     void setReportFileName(const std::string& rfn){ reportFileName_ = rfn; }
+    /**
+     * Lines are still formatted when writeStat is called, but writing
+     * and flushing them is left to the output thread.
+     */
+    void setAsyncOutput(AsyncOutput* async) { async_ = async; }
             
   private:
+    class LineTask;
     void writeTitle();
-    void writeReal(int i);
-    void writeVector(int i);
-    void writePotVec(int i);
-    void writeMatrix(int i);
-    void writeArray(int i);
+    void writeReal(std::ostream& os, int i);
+    void writeVector(std::ostream& os, int i);
+    void writePotVec(std::ostream& os, int i);
+    void writeMatrix(std::ostream& os, int i);
+    void writeArray(std::ostream& os, int i);
         
     std::ofstream statfile_;
     std::ofstream reportfile_;
     std::string reportFileName_;
     std::string version;
     Stats* stats_;
+    AsyncOutput* async_;
   };
 }
 #endif
@@ -205,11 +205,18 @@ RealType CubicSpline::getValueAt(const RealType& t) {
   // Output:
   //   value of spline at t.
   
-  if (!generated) generate();
+  if (!generated) {
+    // the coefficients are built lazily; only one thread may do this.
+#pragma omp critical (CubicSplineGenerate)
+    if (!generated) generate();
+  }
   
   assert(t >= x_.front());
   assert(t <= x_.back());
 
+  int j;
+  RealType dt;
+
   //  Find the interval ( x[j], x[j+1] ) that contains or is nearest
   //  to t.
 
@@ -244,11 +251,18 @@ void CubicSpline::getValueAt(const RealType& t, RealType& v) {
   // Output:
   //   value of spline at t.
   
-  if (!generated) generate();
+  if (!generated) {
+    // the coefficients are built lazily; only one thread may do this.
+#pragma omp critical (CubicSplineGenerate)
+    if (!generated) generate();
+  }
   
   assert(t >= x_.front());
   assert(t <= x_.back());
 
+  int j;
+  RealType dt;
+
   //  Find the interval ( x[j], x[j+1] ) that contains or is nearest
   //  to t.
 
@@ -275,17 +289,51 @@ void CubicSpline::getValueAt(const RealType& t, RealType& v) {
 }
 
 pair<RealType, RealType> CubicSpline::getLimits(){
-  if (!generated) generate();
+  if (!generated) {
+    // the coefficients are built lazily; only one thread may do this.
+#pragma omp critical (CubicSplineGenerate)
+    if (!generated) generate();
+  }
   return make_pair( x_.front(), x_.back() );
 }
 
 RealType CubicSpline::getSpacing(){
-  if (!generated) generate();
+  if (!generated) {
+    // the coefficients are built lazily; only one thread may do this.
+#pragma omp critical (CubicSplineGenerate)
+    if (!generated) generate();
+  }
   assert(isUniform);
   if (isUniform) return 1.0/dx;
   else return 0.0;
 }
 
+bool CubicSpline::isUniformlySpaced(){
+  if (!generated) {
+    // the coefficients are built lazily; only one thread may do this.
+#pragma omp critical (CubicSplineGenerate)
+    if (!generated) generate();
+  }
+  return isUniform;
+}
+
+void CubicSpline::getCoefficients(vector<RealType>& x, vector<RealType>& y,
+                                  vector<RealType>& bc, vector<RealType>& cc,
+                                  vector<RealType>& dc) {
+  // The spline on [x[i], x[i+1]] is 
+  //   y[i] + dt*(bc[i] + dt*(cc[i] + dt*dc[i]))  with dt = t - x[i]
+  if (!generated) {
+    // the coefficients are built lazily; only one thread may do this.
+#pragma omp critical (CubicSplineGenerate)
+    if (!generated) generate();
+  }
+  x = x_;
+  y = y_;
+  bc = b;
+  cc = c;
+  dc = d;
+}
+
 void CubicSpline::getValueAndDerivativeAt(const RealType& t, RealType& v, 
                                           RealType &dv) {
   // Evaluate the spline and first derivative at t using coefficients 
@@ -293,11 +341,18 @@ void CubicSpline::getValueAndDerivativeAt(const RealType& t, RealType& v,
   // Input parameters
   //   t = point where spline is to be evaluated.
 
-  if (!generated) generate();
+  if (!generated) {
+    // the coefficients are built lazily; only one thread may do this.
+#pragma omp critical (CubicSplineGenerate)
+    if (!generated) generate();
+  }
   
   assert(t >= x_.front());
   assert(t <= x_.back());
 
+  int j;
+  RealType dt;
+
   //  Find the interval ( x[j], x[j+1] ) that contains or is nearest
   //  to t.
 
@@ -61,6 +61,10 @@ namespace OpenMD {
     void getValueAt(const RealType& t, RealType& v);
     void getValueAndDerivativeAt(const RealType& t, RealType& v, RealType& d);
     RealType getSpacing();
+    bool isUniformlySpaced();
+    void getCoefficients(vector<RealType>& x, vector<RealType>& y,
+                         vector<RealType>& b, vector<RealType>& c,
+                         vector<RealType>& d);
     
   private:
     void generate();
@@ -70,8 +74,8 @@ namespace OpenMD {
     
     bool isUniform;
     bool generated;
-    RealType dx, dt, yval, dydx;
-    int n, j;
+    RealType dx;
+    int n;
     vector<RealType> x_;
     vector<RealType> y_;
     vector<RealType> b;
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2005 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#include "math/FFT.hpp"
+#include "utils/Constants.hpp"
+#include <cmath>
+
+using namespace std;
+namespace OpenMD {
+
+  FFT::FFT(int n) {
+    resize(n);
+  }
+
+  void FFT::resize(int n) {
+    n_ = max(1, n);
+
+    // factor the length, pulling out the efficient radices first:
+    factors_.clear();
+    int m = n_;
+    int radices[] = {4, 2, 3, 5};
+    for (int r = 0; r < 4; r++) {
+      while (m % radices[r] == 0) {
+        factors_.push_back(radices[r]);
+        m /= radices[r];
+      }
+    }
+    for (int p = 7; m > 1; p += 2) {
+      while (m % p == 0) {
+        factors_.push_back(p);
+        m /= p;
+      }
+    }
+
+    twiddle_.resize(n_);
+    for (int j = 0; j < n_; j++) {
+      RealType phase = -2.0 * Constants::PI * RealType(j) / RealType(n_);
+      twiddle_[j] = ComplexType(cos(phase), sin(phase));
+    }
+  }
+
+  int FFT::goodSize(int n) {
+    int m = max(1, n);
+    while (true) {
+      int r = m;
+      while (r % 2 == 0) r /= 2;
+      while (r % 3 == 0) r /= 3;
+      while (r % 5 == 0) r /= 5;
+      if (r == 1) return m;
+      m++;
+    }
+  }
+
+  /**
+   * Recursive decimation-in-time Cooley-Tukey step.  The n values of
+   * in (separated by stride) are split into p interleaved subsequences
+   * of length m = n/p which are transformed into consecutive blocks of
+   * out, and then combined with a radix-p butterfly.
+   */
+  void FFT::recurse(const ComplexType* in, ComplexType* out, int n,
+                    int stride, int level, bool inverse) const {
+    if (n == 1) {
+      out[0] = in[0];
+      return;
+    }
+
+    int p = factors_[level];
+    int m = n / p;
+    int tstep = n_ / n;
+
+    for (int r = 0; r < p; r++)
+      recurse(in + r * stride, out + r * m, m, stride * p, level + 1, inverse);
+
+    ComplexType tmp[64];
+    vector<ComplexType> bigTmp;
+    ComplexType* t = tmp;
+    if (p > 64) {
+      bigTmp.resize(p);
+      t = &bigTmp[0];
+    }
+
+    for (int s = 0; s < m; s++) {
+      for (int r = 0; r < p; r++) t[r] = out[r * m + s];
+
+      for (int q = 0; q < p; q++) {
+        int k = q * m + s;
+        ComplexType sum = t[0];
+        for (int r = 1; r < p; r++) {
+          ComplexType w = twiddle_[((long)r * k * tstep) % n_];
+          if (inverse) w = conj(w);
+          sum += t[r] * w;
+        }
+        out[k] = sum;
+      }
+    }
+  }
+
+  void FFT::transform(ComplexType* data, int stride, bool inverse,
+                      ComplexType* scratch) const {
+    if (n_ == 1) return;
+    ComplexType* in = scratch;
+    ComplexType* out = scratch + n_;
+    for (int j = 0; j < n_; j++) in[j] = data[j * stride];
+    recurse(in, out, n_, 1, 0, inverse);
+    for (int j = 0; j < n_; j++) data[j * stride] = out[j];
+  }
+
+  void FFT::forward(vector<ComplexType>& data) const {
+    vector<ComplexType> scratch(2 * n_);
+    transform(&data[0], 1, false, &scratch[0]);
+  }
+
+  void FFT::backward(vector<ComplexType>& data) const {
+    vector<ComplexType> scratch(2 * n_);
+    transform(&data[0], 1, true, &scratch[0]);
+  }
+
+  void FFT3D::resize(int nx, int ny, int nz) {
+    nx_ = nx;
+    ny_ = ny;
+    nz_ = nz;
+    fx_.resize(nx);
+    fy_.resize(ny);
+    fz_.resize(nz);
+  }
+
+  void FFT3D::transform(vector<ComplexType>& data, bool inverse) const {
+    int nMax = max(nx_, max(ny_, nz_));
+
+    // along z (contiguous):
+#pragma omp parallel
+    {
+      vector<ComplexType> scratch(2 * nMax);
+#pragma omp for schedule(static)
+      for (int ij = 0; ij < nx_ * ny_; ij++)
+        fz_.transform(&data[ij * nz_], 1, inverse, &scratch[0]);
+
+      // along y:
+#pragma omp for schedule(static)
+      for (int ik = 0; ik < nx_ * nz_; ik++) {
+        int i = ik / nz_;
+        int k = ik % nz_;
+        fy_.transform(&data[i * ny_ * nz_ + k], nz_, inverse, &scratch[0]);
+      }
+
+      // along x:
+#pragma omp for schedule(static)
+      for (int jk = 0; jk < ny_ * nz_; jk++)
+        fx_.transform(&data[jk], ny_ * nz_, inverse, &scratch[0]);
+    }
+  }
+}
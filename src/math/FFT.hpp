@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2005 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#ifndef MATH_FFT_HPP
+#define MATH_FFT_HPP
+
+#include "config.h"
+#include <vector>
+#include <complex>
+
+namespace OpenMD {
+
+  typedef std::complex<RealType> ComplexType;
+
+  /**
+   * @class FFT FFT.hpp "math/FFT.hpp"
+   * A self-contained, mixed-radix complex Fast Fourier Transform for
+   * arbitrary transform lengths.  Lengths whose only prime factors
+   * are 2, 3 and 5 are the most efficient (see goodSize).
+   *
+   * The forward transform uses exp(-2 pi i j k / n), the backward
+   * transform uses exp(+2 pi i j k / n), and neither is normalized.
+   */
+  class FFT {
+  public:
+    FFT(int n = 1);
+    void resize(int n);
+    int size() const { return n_; }
+
+    void forward(std::vector<ComplexType>& data) const;
+    void backward(std::vector<ComplexType>& data) const;
+
+    /**
+     * Transforms n values starting at data and separated by stride.
+     * scratch must hold at least 2n values.
+     */
+    void transform(ComplexType* data, int stride, bool inverse,
+                   ComplexType* scratch) const;
+
+    /** Smallest length >= n that has no prime factors larger than 5. */
+    static int goodSize(int n);
+
+  private:
+    void recurse(const ComplexType* in, ComplexType* out, int n,
+                 int stride, int level, bool inverse) const;
+
+    int n_;
+    std::vector<int> factors_;
+    std::vector<ComplexType> twiddle_;  /**< exp(-2 pi i j / n) */
+  };
+
+  /**
+   * @class FFT3D FFT.hpp "math/FFT.hpp"
+   * Complex 3-D transforms on a row-major (x slowest, z fastest) grid,
+   * done as successive 1-D transforms along each axis.
+   */
+  class FFT3D {
+  public:
+    FFT3D() : nx_(0), ny_(0), nz_(0) {}
+    FFT3D(int nx, int ny, int nz) { resize(nx, ny, nz); }
+    void resize(int nx, int ny, int nz);
+
+    void forward(std::vector<ComplexType>& data) const {
+      transform(data, false);
+    }
+    void backward(std::vector<ComplexType>& data) const {
+      transform(data, true);
+    }
+
+  private:
+    void transform(std::vector<ComplexType>& data, bool inverse) const;
+
+    int nx_, ny_, nz_;
+    FFT fx_, fy_, fz_;
+  };
+}
+
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2005 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#include "math/MultipleTauCorrelator.hpp"
+#include <algorithm>
+
+namespace OpenMD {
+
+  MultipleTauCorrelator::MultipleTauCorrelator(int nComponents, int nLevels,
+                                               int p, int m) :
+    nComponents_(nComponents), nValues_(nComponents + 1), p_(p), m_(m) {
+
+    levels_.resize(std::max(1, nLevels));
+    for (unsigned int l = 0; l < levels_.size(); l++) {
+      levels_[l].history1.resize(p_ * nValues_, 0.0);
+      levels_[l].history2.resize(p_ * nValues_, 0.0);
+      levels_[l].corr.resize(p_ * nValues_, 0.0);
+      levels_[l].accum1.resize(nValues_, 0.0);
+      levels_[l].accum2.resize(nValues_, 0.0);
+      levels_[l].head = p_ - 1;
+      levels_[l].filled = 0;
+      levels_[l].nAccum = 0;
+    }
+    v1_.resize(nValues_);
+    v2_.resize(nValues_);
+  }
+
+  int MultipleTauCorrelator::levelsForLag(int maxLag, int p, int m) {
+    int nLevels = 1;
+    long longest = p - 1;
+    while (longest < maxLag) {
+      longest *= m;
+      nLevels++;
+    }
+    return nLevels;
+  }
+
+  void MultipleTauCorrelator::add(const RealType* a, const RealType* b) {
+    for (int k = 0; k < nComponents_; k++) {
+      v1_[k] = a ? a[k] : 0.0;
+      v2_[k] = b ? b[k] : 0.0;
+    }
+    v1_[nComponents_] = a ? 1.0 : 0.0;
+    v2_[nComponents_] = b ? 1.0 : 0.0;
+    insert(0, &v1_[0], &v2_[0]);
+  }
+
+  void MultipleTauCorrelator::insert(int level, const RealType* v1,
+                                     const RealType* v2) {
+    Level& lev = levels_[level];
+
+    lev.head = (lev.head + 1) % p_;
+    std::copy(v1, v1 + nValues_, lev.history1.begin() + lev.head * nValues_);
+    std::copy(v2, v2 + nValues_, lev.history2.begin() + lev.head * nValues_);
+    if (lev.filled < p_) lev.filled++;
+
+    // the new b sample closes a pair with every a sample in the
+    // history.  Lags below p/m on the upper levels are already
+    // covered (more finely) by the level below:
+    int jmin = (level == 0) ? 0 : p_ / m_;
+    for (int j = jmin; j < lev.filled; j++) {
+      int slot = (lev.head - j + p_) % p_;
+      const RealType* h1 = &lev.history1[slot * nValues_];
+      RealType* c = &lev.corr[j * nValues_];
+      for (int k = 0; k < nValues_; k++) c[k] += h1[k] * v2[k];
+    }
+
+    if (level + 1 < int(levels_.size())) {
+      for (int k = 0; k < nValues_; k++) {
+        lev.accum1[k] += v1[k];
+        lev.accum2[k] += v2[k];
+      }
+      lev.nAccum++;
+      if (lev.nAccum == m_) {
+        for (int k = 0; k < nValues_; k++) {
+          lev.accum1[k] /= RealType(m_);
+          lev.accum2[k] /= RealType(m_);
+        }
+        insert(level + 1, &lev.accum1[0], &lev.accum2[0]);
+        std::fill(lev.accum1.begin(), lev.accum1.end(), 0.0);
+        std::fill(lev.accum2.begin(), lev.accum2.end(), 0.0);
+        lev.nAccum = 0;
+      }
+    }
+  }
+
+  std::vector<int> MultipleTauCorrelator::getLags() {
+    std::vector<int> lags;
+    int scale = 1;
+    for (unsigned int l = 0; l < levels_.size(); l++) {
+      int jmin = (l == 0) ? 0 : p_ / m_;
+      for (int j = jmin; j < p_; j++) lags.push_back(j * scale);
+      scale *= m_;
+    }
+    return lags;
+  }
+
+  void MultipleTauCorrelator::addTo(std::vector<RealType>& sums,
+                                    std::vector<RealType>& counts) {
+    int index = 0;
+    for (unsigned int l = 0; l < levels_.size(); l++) {
+      int jmin = (l == 0) ? 0 : p_ / m_;
+      for (int j = jmin; j < p_; j++) {
+        const RealType* c = &levels_[l].corr[j * nValues_];
+        for (int k = 0; k < nComponents_; k++)
+          sums[index * nComponents_ + k] += c[k];
+        counts[index] += c[nComponents_];
+        index++;
+      }
+    }
+  }
+}
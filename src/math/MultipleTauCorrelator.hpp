@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2005 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#ifndef MATH_MULTIPLETAUCORRELATOR_HPP
+#define MATH_MULTIPLETAUCORRELATOR_HPP
+
+#include "config.h"
+#include <vector>
+
+namespace OpenMD {
+
+  /**
+   * @class MultipleTauCorrelator MultipleTauCorrelator.hpp "math/MultipleTauCorrelator.hpp"
+   * An on-the-fly correlator for streams of samples with hierarchical
+   * (multiple-tau) lag times.
+   *
+   * Every sample carries nComponents values for each of the two
+   * quantities being correlated, and the correlator accumulates
+   * sum_t0 a_k(t0) * b_k(t0 + t) for each component k.  Level 0 keeps
+   * the last p samples and covers lags 0 .. p-1.  Every m samples
+   * of level l are averaged into one sample of level l+1, which
+   * covers lags (p/m .. p-1) * m^(l+1).  The memory needed is
+   * O(nComponents p nLevels) no matter how long the stream is, while
+   * the longest lag is (p-1) m^(nLevels-1) samples.
+   *
+   * Samples in which either quantity is missing can be added with a
+   * NULL pointer; a presence mask is correlated alongside the
+   * components to count the contributing pairs at every lag.  See:
+   * Ramirez, et al., J. Chem. Phys. 133, 154103 (2010).
+   */
+  class MultipleTauCorrelator {
+  public:
+    MultipleTauCorrelator(int nComponents, int nLevels, int p = 16,
+                          int m = 2);
+
+    /** Smallest number of levels that reaches a lag of maxLag samples */
+    static int levelsForLag(int maxLag, int p = 16, int m = 2);
+
+    /**
+     * Adds the next sample.  a or b may be NULL if that quantity is
+     * missing from this sample.
+     */
+    void add(const RealType* a, const RealType* b);
+
+    int getNComponents() { return nComponents_; }
+
+    /** Lag times (in samples) in the order used by addTo */
+    std::vector<int> getLags();
+
+    /**
+     * Adds this correlator's sums into sums[lag * nComponents + k]
+     * and the number of contributing pairs into counts[lag].
+     */
+    void addTo(std::vector<RealType>& sums, std::vector<RealType>& counts);
+
+  private:
+    struct Level {
+      std::vector<RealType> history1;  /**< last p samples of a (and mask) */
+      std::vector<RealType> history2;  /**< last p samples of b (and mask) */
+      std::vector<RealType> corr;      /**< sums for each lag on this level */
+      std::vector<RealType> accum1;    /**< block sums passed to the next level */
+      std::vector<RealType> accum2;
+      int head;
+      int filled;
+      int nAccum;
+    };
+
+    void insert(int level, const RealType* v1, const RealType* v2);
+
+    int nComponents_;
+    int nValues_;                      /**< components plus the mask */
+    int p_;
+    int m_;
+    std::vector<Level> levels_;
+    std::vector<RealType> v1_;
+    std::vector<RealType> v2_;
+  };
+}
+#endif
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2005 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *                                                                      
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).             
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).          
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).          
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#include "math/UniformSpline.hpp"
+#include <cstdio>
+#include "utils/simError.h"
+
+using namespace OpenMD;
+using namespace std;
+
+UniformSpline::UniformSpline(CubicSpline* cs) {
+  setup(*cs);
+}
+
+UniformSpline::UniformSpline(const vector<RealType>& x,
+                             const vector<RealType>& y) {
+  CubicSpline cs;
+  cs.addPoints(x, y);
+  setup(cs);
+}
+
+void UniformSpline::setup(CubicSpline& cs) {
+  vector<RealType> x, y, b, c, d;
+
+  if (!cs.isUniformlySpaced()) {
+    sprintf(painCave.errMsg,
+            "UniformSpline: the spline points are not uniformly spaced.\n");
+    painCave.severity = OPENMD_ERROR;
+    painCave.isFatal = 1;
+    simError();
+  }
+
+  cs.getCoefficients(x, y, b, c, d);
+
+  n_ = x.size();
+  xFirst_ = x.front();
+  xLast_ = x.back();
+  // same interval arithmetic as CubicSpline:
+  dx_ = 1.0 / (x[1] - x[0]);
+  spacing_ = 1.0 / dx_;
+
+  coefficients_.resize(Stride * n_);
+  for (int i = 0; i < n_; i++) {
+    coefficients_[Stride * i]     = x[i];
+    coefficients_[Stride * i + 1] = y[i];
+    coefficients_[Stride * i + 2] = b[i];
+    coefficients_[Stride * i + 3] = c[i];
+    coefficients_[Stride * i + 4] = d[i];
+  }
+}
+
+void UniformSpline::getValuesAt(const RealType* t, RealType* v,
+                                int count) const {
+  const RealType* coef = &coefficients_[0];
+#pragma omp simd
+  for (int i = 0; i < count; i++) {
+    int j = max(0, min(n_ - 1, int((t[i] - xFirst_) * dx_)));
+    const RealType* k = coef + Stride * j;
+    RealType dt = t[i] - k[0];
+    v[i] = k[1] + dt*(k[2] + dt*(k[3] + dt*k[4]));
+  }
+}
+
+void UniformSpline::getValuesAndDerivativesAt(const RealType* t, RealType* v,
+                                              RealType* dv, int count) const {
+  const RealType* coef = &coefficients_[0];
+#pragma omp simd
+  for (int i = 0; i < count; i++) {
+    int j = max(0, min(n_ - 1, int((t[i] - xFirst_) * dx_)));
+    const RealType* k = coef + Stride * j;
+    RealType dt = t[i] - k[0];
+    v[i] = k[1] + dt*(k[2] + dt*(k[3] + dt*k[4]));
+    dv[i] = k[2] + dt*(2.0 * k[3] + 3.0 * dt * k[4]);
+  }
+}
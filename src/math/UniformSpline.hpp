@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2005 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *                                                                      
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).             
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).          
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).          
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#ifndef MATH_UNIFORMSPLINE_HPP
+#define MATH_UNIFORMSPLINE_HPP
+
+#include "config.h"
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include "math/CubicSpline.hpp"
+
+using namespace std;
+namespace OpenMD {
+
+  /**
+   * @class UniformSpline
+   * @brief An immutable cubic spline table on a uniform grid.
+   *
+   * The coefficients are taken from a CubicSpline when the table is
+   * constructed, so lookups never modify the table and a single table
+   * can be shared by all of the threads in the pair loop.  The
+   * interval is found in O(1) from the grid spacing, and the knot
+   * position and the four coefficients of each interval are stored
+   * next to each other so that a lookup touches a single small block
+   * of memory.  Values are identical to those of the CubicSpline the
+   * table was built from.
+   */
+  class UniformSpline {
+  public:
+    UniformSpline(CubicSpline* cs);
+    UniformSpline(const vector<RealType>& x, const vector<RealType>& y);
+
+    RealType getValueAt(const RealType& t) const {
+      const RealType* k = interval(t);
+      RealType dt = t - k[0];
+      return k[1] + dt*(k[2] + dt*(k[3] + dt*k[4]));
+    }
+
+    void getValueAt(const RealType& t, RealType& v) const {
+      v = getValueAt(t);
+    }
+
+    void getValueAndDerivativeAt(const RealType& t, RealType& v,
+                                 RealType& dv) const {
+      const RealType* k = interval(t);
+      RealType dt = t - k[0];
+      v = k[1] + dt*(k[2] + dt*(k[3] + dt*k[4]));
+      dv = k[2] + dt*(2.0 * k[3] + 3.0 * dt * k[4]);
+    }
+
+    /**
+     * Evaluates the spline at count points.  The loop has no
+     * dependencies between iterations, so it can be vectorized.
+     */
+    void getValuesAt(const RealType* t, RealType* v, int count) const;
+    void getValuesAndDerivativesAt(const RealType* t, RealType* v,
+                                   RealType* dv, int count) const;
+
+    pair<RealType, RealType> getLimits() const {
+      return make_pair(xFirst_, xLast_);
+    }
+    RealType getSpacing() const { return spacing_; }
+
+  private:
+    void setup(CubicSpline& cs);
+
+    enum { Stride = 5 };  /**< x, y, b, c, d for each knot */
+
+    const RealType* interval(const RealType& t) const {
+      assert(t >= xFirst_);
+      assert(t <= xLast_);
+      int j = max(0, min(n_ - 1, int((t - xFirst_) * dx_)));
+      return &coefficients_[Stride * j];
+    }
+
+    int n_;
+    RealType xFirst_;
+    RealType xLast_;
+    RealType spacing_;
+    RealType dx_;         /**< inverse of the spacing */
+    vector<RealType> coefficients_;
+  };
+}
+
+#endif
@@ -51,7 +51,8 @@ namespace OpenMD {
     SHIFTED_POTENTIAL,
     SHIFTED_FORCE,
     TAYLOR_SHIFTED,
-    EWALD_FULL
+    EWALD_FULL,
+    EWALD_SPME
   };
 
 }
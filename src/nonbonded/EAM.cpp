@@ -206,10 +206,10 @@ namespace OpenMD {
   }
 
 
-  CubicSpline* EAM::getPhi(AtomType* atomType1, AtomType* atomType2) {
+  UniformSpline* EAM::getPhi(AtomType* atomType1, AtomType* atomType2) {
     EAMAdapter ea1 = EAMAdapter(atomType1);
     EAMAdapter ea2 = EAMAdapter(atomType2);
-    CubicSpline* cs = new CubicSpline();
+    CubicSpline cs;
 
     RealType rha(0.0), rhb(0.0), pha(0.0), phb(0.0), phab(0.0);
     vector<RealType> rvals;
@@ -298,7 +298,7 @@ namespace OpenMD {
         }
         phivals.push_back(phab);
       }
-      cs->addPoints(rvals, phivals);
+      cs.addPoints(rvals, phivals);
     } else {
 
       EAMAtomData &data1 = EAMdata[EAMtids[ atomType1->getIdent() ]];
@@ -366,10 +366,10 @@ namespace OpenMD {
         phivals.push_back(phab);
 
       }
-      cs->addPoints(rvals, phivals);
+      cs.addPoints(rvals, phivals);
     }
 
-    return cs;
+    return new UniformSpline(&cs);
   }
 
   void EAM::setCutoffRadius( RealType rCut ) {
@@ -498,9 +498,13 @@ namespace OpenMD {
 
     switch(et) {
     case eamFuncfl: {
-      eamAtomData.rho = ea.getRhoSpline();
-      eamAtomData.F = ea.getFSpline();
+      CubicSpline* rho = ea.getRhoSpline();
+      CubicSpline* F = ea.getFSpline();
+      eamAtomData.rho = new UniformSpline(rho);
+      eamAtomData.F = new UniformSpline(F);
       eamAtomData.Z = ea.getZSpline();
+      delete rho;
+      delete F;
       eamAtomData.rcut = ea.getRcut();
       break;
     }
@@ -555,12 +559,9 @@ namespace OpenMD {
         ccvals.push_back( phiCC );
         cvvals.push_back( phiCV );
       }
-      eamAtomData.rho = new CubicSpline();
-      eamAtomData.rho->addPoints(rvals, rhovals);
-      eamAtomData.phiCC = new CubicSpline();
-      eamAtomData.phiCC->addPoints(rvals, ccvals);
-      eamAtomData.phiCV = new CubicSpline();
-      eamAtomData.phiCV->addPoints(rvals, cvvals);
+      eamAtomData.rho = new UniformSpline(rvals, rhovals);
+      eamAtomData.phiCC = new UniformSpline(rvals, ccvals);
+      eamAtomData.phiCV = new UniformSpline(rvals, cvvals);
 
       rhovals.clear();
       if (et == eamZhou2001) {
@@ -599,8 +600,7 @@ namespace OpenMD {
         }
       }
 
-      eamAtomData.F = new CubicSpline();
-      eamAtomData.F->addPoints(rhovals, funcvals);
+      eamAtomData.F = new UniformSpline(rhovals, funcvals);
       break;
     }
     case eamOxygenFuncfl: {
@@ -644,15 +644,14 @@ namespace OpenMD {
         ccvals.push_back( phiCC );
         cvvals.push_back( phiCV );
       }
-      eamAtomData.rho = new CubicSpline();
-      eamAtomData.rho->addPoints(rvals, rhovals);
-      eamAtomData.phiCC = new CubicSpline();
-      eamAtomData.phiCC->addPoints(rvals, ccvals);
-      eamAtomData.phiCV = new CubicSpline();
-      eamAtomData.phiCV->addPoints(rvals, cvvals);
+      eamAtomData.rho = new UniformSpline(rvals, rhovals);
+      eamAtomData.phiCC = new UniformSpline(rvals, ccvals);
+      eamAtomData.phiCV = new UniformSpline(rvals, cvvals);
 
       
-      eamAtomData.F = ea.getFSpline();
+      CubicSpline* F = ea.getFSpline();
+      eamAtomData.F = new UniformSpline(F);
+      delete F;
       break;
     }
     case eamZhou2005Oxygen : {
@@ -701,12 +700,9 @@ namespace OpenMD {
         ccvals.push_back( phiCC );
         cvvals.push_back( phiCV );
       }
-      eamAtomData.rho = new CubicSpline();
-      eamAtomData.rho->addPoints(rvals, rhovals);
-      eamAtomData.phiCC = new CubicSpline();
-      eamAtomData.phiCC->addPoints(rvals, ccvals);
-      eamAtomData.phiCV = new CubicSpline();
-      eamAtomData.phiCV->addPoints(rvals, cvvals);
+      eamAtomData.rho = new UniformSpline(rvals, rhovals);
+      eamAtomData.phiCC = new UniformSpline(rvals, ccvals);
+      eamAtomData.phiCV = new UniformSpline(rvals, cvvals);
 
       rhovals.clear();
       for (int i = 0; i < Nrho; i++) {
@@ -716,8 +712,7 @@ namespace OpenMD {
                                                      OF) );
       }
 
-      eamAtomData.F = new CubicSpline();
-      eamAtomData.F->addPoints(rhovals, funcvals);
+      eamAtomData.F = new UniformSpline(rhovals, funcvals);
       break;
     }
 
@@ -792,13 +787,13 @@ namespace OpenMD {
                                    vector<RealType> phiVals) {
 
     EAMInteractionData mixer;
-    CubicSpline* cs = new CubicSpline();
+    CubicSpline cs;
     vector<RealType> rVals;
 
     for (int i = 0; i < nr; i++) rVals.push_back(i * dr);
 
-    cs->addPoints(rVals, phiVals);
-    mixer.phi = cs;
+    cs.addPoints(rVals, phiVals);
+    mixer.phi = new UniformSpline(&cs);
     mixer.rcut = mixer.phi->getLimits().second;
     mixer.explicitlySet = true;
 
@@ -847,7 +842,7 @@ namespace OpenMD {
                                    RealType lambda) {
 
     EAMInteractionData mixer;
-    CubicSpline* cs = new CubicSpline();
+    CubicSpline cs;
     std::vector<RealType> rVals;
     std::vector<RealType> phiVals;
     std::vector<RealType> jVals;
@@ -867,8 +862,8 @@ namespace OpenMD {
                                  kappa, lambda) );
     }
 
-    cs->addPoints(rVals, phiVals);
-    mixer.phi = cs;
+    cs.addPoints(rVals, phiVals);
+    mixer.phi = new UniformSpline(&cs);
     mixer.rcut = mixer.phi->getLimits().second;
     mixer.explicitlySet = true;
 
@@ -985,16 +980,16 @@ namespace OpenMD {
     RealType phab(0.0), dvpdr(0.0);
     RealType drhoidr(0.0), drhojdr(0.0), dudr(0.0);
 
-    rhat =  *(idat.d) / *(idat.rij);
+    Vector3d rhat = *(idat.d) / *(idat.rij);
     if ( *(idat.rij) < rci && *(idat.rij) < rcij ) {
       data1.rho->getValueAndDerivativeAt( *(idat.rij), rha, drha);
-      CubicSpline* phi = MixingMap[eamtid1][eamtid1].phi;
+      UniformSpline* phi = MixingMap[eamtid1][eamtid1].phi;
       phi->getValueAndDerivativeAt( *(idat.rij), pha, dpha);
     }
 
     if ( *(idat.rij) < rcj && *(idat.rij) < rcij ) {
       data2.rho->getValueAndDerivativeAt( *(idat.rij), rhb, drhb );
-      CubicSpline* phi = MixingMap[eamtid2][eamtid2].phi;
+      UniformSpline* phi = MixingMap[eamtid2][eamtid2].phi;
       phi->getValueAndDerivativeAt( *(idat.rij), phb, dphb);
     }
 
@@ -1051,14 +1046,14 @@ namespace OpenMD {
         // Core-Core part first - no fluctuating charge, just Johnson mixing:
 
         if ( *(idat.rij) < rci  && *(idat.rij) < rcij ) {
-          CubicSpline* phiACC = data1.phiCC;
+          UniformSpline* phiACC = data1.phiCC;
           phiACC->getValueAndDerivativeAt( *(idat.rij), pha, dpha);
           phab += 0.5 * (rhb / rha) * pha;
           dvpdr += 0.5 * ((rhb/rha)*dpha +
                           pha*((drhb/rha) - (rhb*drha/rha/rha)));
         }
         if ( *(idat.rij) < rcj  && *(idat.rij) < rcij ) {
-          CubicSpline* phiBCC = data2.phiCC;
+          UniformSpline* phiBCC = data2.phiCC;
           phiBCC->getValueAndDerivativeAt( *(idat.rij), phb, dphb);
           phab += 0.5 * (rha / rhb) * phb;
           dvpdr += 0.5 * ((rha/rhb)*dphb +
@@ -1078,7 +1073,7 @@ namespace OpenMD {
           gb = 1.0 - qb*qb / (Mb*Mb);
         }
         if ( *(idat.rij) < rci  && *(idat.rij) < rcij ) {
-          CubicSpline* phiACV = data1.phiCV;
+          UniformSpline* phiACV = data1.phiCV;
           phiACV->getValueAndDerivativeAt( *(idat.rij), pha, dpha);
 
           phab += 0.5 * ga * (rhb / rha) * pha;
@@ -1090,7 +1085,7 @@ namespace OpenMD {
           }
         }
         if ( *(idat.rij) < rcj  && *(idat.rij) < rcij ) {
-          CubicSpline* phiBCV = data2.phiCV;
+          UniformSpline* phiBCV = data2.phiCV;
           phiBCV->getValueAndDerivativeAt( *(idat.rij), phb, dphb);
 
           phab += 0.5 * gb * (rha / rhb) * phb;
@@ -1104,7 +1099,7 @@ namespace OpenMD {
       }
     } else {
       if ( *(idat.rij) < rcij ) {
-        CubicSpline* phi = MixingMap[eamtid1][eamtid2].phi;
+        UniformSpline* phi = MixingMap[eamtid1][eamtid2].phi;
         phi->getValueAndDerivativeAt( *(idat.rij), phab, dvpdr);
       }
     }
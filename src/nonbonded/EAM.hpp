@@ -49,15 +49,16 @@
 #include "brains/ForceField.hpp"
 #include "math/Vector3.hpp"
 #include "math/CubicSpline.hpp"
+#include "math/UniformSpline.hpp"
 
 namespace OpenMD {
 
   struct EAMAtomData {
-    CubicSpline* rho;
-    CubicSpline* F;
+    UniformSpline* rho;
+    UniformSpline* F;
     CubicSpline* Z;
-    CubicSpline* phiCC;
-    CubicSpline* phiCV;
+    UniformSpline* phiCC;
+    UniformSpline* phiCV;
     RealType rcut;
     RealType nValence;
     RealType nMobile;
@@ -65,7 +66,7 @@ namespace OpenMD {
   };
 
   struct EAMInteractionData {
-    CubicSpline* phi;
+    UniformSpline* phi;
     RealType rcut;
     bool explicitlySet;
   };
@@ -137,7 +138,7 @@ namespace OpenMD {
 
   private:
     void initialize();
-    CubicSpline* getPhi(AtomType* atomType1, AtomType* atomType2);
+    UniformSpline* getPhi(AtomType* atomType1, AtomType* atomType2);
     
     bool initialized_;
     bool haveCutoffRadius_;
@@ -153,7 +154,6 @@ namespace OpenMD {
     RealType pre11_;
     RealType eamRcut_;
     RealType oss_;
-    Vector3d rhat;
 
     EAMMixingMethod mixMeth_;
     string name_;
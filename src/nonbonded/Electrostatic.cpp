@@ -70,7 +70,8 @@ namespace OpenMD {
                                   haveDampingAlpha_(false),
                                   haveDielectric_(false),
                                   haveElectroSplines_(false),
-                                  info_(NULL), forceField_(NULL)
+                                  info_(NULL), forceField_(NULL),
+                                  spme_(NULL)
 
   {
     flucQ_ = new FluctuatingChargeForces(info_);
@@ -211,7 +212,25 @@ namespace OpenMD {
       simError();
     }
 
-    if (screeningMethod_ == DAMPED || summationMethod_ == esm_EWALD_FULL) {
+    // The real-space part of the mesh Ewald sum is always damped:
+    if (summationMethod_ == esm_EWALD_SPME) screeningMethod_ = DAMPED;
+
+    if (summationMethod_ == esm_EWALD_SPME && !simParams_->haveDampingAlpha()) {
+      // choose alpha so the real-space sum meets the Ewald tolerance
+      // at the cutoff radius:
+      dampingAlpha_ = SPME::suggestDampingAlpha(cutoffRadius_,
+                                            simParams_->getEwaldTolerance());
+      sprintf( painCave.errMsg,
+               "Electrostatic::initialize: dampingAlpha was not specified in the\n"
+               "\tinput file.  A value of %f (1/ang) will be used to reach an\n"
+               "\tewaldTolerance of %g at the cutoff of %f (ang).\n",
+               dampingAlpha_, simParams_->getEwaldTolerance(), cutoffRadius_);
+      painCave.severity = OPENMD_INFO;
+      painCave.isFatal = 0;
+      simError();
+      haveDampingAlpha_ = true;
+    } else if (screeningMethod_ == DAMPED ||
+               summationMethod_ == esm_EWALD_FULL) {
       if (!simParams_->haveDampingAlpha()) {
         // first set a cutoff dependent alpha value
         // we assume alpha depends linearly with rcut from 0 to 20.5 ang
@@ -257,6 +276,23 @@ namespace OpenMD {
       if ((*at)->isElectrostatic()) addType(*at);
     }
 
+    if (summationMethod_ == esm_EWALD_SPME) {
+      int multipoleOrder = 0;
+      for (unsigned int j = 0; j < ElectrostaticMap.size(); j++) {
+        if (ElectrostaticMap[j].is_Dipole)
+          multipoleOrder = max(multipoleOrder, 1);
+        if (ElectrostaticMap[j].is_Quadrupole)
+          multipoleOrder = 2;
+      }
+      if (spme_ == NULL) spme_ = new SPME();
+      spme_->setDampingAlpha(dampingAlpha_);
+      spme_->setTolerance(simParams_->getEwaldTolerance());
+      spme_->setPrefactor(332.0637778);
+      spme_->setMultipoleOrder(multipoleOrder);
+      if (simParams_->haveSpmeOrder())
+        spme_->setOrder(simParams_->getSpmeOrder());
+    }
+
     if (summationMethod_ == esm_REACTION_FIELD) {
       preRF_ = (dielectric_ - 1.0) /
         ((2.0 * dielectric_ + 1.0) * pow(cutoffRadius_,3) );
@@ -306,7 +342,8 @@ namespace OpenMD {
     db0c_4 =          3.0*b2c  - 6.0*r2*b3c     + r2*r2*b4c;
     db0c_5 =                    -15.0*r*b3c + 10.0*r2*r*b4c - r2*r2*r*b5c;
 
-    if (summationMethod_ != esm_EWALD_FULL) {
+    if (summationMethod_ != esm_EWALD_FULL &&
+        summationMethod_ != esm_EWALD_SPME) {
       selfMult1_ -= b0c;
       selfMult2_ += (db0c_2 + 2.0*db0c_1*ric) /  3.0;
       selfMult4_ -= (db0c_4 + 4.0*db0c_3*ric) / 15.0;
@@ -314,6 +351,8 @@ namespace OpenMD {
 
     // working variables for the splines:
     RealType ri, ri2;
+    RealType v01, v11, v21, v22, v31, v32, v41, v42, v43;
+    RealType dv01, dv11, dv21, dv22, dv31, dv32, dv41, dv42, dv43;
     RealType b0, b1, b2, b3, b4, b5;
     RealType db0_1, db0_2, db0_3, db0_4, db0_5;
     RealType f, fc, f0;
@@ -511,6 +550,7 @@ namespace OpenMD {
       case esm_SWITCHING_FUNCTION:
       case esm_HARD:
       case esm_EWALD_FULL:
+      case esm_EWALD_SPME:
 
         v01 = f;
         v11 = g;
@@ -570,7 +610,6 @@ namespace OpenMD {
         break;
 
       case esm_EWALD_PME:
-      case esm_EWALD_SPME:
       default :
         map<string, ElectrostaticSummationMethod>::iterator i;
         std::string meth;
@@ -602,24 +641,15 @@ namespace OpenMD {
     // construct the spline structures and fill them with the values we've
     // computed:
 
-    v01s = new CubicSpline();
-    v01s->addPoints(rv, v01v);
-    v11s = new CubicSpline();
-    v11s->addPoints(rv, v11v);
-    v21s = new CubicSpline();
-    v21s->addPoints(rv, v21v);
-    v22s = new CubicSpline();
-    v22s->addPoints(rv, v22v);
-    v31s = new CubicSpline();
-    v31s->addPoints(rv, v31v);
-    v32s = new CubicSpline();
-    v32s->addPoints(rv, v32v);
-    v41s = new CubicSpline();
-    v41s->addPoints(rv, v41v);
-    v42s = new CubicSpline();
-    v42s->addPoints(rv, v42v);
-    v43s = new CubicSpline();
-    v43s->addPoints(rv, v43v);
+    v01s = new UniformSpline(rv, v01v);
+    v11s = new UniformSpline(rv, v11v);
+    v21s = new UniformSpline(rv, v21v);
+    v22s = new UniformSpline(rv, v22v);
+    v31s = new UniformSpline(rv, v31v);
+    v32s = new UniformSpline(rv, v32v);
+    v41s = new UniformSpline(rv, v41v);
+    v42s = new UniformSpline(rv, v42v);
+    v43s = new UniformSpline(rv, v43v);
 
     haveElectroSplines_ = true;
 
@@ -710,7 +740,7 @@ namespace OpenMD {
         RealType b = eaData2.slaterZeta;
         int m = electrostaticAtomData.slaterN;
         int n = eaData2.slaterN;
-        CubicSpline* J = new CubicSpline();
+        UniformSpline* J = NULL;
 
         // do both types actually use Slater orbitals?
 
@@ -740,7 +770,7 @@ namespace OpenMD {
                              Constants::hartreeToKcal );
           }
 
-          J->addPoints(rvals, Jvals);
+          J = new UniformSpline(rvals, Jvals);
         }
         Jij[fqtid][fqtid2] = J;
         Jij[fqtid2].resize( nFlucq_ );
@@ -774,6 +804,42 @@ namespace OpenMD {
 
     if (!initialized_) initialize();
 
+    // per-pair working variables (kept local so that threads sharing
+    // the pair loop do not collide):
+    ElectrostaticAtomData data1, data2;
+    RealType C_a, C_b;                       // Charges
+    Vector3d D_a, D_b;                       // Dipoles (space-fixed)
+    Mat3x3d Q_a, Q_b;                        // Quadrupoles (space-fixed)
+    RealType ri;                             // Distance utility scalar
+    RealType rdDa, rdDb;                     // Dipole utility scalars
+    Vector3d rxDa, rxDb;                     // Dipole utility vectors
+    RealType rdQar, rdQbr, trQa, trQb;       // Quadrupole utility scalars
+    Vector3d Qar, Qbr, rQa, rQb, rxQar, rxQbr; // Quadrupole utility vectors
+    RealType pref;
+    RealType DadDb, trQaQb, DadQbr, DbdQar, rQaQbr; // Cross-interaction scalars
+    Vector3d DaxDb, DadQb, DbdQa, DaxQbr, DbxQar; // Cross-interaction vectors
+    Vector3d rQaQb, QaQbr, QaxQb, rQaxQbr;
+    Mat3x3d QaQb;                            // Cross-interaction matrices
+    RealType U;                              // Potential
+    Vector3d F;                              // Force
+    Vector3d Ta, Tb;                         // Torques on sites a and b
+    Vector3d Ea, Eb;                         // Electric fields at sites a and b
+    RealType Pa, Pb;                         // Site potentials at sites a and b
+    RealType dUdCa, dUdCb;                   // fluctuating charge forces
+    RealType indirect_Pot;                   // Indirect (reaction field) potential
+    Vector3d indirect_F, indirect_Ta, indirect_Tb; // Indirect force and torques
+    RealType excluded_Pot;                   // Excluded potential (fluctuating charges)
+    RealType rfContrib, coulInt;
+    UniformSpline* J;                        // spline for coulomb integral
+    Vector3d rhat;
+    RealType v01, v11, v21, v22, v31, v32, v41, v42, v43;
+    RealType dv01, dv11, dv21, dv22, dv31, dv32, dv41, dv42, dv43;
+    RealType v11or, v22or, v31or, v32or, v42or, v43or;
+    bool a_is_Charge, a_is_Dipole, a_is_Quadrupole;
+    bool a_is_Fluctuating, a_uses_Slater, a_uses_SlaterIntra;
+    bool b_is_Charge, b_is_Dipole, b_is_Quadrupole;
+    bool b_is_Fluctuating, b_uses_Slater, b_uses_SlaterIntra;
+
     if (Etids[idat.atid1] != -1) {
       data1 = ElectrostaticMap[Etids[idat.atid1]];
       a_is_Charge = data1.is_Charge;
@@ -1257,6 +1323,7 @@ namespace OpenMD {
     case esm_SHIFTED_POTENTIAL:
     case esm_TAYLOR_SHIFTED:
     case esm_EWALD_FULL:
+    case esm_EWALD_SPME:
       if (i_is_Charge) {
         selfPot += selfMult1_ * pre11_ * C_a * (C_a + *(sdat.skippedCharge));
         // if (i_is_Fluctuating) {
@@ -1427,6 +1494,59 @@ namespace OpenMD {
                                              // angstroms.
 
     Mat3x3d hmat = info_->getSnapshotManager()->getCurrentSnapshot()->getHmat();
+
+    if (summationMethod_ == esm_EWALD_SPME) {
+      SimInfo::MoleculeIterator mi;
+      Molecule::AtomIterator ai;
+      vector<Atom*> atoms;
+      vector<SPMESite> sites;
+      SPMESite site;
+
+      for (Molecule* mol = info_->beginMolecule(mi); mol != NULL;
+           mol = info_->nextMolecule(mi)) {
+        for(Atom* atom = mol->beginAtom(ai); atom != NULL;
+            atom = mol->nextAtom(ai)) {
+
+          int atid = atom->getAtomType()->getIdent();
+          if (Etids[atid] == -1) continue;
+          ElectrostaticAtomData data = ElectrostaticMap[Etids[atid]];
+
+          site.pos = atom->getPos();
+          info_->getSnapshotManager()->getCurrentSnapshot()->wrapVector(site.pos);
+          site.charge = 0.0;
+          site.dipole = V3Zero;
+          site.quadrupole = Mat3x3d(0.0);
+
+          if (data.is_Charge) {
+            site.charge = data.fixedCharge;
+            if (data.is_Fluctuating) site.charge += atom->getFlucQPos();
+          }
+          if (data.is_Dipole)
+            site.dipole = atom->getDipole() * mPoleConverter;
+          if (data.is_Quadrupole)
+            site.quadrupole = atom->getQuadrupole() * mPoleConverter;
+
+          atoms.push_back(atom);
+          sites.push_back(site);
+        }
+      }
+
+      kPot = spme_->compute(hmat, sites);
+
+      for (unsigned int j = 0; j < atoms.size(); j++) {
+        ElectrostaticAtomData data =
+          ElectrostaticMap[Etids[atoms[j]->getAtomType()->getIdent()]];
+        atoms[j]->addFrc(sites[j].frc);
+        if (data.is_Dipole || data.is_Quadrupole)
+          atoms[j]->addTrq(sites[j].trq);
+        if (data.is_Fluctuating)
+          atoms[j]->addFlucQFrc(-sites[j].dUdq);
+      }
+
+      pot += kPot;
+      return;
+    }
+
     Vector3d box = hmat.diagonals();
     RealType boxMax = box.max();
 
@@ -1744,6 +1864,22 @@ namespace OpenMD {
 
     const RealType mPoleConverter = 0.20819434;
 
+    ElectrostaticAtomData data1, data2;
+    RealType C_a, C_b;                       // Charges
+    Vector3d D_a, D_b;                       // Dipoles (space-fixed)
+    Mat3x3d Q_a, Q_b;                        // Quadrupoles (space-fixed)
+    RealType rdDa, rdDb;                     // Dipole utility scalars
+    RealType rdQar, rdQbr, trQa, trQb;       // Quadrupole utility scalars
+    Vector3d Qar, Qbr;                       // Quadrupole utility vectors
+    RealType Pa, Pb;                         // Site potentials at sites a and b
+    Vector3d rhat;
+    RealType v01, v11, v21, v22;
+    RealType v11or, v22or;
+    bool a_is_Charge, a_is_Dipole, a_is_Quadrupole;
+    bool a_is_Fluctuating;
+    bool b_is_Charge, b_is_Dipole, b_is_Quadrupole;
+    bool b_is_Fluctuating;
+
     AtomType* atype1 = a1->getAtomType();
     AtomType* atype2 = a2->getAtomType();
     int atid1 = atype1->getIdent();
@@ -1849,6 +1985,35 @@ namespace OpenMD {
     spot2 = Pb;
   }
 
+  RealType Electrostatic::getFluctuatingChargeCoupling(int atid1, int atid2,
+                                                        RealType rij,
+                                                        bool excluded,
+                                                        RealType electroMult) {
+    if (!initialized_) initialize();
+
+    if (Etids[atid1] == -1 || Etids[atid2] == -1) return 0.0;
+
+    ElectrostaticAtomData& data1 = ElectrostaticMap[Etids[atid1]];
+    ElectrostaticAtomData& data2 = ElectrostaticMap[Etids[atid2]];
+
+    if (!data1.is_Fluctuating || !data2.is_Fluctuating) return 0.0;
+
+    // These are the C_b coefficients of dUdCa in calcForce:
+
+    UniformSpline* J = Jij[FQtids[atid1]][FQtids[atid2]];
+
+    if (excluded) {
+      if (data1.uses_SlaterIntramolecular || data2.uses_SlaterIntramolecular)
+        return J->getValueAt(rij);
+      return 0.0;
+    }
+
+    if (data1.uses_SlaterElectrostatics && data2.uses_SlaterElectrostatics)
+      return J->getValueAt(rij);
+
+    return pre11_ * electroMult * v01s->getValueAt(rij);
+  }
+
   RealType Electrostatic::getFieldFunction(RealType r) {
     if (!initialized_) {
       initialize();
@@ -48,9 +48,10 @@
 #include "primitives/Atom.hpp"
 #include "brains/ForceField.hpp"
 #include "math/SquareMatrix3.hpp"
-#include "math/CubicSpline.hpp"
+#include "math/UniformSpline.hpp"
 #include "brains/SimInfo.hpp"
 #include "flucq/FluctuatingChargeForces.hpp"
+#include "nonbonded/SPME.hpp"
 
 namespace OpenMD {
 
@@ -79,7 +80,7 @@ namespace OpenMD {
     esm_REACTION_FIELD,
     esm_EWALD_FULL,  
     esm_EWALD_PME,   /**< PME  Ewald methods aren't supported yet */
-    esm_EWALD_SPME   /**< SPME Ewald methods aren't supported yet */
+    esm_EWALD_SPME   /**< Smooth Particle Mesh Ewald */
   };
 
   enum ElectrostaticScreeningMethod{
@@ -110,6 +111,11 @@ namespace OpenMD {
     // Used by EAM to compute local fields:
     RealType getFieldFunction(RealType r);
 
+    // Used by the fluctuating charge equilibration: d^2 U / dq1 dq2
+    // for a pair of fluctuating charges (before switching)
+    RealType getFluctuatingChargeCoupling(int atid1, int atid2, RealType rij,
+                                          bool excluded, RealType electroMult);
+
     // Utility routine 
     void getSitePotentials(Atom* a1, Atom* a2, bool excluded, RealType &spot1, RealType &spot2);
 
@@ -130,12 +136,13 @@ namespace OpenMD {
     set<int> FQtypes;            /**< The set of AtomType idents that are fluctuating types */
     vector<int> FQtids;          /**< The mapping from AtomType ident -> fluctuating ident */
     vector<ElectrostaticAtomData> ElectrostaticMap; /**< data about Electrostatic types */
-    vector<vector<CubicSpline*> > Jij;              /**< Coulomb integral for two fq types */
+    vector<vector<UniformSpline*> > Jij;              /**< Coulomb integral for two fq types */
     
 
     SimInfo* info_;
     ForceField* forceField_;
     FluctuatingChargeForces* flucQ_;
+    SPME* spme_;                 /**< reciprocal-space sum for EWALD_SPME */
     set<AtomType*> simTypes_;
     RealType cutoffRadius_;
     RealType pre11_;
@@ -144,9 +151,6 @@ namespace OpenMD {
     RealType pre14_;
     RealType pre24_;
     RealType pre44_;
-    RealType v01, v11, v21, v22, v31, v32, v41, v42, v43;
-    RealType dv01, dv11, dv21, dv22, dv31, dv32, dv41, dv42, dv43;
-    RealType v01or, v11or, v21or, v22or, v31or, v32or, v41or, v42or, v43or;
     RealType chargeToC_;
     RealType angstromToM_;
     RealType debyeToCm_;
@@ -162,76 +166,16 @@ namespace OpenMD {
     RealType selfMult2_;
     RealType selfMult4_;
     
-    CubicSpline* v01s;
-    CubicSpline* v11s;
-    CubicSpline* v21s;
-    CubicSpline* v22s;
-    CubicSpline* v31s;
-    CubicSpline* v32s;
-    CubicSpline* v41s;
-    CubicSpline* v42s;
-    CubicSpline* v43s;
-
-    ElectrostaticAtomData data1;
-    ElectrostaticAtomData data2;
-    RealType C_a, C_b;  // Charges 
-    Vector3d D_a, D_b;  // Dipoles (space-fixed)
-    Mat3x3d  Q_a, Q_b;  // Quadrupoles (space-fixed)
-
-    RealType ri;                                 // Distance utility scalar
-    RealType rdDa, rdDb;                         // Dipole utility scalars
-    Vector3d rxDa, rxDb;                         // Dipole utility vectors
-    RealType rdQar, rdQbr, trQa, trQb;           // Quadrupole utility scalars
-    Vector3d Qar, Qbr, rQa, rQb, rxQar, rxQbr;   // Quadrupole utility vectors
-    RealType pref;
-
-    RealType DadDb, trQaQb, DadQbr, DbdQar;       // Cross-interaction scalars
-    RealType rQaQbr;
-    Vector3d DaxDb, DadQb, DbdQa, DaxQbr, DbxQar; // Cross-interaction vectors
-    Vector3d rQaQb, QaQbr, QaxQb, rQaxQbr;
-    Mat3x3d  QaQb;                                // Cross-interaction matrices
-
-    RealType U;  // Potential
-    Vector3d F;  // Force
-    Vector3d Ta; // Torque on site a
-    Vector3d Tb; // Torque on site b
-    Vector3d Ea; // Electric field at site a
-    Vector3d Eb; // Electric field at site b
-    RealType Pa; // Site potential at site a
-    RealType Pb; // Site potential at site b
-    RealType dUdCa; // fluctuating charge force at site a
-    RealType dUdCb; // fluctuating charge force at site a
-    
-    // Indirect interactions mediated by the reaction field.
-    RealType indirect_Pot;  // Potential
-    Vector3d indirect_F;    // Force
-    Vector3d indirect_Ta;   // Torque on site a
-    Vector3d indirect_Tb;   // Torque on site b
-
-    // Excluded potential that is still computed for fluctuating charges
-    RealType excluded_Pot;
-
-    RealType rfContrib, coulInt, dJdr;
-    
-    // spline for coulomb integral
-    CubicSpline* J;
-    Vector3d rhat;
-      
-    // logicals
-
-    bool a_is_Charge;
-    bool a_is_Dipole;
-    bool a_is_Quadrupole;
-    bool a_is_Fluctuating;
-    bool a_uses_Slater;
-    bool a_uses_SlaterIntra;
+    UniformSpline* v01s;
+    UniformSpline* v11s;
+    UniformSpline* v21s;
+    UniformSpline* v22s;
+    UniformSpline* v31s;
+    UniformSpline* v32s;
+    UniformSpline* v41s;
+    UniformSpline* v42s;
+    UniformSpline* v43s;
 
-    bool b_is_Charge;
-    bool b_is_Dipole;
-    bool b_is_Quadrupole;
-    bool b_is_Fluctuating;
-    bool b_uses_Slater;
-    bool b_uses_SlaterIntra;
   };
 }
 
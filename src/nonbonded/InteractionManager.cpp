@@ -559,6 +559,15 @@ namespace OpenMD {
     return;
   }
 
+  /**
+   * Returns the bitwise OR of the interaction families (e.g.
+   * LJ_INTERACTION) that act between two atom types.
+   */
+  int InteractionManager::getInteractionHash(int atid1, int atid2) {
+    if (!initialized_) initialize();
+    return iHash_[atid1][atid2];
+  }
+
   void InteractionManager::doPair(InteractionData &idat){
 
     if (!initialized_) initialize();
@@ -629,6 +638,17 @@ namespace OpenMD {
     electrostatic_->ReciprocalSpaceSum(pot);
   }
 
+  RealType InteractionManager::getFluctuatingChargeCoupling(int atid1,
+                                                            int atid2,
+                                                            RealType rij,
+                                                            bool excluded,
+                                                            RealType electroMult) {
+    if (!initialized_) initialize();
+    if ((iHash_[atid1][atid2] & ELECTROSTATIC_INTERACTION) == 0) return 0.0;
+    return electrostatic_->getFluctuatingChargeCoupling(atid1, atid2, rij,
+                                                        excluded, electroMult);
+  }
+
   RealType InteractionManager::getSuggestedCutoffRadius(int *atid) {
     if (!initialized_) initialize();
 
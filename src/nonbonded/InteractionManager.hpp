@@ -85,6 +85,10 @@ namespace OpenMD {
     void doSelfCorrection(SelfData &sdat);
     void doSurfaceTerm(bool slabGeometry, int axis, RealType &surfacePot);
     void doReciprocalSpaceSum(RealType &recipPot);
+    int getInteractionHash(int atid1, int atid2);
+    RealType getFluctuatingChargeCoupling(int atid1, int atid2, RealType rij,
+                                          bool excluded, RealType electroMult);
+
     void setCutoffRadius(RealType rCut);
     RealType getSuggestedCutoffRadius(int *atid1);   
     RealType getSuggestedCutoffRadius(AtomType *atype);
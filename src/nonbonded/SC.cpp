@@ -192,14 +192,8 @@ namespace OpenMD {
 
       mixer.vCut = mixer.epsilon * pow(mixer.alpha/mixer.rCut, mixer.n);
     
-      CubicSpline* V = new CubicSpline();
-      V->addPoints(rvals, vvals);
-      
-      CubicSpline* phi = new CubicSpline();
-      phi->addPoints(rvals, phivals);
-      
-      mixer.V = V;
-      mixer.phi = phi;
+      mixer.V = new UniformSpline(rvals, vvals);
+      mixer.phi = new UniformSpline(rvals, phivals);
 
       mixer.explicitlySet = false;
 
@@ -247,14 +241,8 @@ namespace OpenMD {
     
     mixer.vCut = mixer.epsilon * pow(mixer.alpha/mixer.rCut, mixer.n);
     
-    CubicSpline* V = new CubicSpline();
-    V->addPoints(rvals, vvals);
-    
-    CubicSpline* phi = new CubicSpline();
-    phi->addPoints(rvals, phivals);
-    
-    mixer.V = V;
-    mixer.phi = phi;
+    mixer.V = new UniformSpline(rvals, vvals);
+    mixer.phi = new UniformSpline(rvals, phivals);
     
     mixer.explicitlySet = true;
 
@@ -45,7 +45,7 @@
 
 #include "nonbonded/NonBondedInteraction.hpp"
 #include "brains/ForceField.hpp"
-#include "math/CubicSpline.hpp"
+#include "math/UniformSpline.hpp"
 #include "types/SuttonChenAdapter.hpp"
 
 namespace OpenMD {
@@ -66,8 +66,8 @@ namespace OpenMD {
     RealType n;
     RealType rCut;
     RealType vCut;
-    CubicSpline* V;
-    CubicSpline* phi;
+    UniformSpline* V;
+    UniformSpline* phi;
     bool explicitlySet;
   };
     
@@ -0,0 +1,426 @@
+/*
+ * Copyright (c) 2005 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#ifdef IS_MPI
+#include <mpi.h>
+#endif
+
+#include <cmath>
+#include "nonbonded/SPME.hpp"
+#include "utils/Constants.hpp"
+
+namespace OpenMD {
+
+  SPME::SPME() : alpha_(0.0), tolerance_(1.0e-5), prefactor_(1.0),
+                 userOrder_(0), multipoleOrder_(0), order_(0),
+                 haveInfluence_(false) {
+    nGrid_[0] = nGrid_[1] = nGrid_[2] = 0;
+  }
+
+  RealType SPME::suggestDampingAlpha(RealType rcut, RealType tol) {
+    // bisection on erfc(alpha * rcut) = tol
+    RealType lo = 0.0;
+    RealType hi = 5.0 / rcut;
+    while (erfc(hi * rcut) > tol) hi *= 2.0;
+    for (int i = 0; i < 60; i++) {
+      RealType mid = 0.5 * (lo + hi);
+      if (erfc(mid * rcut) > tol)
+        lo = mid;
+      else
+        hi = mid;
+    }
+    return 0.5 * (lo + hi);
+  }
+
+  /**
+   * Chooses the spline order and grid dimensions.  The order must be
+   * high enough that the highest derivative needed for the forces is
+   * still continuous (charges need one derivative, dipoles two, and
+   * quadrupoles three).  Each grid dimension is chosen so that the
+   * largest wavevector on the grid reaches the point where the
+   * Gaussian screening factor exp(-k^2 / 4 alpha^2) has fallen below
+   * the target tolerance.
+   */
+  void SPME::setupGrid(const Mat3x3d& hmat) {
+    // Each multipole derivative costs one order of spline smoothness;
+    // sixth-order splines on a grid that resolves 1.5 times the
+    // reciprocal cutoff keep the mesh error near the real-space
+    // tolerance for the usual 1e-4 .. 1e-6 range.
+    int order = 6 + multipoleOrder_;
+    if (tolerance_ < 1.0e-6) order += 2;
+    if (userOrder_ > 0) order = max(userOrder_, multipoleOrder_ + 3);
+
+    Mat3x3d invH = hmat.inverse();
+    RealType kFactor = 3.0 * alpha_ * sqrt(-log(tolerance_)) / Constants::PI;
+
+    int nGrid[3];
+    for (int a = 0; a < 3; a++) {
+      // spacing between lattice planes perpendicular to reciprocal axis a:
+      Vector3d row(invH(a,0), invH(a,1), invH(a,2));
+      RealType planeSpacing = 1.0 / row.length();
+      int n = int(ceil(kFactor * planeSpacing));
+      nGrid[a] = FFT::goodSize(max(n, order));
+    }
+
+    if (order != order_ || nGrid[0] != nGrid_[0] || nGrid[1] != nGrid_[1] ||
+        nGrid[2] != nGrid_[2]) {
+      order_ = order;
+      for (int a = 0; a < 3; a++) nGrid_[a] = nGrid[a];
+      fft_.resize(nGrid_[0], nGrid_[1], nGrid_[2]);
+      grid_.resize(nGrid_[0] * nGrid_[1] * nGrid_[2]);
+      computeModuli();
+      haveInfluence_ = false;
+    }
+
+    bool boxChanged = !haveInfluence_;
+    for (int a = 0; a < 3; a++)
+      for (int b = 0; b < 3; b++)
+        if (hmat(a,b) != lastHmat_(a,b)) boxChanged = true;
+
+    if (boxChanged) {
+      computeInfluence(invH, hmat.determinant());
+      lastHmat_ = hmat;
+      haveInfluence_ = true;
+    }
+  }
+
+  /**
+   * Cardinal B-spline weights M_n(w + n - 1 - j), j = 0 .. n-1, and
+   * their first nDeriv derivatives, for a fractional offset w in
+   * [0,1).  Weight j belongs to grid point floor(u) - n + 1 + j.
+   * Derivatives of order p come from the order n-p splines using
+   * dM_n(x)/dx = M_{n-1}(x) - M_{n-1}(x-1).
+   */
+  void SPME::bsplines(RealType w, int nDeriv,
+                      vector<vector<RealType> >& theta) {
+    theta.resize(nDeriv + 1);
+    vector<RealType> a(1, 1.0);
+    vector<RealType> b;
+
+    for (int m = 1; m <= order_; m++) {
+      int p = order_ - m;
+      if (p <= nDeriv) {
+        // apply the difference operator p times:
+        vector<RealType> d(a);
+        for (int q = 0; q < p; q++) {
+          vector<RealType> e(d.size() + 1, 0.0);
+          for (unsigned int j = 0; j <= d.size(); j++) {
+            RealType left = (j > 0) ? d[j-1] : 0.0;
+            RealType right = (j < d.size()) ? d[j] : 0.0;
+            e[j] = left - right;
+          }
+          d = e;
+        }
+        theta[p] = d;
+      }
+      if (m == order_) break;
+
+      // raise the spline order from m to m+1:
+      b.assign(m + 1, 0.0);
+      for (int j = 0; j <= m; j++) {
+        RealType left = (j > 0) ? a[j-1] : 0.0;
+        RealType right = (j < m) ? a[j] : 0.0;
+        b[j] = ((w + m - j) * left + (1.0 - w + j) * right) / RealType(m);
+      }
+      a = b;
+    }
+  }
+
+  /**
+   * |b(m)|^-2 factors for the Euler exponential splines, stored as the
+   * squared magnitude of the denominator.  Zeros of the denominator
+   * (which happen for odd orders at the Nyquist frequency) are
+   * replaced by the average of the neighboring values.
+   */
+  void SPME::computeModuli() {
+    vector<vector<RealType> > theta;
+    bsplines(0.0, 0, theta);
+    // theta[0][j] = M_n(n - 1 - j), so M_n(k+1) = theta[0][n-2-k]
+
+    for (int a = 0; a < 3; a++) {
+      int K = nGrid_[a];
+      bsmod_[a].resize(K);
+      for (int m = 0; m < K; m++) {
+        RealType sc = 0.0;
+        RealType ss = 0.0;
+        for (int k = 0; k <= order_ - 2; k++) {
+          RealType arg = 2.0 * Constants::PI * RealType(m * k) / RealType(K);
+          RealType mk = theta[0][order_ - 2 - k];
+          sc += mk * cos(arg);
+          ss += mk * sin(arg);
+        }
+        bsmod_[a][m] = sc * sc + ss * ss;
+      }
+      for (int m = 0; m < K; m++) {
+        if (bsmod_[a][m] < 1.0e-7)
+          bsmod_[a][m] = 0.5 * (bsmod_[a][(m - 1 + K) % K] +
+                                bsmod_[a][(m + 1) % K]);
+      }
+    }
+  }
+
+  void SPME::computeInfluence(const Mat3x3d& invH, RealType volume) {
+    int nx = nGrid_[0];
+    int ny = nGrid_[1];
+    int nz = nGrid_[2];
+    influence_.resize(nx * ny * nz);
+
+    RealType pre = prefactor_ * 2.0 * Constants::PI / volume;
+    RealType fac = 0.25 / (alpha_ * alpha_);
+
+    for (int i = 0; i < nx; i++) {
+      int mx = (i <= nx / 2) ? i : i - nx;
+      for (int j = 0; j < ny; j++) {
+        int my = (j <= ny / 2) ? j : j - ny;
+        for (int k = 0; k < nz; k++) {
+          int mz = (k <= nz / 2) ? k : k - nz;
+          int idx = (i * ny + j) * nz + k;
+
+          if (mx == 0 && my == 0 && mz == 0) {
+            influence_[idx] = 0.0;
+            continue;
+          }
+          Vector3d kv;
+          for (int a = 0; a < 3; a++)
+            kv[a] = 2.0 * Constants::PI * (invH(0,a) * mx + invH(1,a) * my +
+                                           invH(2,a) * mz);
+          RealType k2 = kv.lengthSquare();
+          influence_[idx] = pre * exp(-k2 * fac) / k2 /
+            (bsmod_[0][i] * bsmod_[1][j] * bsmod_[2][k]);
+        }
+      }
+    }
+  }
+
+  RealType SPME::compute(const Mat3x3d& hmat, vector<SPMESite>& sites) {
+
+    setupGrid(hmat);
+
+    int n = order_;
+    int nDeriv = multipoleOrder_ + 1;
+    int nD = nDeriv + 1;
+    int nx = nGrid_[0];
+    int ny = nGrid_[1];
+    int nz = nGrid_[2];
+    int nSites = sites.size();
+
+    Mat3x3d invH = hmat.inverse();
+    // G maps cartesian derivatives onto derivatives in grid units:
+    Mat3x3d G;
+    for (int a = 0; a < 3; a++)
+      for (int b = 0; b < 3; b++)
+        G(a,b) = RealType(nGrid_[a]) * invH(a,b);
+
+    // per-site spline weights and grid offsets:
+    vector<RealType> theta(nSites * 3 * nD * n);
+    vector<int> start(nSites * 3);
+    vector<Vector3d> dPrime(nSites);
+    vector<Mat3x3d> qPrime(nSites);
+    vector<vector<RealType> > th;
+
+    vector<RealType> Q(nx * ny * nz, 0.0);
+
+    for (int s = 0; s < nSites; s++) {
+      Vector3d frac = invH * sites[s].pos;
+      for (int a = 0; a < 3; a++) {
+        RealType u = nGrid_[a] * (frac[a] - floor(frac[a]));
+        int base = int(floor(u));
+        bsplines(u - base, nDeriv, th);
+        start[s * 3 + a] = base - n + 1;
+        for (int p = 0; p < nD; p++)
+          for (int i = 0; i < n; i++)
+            theta[((s * 3 + a) * nD + p) * n + i] = th[p][i];
+      }
+      dPrime[s] = G * sites[s].dipole;
+      qPrime[s] = G * sites[s].quadrupole * G.transpose();
+    }
+
+    // Spread the multipoles onto the grid.  Each point receives
+    // C M + D'.grad M + Q':grad grad M where the derivatives are taken
+    // with respect to the grid coordinates.
+    for (int s = 0; s < nSites; s++) {
+      const RealType* tx = &theta[((s * 3 + 0) * nD) * n];
+      const RealType* ty = &theta[((s * 3 + 1) * nD) * n];
+      const RealType* tz = &theta[((s * 3 + 2) * nD) * n];
+      RealType C = sites[s].charge;
+      const Vector3d& D = dPrime[s];
+      const Mat3x3d& Qp = qPrime[s];
+
+      for (int i = 0; i < n; i++) {
+        int gi = ((start[s*3] + i) % nx + nx) % nx;
+        RealType x[3] = {tx[i], tx[n + i], (nD > 2) ? tx[2*n + i] : 0.0};
+        for (int j = 0; j < n; j++) {
+          int gj = ((start[s*3+1] + j) % ny + ny) % ny;
+          RealType y[3] = {ty[j], ty[n + j], (nD > 2) ? ty[2*n + j] : 0.0};
+          for (int k = 0; k < n; k++) {
+            int gk = ((start[s*3+2] + k) % nz + nz) % nz;
+            RealType z[3] = {tz[k], tz[n + k], (nD > 2) ? tz[2*n + k] : 0.0};
+
+            RealType val = C * x[0] * y[0] * z[0];
+            if (multipoleOrder_ > 0) {
+              val += D[0] * x[1] * y[0] * z[0] + D[1] * x[0] * y[1] * z[0]
+                + D[2] * x[0] * y[0] * z[1];
+            }
+            if (multipoleOrder_ > 1) {
+              val += Qp(0,0) * x[2] * y[0] * z[0]
+                + Qp(1,1) * x[0] * y[2] * z[0]
+                + Qp(2,2) * x[0] * y[0] * z[2]
+                + (Qp(0,1) + Qp(1,0)) * x[1] * y[1] * z[0]
+                + (Qp(0,2) + Qp(2,0)) * x[1] * y[0] * z[1]
+                + (Qp(1,2) + Qp(2,1)) * x[0] * y[1] * z[1];
+            }
+            Q[(gi * ny + gj) * nz + gk] += val;
+          }
+        }
+      }
+    }
+
+#ifdef IS_MPI
+    MPI_Allreduce(MPI_IN_PLACE, &Q[0], nx * ny * nz, MPI_REALTYPE,
+                  MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+    for (unsigned int g = 0; g < Q.size(); g++)
+      grid_[g] = ComplexType(Q[g], 0.0);
+
+    fft_.forward(grid_);
+
+    RealType energy = 0.0;
+    for (unsigned int g = 0; g < grid_.size(); g++) {
+      energy += influence_[g] * norm(grid_[g]);
+      grid_[g] *= influence_[g];
+    }
+
+    fft_.backward(grid_);
+
+    // Interpolate from the convolved grid.  With Psi = (theta_rec * Q),
+    // E = sum Q Psi, so dE/dQ(g) = 2 Psi(g).
+    for (int s = 0; s < nSites; s++) {
+      const RealType* tx = &theta[((s * 3 + 0) * nD) * n];
+      const RealType* ty = &theta[((s * 3 + 1) * nD) * n];
+      const RealType* tz = &theta[((s * 3 + 2) * nD) * n];
+      RealType C = sites[s].charge;
+      const Vector3d& D = dPrime[s];
+      const Mat3x3d& Qp = qPrime[s];
+
+      RealType dEdC = 0.0;
+      Vector3d dEdD(0.0);
+      Mat3x3d dEdQ(0.0);
+      Vector3d dEdu(0.0);
+
+      for (int i = 0; i < n; i++) {
+        int gi = ((start[s*3] + i) % nx + nx) % nx;
+        for (int j = 0; j < n; j++) {
+          int gj = ((start[s*3+1] + j) % ny + ny) % ny;
+          for (int k = 0; k < n; k++) {
+            int gk = ((start[s*3+2] + k) % nz + nz) % nz;
+            RealType psi = 2.0 * grid_[(gi * ny + gj) * nz + gk].real();
+
+            // t(a,b,c) = a-th, b-th, c-th derivatives along x, y, z
+            RealType x[4], y[4], z[4];
+            for (int p = 0; p < nD; p++) {
+              x[p] = tx[p*n + i];
+              y[p] = ty[p*n + j];
+              z[p] = tz[p*n + k];
+            }
+
+            dEdC += psi * x[0] * y[0] * z[0];
+            dEdu[0] += psi * C * x[1] * y[0] * z[0];
+            dEdu[1] += psi * C * x[0] * y[1] * z[0];
+            dEdu[2] += psi * C * x[0] * y[0] * z[1];
+
+            if (multipoleOrder_ > 0) {
+              Vector3d t1(x[1] * y[0] * z[0], x[0] * y[1] * z[0],
+                          x[0] * y[0] * z[1]);
+              Mat3x3d t2;
+              t2(0,0) = x[2] * y[0] * z[0];
+              t2(1,1) = x[0] * y[2] * z[0];
+              t2(2,2) = x[0] * y[0] * z[2];
+              t2(0,1) = t2(1,0) = x[1] * y[1] * z[0];
+              t2(0,2) = t2(2,0) = x[1] * y[0] * z[1];
+              t2(1,2) = t2(2,1) = x[0] * y[1] * z[1];
+
+              dEdD += psi * t1;
+              dEdu += psi * (t2 * D);
+
+              if (multipoleOrder_ > 1) {
+                dEdQ += psi * t2;
+                // third derivatives contracted with Q':
+                Vector3d t3Q(0.0);
+                int e[3];
+                for (int g = 0; g < 3; g++) {
+                  for (int a = 0; a < 3; a++) {
+                    for (int b = 0; b < 3; b++) {
+                      e[0] = e[1] = e[2] = 0;
+                      e[g]++; e[a]++; e[b]++;
+                      t3Q[g] += Qp(a,b) * x[e[0]] * y[e[1]] * z[e[2]];
+                    }
+                  }
+                }
+                dEdu += psi * t3Q;
+              }
+            }
+          }
+        }
+      }
+
+      // back to cartesian coordinates:
+      sites[s].dUdq = dEdC;
+      sites[s].frc = -(G.transpose() * dEdu);
+      sites[s].trq = V3Zero;
+      if (multipoleOrder_ > 0) {
+        Vector3d dUdD = G.transpose() * dEdD;
+        sites[s].trq -= cross(sites[s].dipole, dUdD);
+      }
+      if (multipoleOrder_ > 1) {
+        Mat3x3d dUdQ = G.transpose() * dEdQ * G;
+        Mat3x3d QG = sites[s].quadrupole * dUdQ;
+        // torque = -2 * (axial vector of Q.dU/dQ)
+        Vector3d axial(QG(1,2) - QG(2,1), QG(2,0) - QG(0,2),
+                       QG(0,1) - QG(1,0));
+        sites[s].trq -= 2.0 * axial;
+      }
+    }
+
+    return energy;
+  }
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2005 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#ifndef NONBONDED_SPME_HPP
+#define NONBONDED_SPME_HPP
+
+#include "config.h"
+#include "math/Vector3.hpp"
+#include "math/SquareMatrix3.hpp"
+#include "math/FFT.hpp"
+#include <vector>
+
+using namespace std;
+namespace OpenMD {
+
+  /**
+   * A multipolar site handed to the SPME reciprocal-space sum.
+   * Dipoles and quadrupoles are in electron-angstrom units.
+   */
+  struct SPMESite {
+    Vector3d pos;
+    RealType charge;
+    Vector3d dipole;
+    Mat3x3d  quadrupole;
+    // results:
+    Vector3d frc;         /**< force on the site */
+    Vector3d trq;         /**< torque on the site's dipole / quadrupole */
+    RealType dUdq;        /**< derivative of the energy w.r.t. charge */
+  };
+
+  /**
+   * @class SPME SPME.hpp "nonbonded/SPME.hpp"
+   * Smooth Particle Mesh Ewald reciprocal-space sum for point charges,
+   * dipoles and quadrupoles.
+   *
+   * The multipoles are spread onto a grid with cardinal B-splines (and
+   * their derivatives), the grid is convolved with the Ewald influence
+   * function using 3-D FFTs, and forces, torques and charge forces are
+   * interpolated back from the convolved grid.  This scales as
+   * O(N log N) and works for general (triclinic) boxes.
+   *
+   * The grid dimensions and the spline order are chosen from a target
+   * relative accuracy unless they are set explicitly.  See: Essmann,
+   * et al., J. Chem. Phys. 103, 8577 (1995) and Sagui, Pedersen &
+   * Darden, J. Chem. Phys. 120, 73 (2004).
+   */
+  class SPME {
+  public:
+    SPME();
+
+    void setDampingAlpha(RealType alpha) { alpha_ = alpha; }
+    void setTolerance(RealType tol) { tolerance_ = tol; }
+    void setOrder(int order) { userOrder_ = order; }
+    void setPrefactor(RealType pre) { prefactor_ = pre; }
+
+    /** Highest multipole present: 0 = charges, 1 = dipoles, 2 = quadrupoles */
+    void setMultipoleOrder(int l) { multipoleOrder_ = l; }
+
+    /**
+     * Computes the reciprocal-space energy of the (local) sites and
+     * fills in their forces, torques and charge derivatives.  In
+     * parallel, every processor returns the total energy.
+     */
+    RealType compute(const Mat3x3d& hmat, vector<SPMESite>& sites);
+
+    /** Ewald damping parameter that gives erfc(alpha rcut) = tol. */
+    static RealType suggestDampingAlpha(RealType rcut, RealType tol);
+
+    int getOrder() { return order_; }
+    void getGridSize(int& nx, int& ny, int& nz) {
+      nx = nGrid_[0]; ny = nGrid_[1]; nz = nGrid_[2];
+    }
+
+  private:
+    void setupGrid(const Mat3x3d& hmat);
+    void bsplines(RealType w, int nDeriv, vector<vector<RealType> >& theta);
+    void computeModuli();
+    void computeInfluence(const Mat3x3d& invHmat, RealType volume);
+
+    RealType alpha_;
+    RealType tolerance_;
+    RealType prefactor_;
+    int userOrder_;
+    int multipoleOrder_;
+    int order_;
+    int nGrid_[3];
+
+    Mat3x3d lastHmat_;
+    bool haveInfluence_;
+
+    FFT3D fft_;
+    vector<ComplexType> grid_;
+    vector<RealType> influence_;     /**< C(m) for every grid point */
+    vector<RealType> bsmod_[3];      /**< |b(m)|^2 along each axis */
+  };
+}
+
+#endif
@@ -128,15 +128,15 @@ namespace OpenMD {
       mixer.v0p = sqrt( sticky1.getV0p()  * sticky2.getV0p() );
       mixer.isPower = sticky1.isStickyPower() && sticky2.isStickyPower();
 
-      CubicSpline* s = new CubicSpline();
-      s->addPoint(mixer.rl, 1.0);
-      s->addPoint(mixer.ru, 0.0);
-      mixer.s = s;
+      CubicSpline s;
+      s.addPoint(mixer.rl, 1.0);
+      s.addPoint(mixer.ru, 0.0);
+      mixer.s = new UniformSpline(&s);
 
-      CubicSpline* sp = new CubicSpline();
-      sp->addPoint(mixer.rlp, 1.0);
-      sp->addPoint(mixer.rup, 0.0);
-      mixer.sp = sp;
+      CubicSpline sp;
+      sp.addPoint(mixer.rlp, 1.0);
+      sp.addPoint(mixer.rup, 0.0);
+      mixer.sp = new UniformSpline(&sp);
 
       MixingMap[stid2].resize( nSticky_ );
 
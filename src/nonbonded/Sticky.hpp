@@ -47,7 +47,7 @@
 #include "types/StickyAdapter.hpp"
 #include "brains/ForceField.hpp"
 #include "math/SquareMatrix3.hpp"
-#include "math/CubicSpline.hpp"
+#include "math/UniformSpline.hpp"
 
 using namespace std;
 namespace OpenMD {
@@ -61,8 +61,8 @@ namespace OpenMD {
     RealType w0;
     RealType v0;
     RealType v0p;
-    CubicSpline* s;
-    CubicSpline* sp;
+    UniformSpline* s;
+    UniformSpline* sp;
     bool isPower;
   };
 
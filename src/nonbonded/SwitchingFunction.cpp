@@ -52,15 +52,12 @@ namespace OpenMD {
 
   SwitchingFunction::SwitchingFunction() : functionType_(cubic), 
 					   haveSpline_(false), isCubic_(true), 
-					   np_(150) {
-    switchSpline_ = new CubicSpline();
+					   np_(150), switchSpline_(NULL) {
   }
 
   void SwitchingFunction::setSwitchType(SwitchingFunctionType sft) {
     if ((sft == fifth_order_poly) || (sft == cubic)) {
       if (haveSpline_) {
-        delete switchSpline_;
-        switchSpline_ = new CubicSpline();
         setSwitch(rin_, rout_);
       } 
     } else {
@@ -109,6 +106,7 @@ namespace OpenMD {
     }
     
     // setup r -> sw lookup spline
+    CubicSpline cs;
     if (functionType_ == fifth_order_poly) {
       isCubic_ = false;
       RealType c0 = 1.0;
@@ -134,14 +132,16 @@ namespace OpenMD {
         rvaldi4 = rvaldi2*rvaldi2;
         rvaldi5 = rvaldi3*rvaldi2;
         yval= c0 + c3*rval3*rvaldi3 + c4*rval4*rvaldi4 + c5*rval5*rvaldi5;
-        switchSpline_->addPoint(r, yval);
+        cs.addPoint(r, yval);
       } 
     } else {
       // cubic splines only need 2 points to do a cubic switching function...
       isCubic_ = true;
-      switchSpline_->addPoint(rin_, 1.0);
-      switchSpline_->addPoint(rout_, 0.0);
+      cs.addPoint(rin_, 1.0);
+      cs.addPoint(rout_, 0.0);
     }
+    if (haveSpline_) delete switchSpline_;
+    switchSpline_ = new UniformSpline(&cs);
     haveSpline_ = true;
     return;
   }
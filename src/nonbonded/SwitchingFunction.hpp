@@ -43,7 +43,7 @@
 #ifndef NONBONDED_SWITCHINGFUNCTION_HPP
 #define NONBONDED_SWITCHINGFUNCTION_HPP
 
-#include "math/CubicSpline.hpp"
+#include "math/UniformSpline.hpp"
 
 using namespace std;
 namespace OpenMD {
@@ -70,7 +70,7 @@ namespace OpenMD {
     bool haveSpline_;
     bool isCubic_;
     int np_;
-    CubicSpline* switchSpline_;   
+    UniformSpline* switchSpline_;
   };
 }                  
 #endif
@@ -52,7 +52,7 @@ namespace OpenMD {
 
   ForceDecomposition::ForceDecomposition(SimInfo* info,
                                          InteractionManager* iMan) :
-    info_(info), interactionMan_(iMan), needVelocities_(false) {
+    info_(info), interactionMan_(iMan), nThreads_(1), needVelocities_(false) {
 
     sman_ = info_->getSnapshotManager();
     storageLayout_ = sman_->getStorageLayout();
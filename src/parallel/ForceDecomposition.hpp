@@ -89,6 +89,14 @@ namespace OpenMD {
    * ForceDecomposition provides the interface for ForceLoop to do the
    * communication steps and to iterate using the correct set of atoms
    * and cutoff groups.
+   *
+   * Within a single processor, the pair loop may also be shared among
+   * several threads.  Thread 0 accumulates directly into the normal
+   * work arrays, while every other thread accumulates into private
+   * copies of the force, torque, density, field and potential arrays.
+   * The private copies are summed (in thread order) back into the
+   * work arrays by reduceThreadData, which must be called after each
+   * pass through the pair loop.
    */
   class ForceDecomposition {
   public:
@@ -105,6 +113,12 @@ namespace OpenMD {
     virtual void distributeIntermediateData() = 0;
     virtual void collectData() = 0;
     virtual void collectSelfData() = 0;
+
+    // shared-memory threading of the pair loop
+    virtual void setNumThreads(int nThreads) { nThreads_ = nThreads; }
+    int getNumThreads() { return nThreads_; }
+    virtual void reduceThreadData() = 0;
+
     virtual potVec* getSelfPotential() { return &selfPot; }
     virtual potVec* getPairwisePotential() { return &pairwisePot; }
     virtual potVec* getExcludedPotential() { return &excludedPot; }
@@ -142,15 +156,18 @@ namespace OpenMD {
     virtual int getGlobalIDRow(int atom1) = 0;
     virtual int getGlobalIDCol(int atom2) = 0;
     virtual int getGlobalID(int atom1) = 0;
+    virtual int getIdentRow(int atom1) = 0;
+    virtual int getIdentCol(int atom2) = 0;
     
     virtual int getTopologicalDistance(int atom1, int atom2) = 0;
-    virtual void addForceToAtomRow(int atom1, Vector3d fg) = 0;
-    virtual void addForceToAtomColumn(int atom2, Vector3d fg) = 0;
+    virtual void addForceToAtomRow(int atom1, Vector3d fg, int tid = 0) = 0;
+    virtual void addForceToAtomColumn(int atom2, Vector3d fg, int tid = 0) = 0;
     virtual Vector3d& getAtomVelocityColumn(int atom2) = 0;
 
-    // filling interaction blocks with pointers
-    virtual void fillInteractionData(InteractionData &idat, int atom1, int atom2, bool newAtom1 = true) = 0;
-    virtual void unpackInteractionData(InteractionData &idat, int atom1, int atom2) = 0;
+    // filling interaction blocks with pointers (idat.excluded is
+    // left to the caller, which usually has it cached)
+    virtual void fillInteractionData(InteractionData &idat, int atom1, int atom2, bool newAtom1 = true, int tid = 0) = 0;
+    virtual void unpackInteractionData(InteractionData &idat, int atom1, int atom2, int tid = 0) = 0;
 
     virtual void fillSelfData(SelfData &sdat, int atom1);
 
@@ -165,6 +182,7 @@ namespace OpenMD {
     InteractionManager* interactionMan_;
 
     int storageLayout_;
+    int nThreads_;             /**< number of threads sharing the pair loop */
     bool needVelocities_;
     bool usePeriodicBoundaryConditions_;
     RealType skinThickness_;   /**< Verlet neighbor list skin thickness */
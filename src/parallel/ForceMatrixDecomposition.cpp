@@ -44,41 +44,15 @@
 #include "nonbonded/NonBondedInteraction.hpp"
 #include "brains/SnapshotManager.hpp"
 #include "brains/PairList.hpp"
+#include <ctime>
 
 using namespace std;
 namespace OpenMD {
 
-  ForceMatrixDecomposition::ForceMatrixDecomposition(SimInfo* info, InteractionManager* iMan) : ForceDecomposition(info, iMan) {
+  ForceMatrixDecomposition::ForceMatrixDecomposition(SimInfo* info, InteractionManager* iMan) : ForceDecomposition(info, iMan), threadLayout_(0) {
 
-    // Row and colum scans must visit all surrounding cells
-    cellOffsets_.clear();
-    cellOffsets_.push_back( Vector3i(-1,-1,-1) );
-    cellOffsets_.push_back( Vector3i( 0,-1,-1) );
-    cellOffsets_.push_back( Vector3i( 1,-1,-1) );                          
-    cellOffsets_.push_back( Vector3i(-1, 0,-1) );
-    cellOffsets_.push_back( Vector3i( 0, 0,-1) );
-    cellOffsets_.push_back( Vector3i( 1, 0,-1) );
-    cellOffsets_.push_back( Vector3i(-1, 1,-1) );
-    cellOffsets_.push_back( Vector3i( 0, 1,-1) );      
-    cellOffsets_.push_back( Vector3i( 1, 1,-1) );
-    cellOffsets_.push_back( Vector3i(-1,-1, 0) );
-    cellOffsets_.push_back( Vector3i( 0,-1, 0) );
-    cellOffsets_.push_back( Vector3i( 1,-1, 0) );
-    cellOffsets_.push_back( Vector3i(-1, 0, 0) );       
-    cellOffsets_.push_back( Vector3i( 0, 0, 0) );
-    cellOffsets_.push_back( Vector3i( 1, 0, 0) );
-    cellOffsets_.push_back( Vector3i(-1, 1, 0) );
-    cellOffsets_.push_back( Vector3i( 0, 1, 0) );
-    cellOffsets_.push_back( Vector3i( 1, 1, 0) );
-    cellOffsets_.push_back( Vector3i(-1,-1, 1) );
-    cellOffsets_.push_back( Vector3i( 0,-1, 1) );
-    cellOffsets_.push_back( Vector3i( 1,-1, 1) );
-    cellOffsets_.push_back( Vector3i(-1, 0, 1) );
-    cellOffsets_.push_back( Vector3i( 0, 0, 1) );
-    cellOffsets_.push_back( Vector3i( 1, 0, 1) );
-    cellOffsets_.push_back( Vector3i(-1, 1, 1) );
-    cellOffsets_.push_back( Vector3i( 0, 1, 1) );
-    cellOffsets_.push_back( Vector3i( 1, 1, 1) );
+    // the cell stencil is chosen when the neighbor list is built
+    reportedCells_ = Vector3i(0, 0, 0);
   }
 
 
@@ -308,6 +282,22 @@ namespace OpenMD {
     }    
   }
     
+  int ForceMatrixDecomposition::getIdentRow(int atom1) {
+#ifdef IS_MPI
+    return identsRow[atom1];
+#else
+    return idents[atom1];
+#endif
+  }
+
+  int ForceMatrixDecomposition::getIdentCol(int atom2) {
+#ifdef IS_MPI
+    return identsCol[atom2];
+#else
+    return idents[atom2];
+#endif
+  }
+
   int ForceMatrixDecomposition::getTopologicalDistance(int atom1, int atom2) {
     for (unsigned int j = 0; j < toposForAtom[atom1].size(); j++) {
       if (toposForAtom[atom1][j] == atom2) 
@@ -443,6 +433,201 @@ namespace OpenMD {
       fill(snap_->atomData.sitePotential.begin(), 
            snap_->atomData.sitePotential.end(), 0.0);
     }
+
+    if (nThreads_ > 1) zeroThreadWorkArrays();
+  }
+
+  void ForceMatrixDecomposition::setNumThreads(int nThreads) {
+    nThreads_ = max(1, nThreads);
+    threadWork_.resize(nThreads_ - 1);
+  }
+
+  DataStorage& ForceMatrixDecomposition::getRowStorage(int tid) {
+    if (tid > 0) return threadWork_[tid-1].rowData;
+#ifdef IS_MPI
+    return atomRowData;
+#else
+    return snap_->atomData;
+#endif
+  }
+
+  DataStorage& ForceMatrixDecomposition::getColumnStorage(int tid) {
+#ifdef IS_MPI
+    if (tid > 0) return threadWork_[tid-1].colData;
+    return atomColData;
+#else
+    if (tid > 0) return threadWork_[tid-1].rowData;
+    return snap_->atomData;
+#endif
+  }
+
+  /**
+   * Sizes and zeroes the private accumulation arrays used by threads
+   * 1 through nThreads-1.  Only quantities that are written inside
+   * the pair loop need private copies.
+   */
+  void ForceMatrixDecomposition::zeroThreadWorkArrays() {
+    threadLayout_ = storageLayout_ & (DataStorage::dslForce |
+                                      DataStorage::dslTorque |
+                                      DataStorage::dslParticlePot |
+                                      DataStorage::dslDensity |
+                                      DataStorage::dslSkippedCharge |
+                                      DataStorage::dslFlucQForce |
+                                      DataStorage::dslElectricField |
+                                      DataStorage::dslSitePotential);
+#ifdef IS_MPI
+    int nRow = nAtomsInRow_;
+    int nCol = nAtomsInCol_;
+#else
+    int nRow = nLocal_;
+#endif
+
+    potVec zeroPot(0.0);
+
+    for (vector<ThreadWorkData>::iterator tw = threadWork_.begin();
+         tw != threadWork_.end(); ++tw) {
+
+      tw->pairwisePot = 0.0;
+      tw->excludedPot = 0.0;
+      tw->selectedPot = 0.0;
+
+      vector<DataStorage*> stores;
+      stores.push_back( &(tw->rowData) );
+      tw->rowData.setStorageLayout(threadLayout_);
+      tw->rowData.resize(nRow);
+#ifdef IS_MPI
+      stores.push_back( &(tw->colData) );
+      tw->colData.setStorageLayout(threadLayout_);
+      tw->colData.resize(nCol);
+
+      tw->pot_row.assign(nRow, zeroPot);
+      tw->pot_col.assign(nCol, zeroPot);
+      tw->expot_row.assign(nRow, zeroPot);
+      tw->expot_col.assign(nCol, zeroPot);
+      tw->selepot_row.assign(nRow, zeroPot);
+      tw->selepot_col.assign(nCol, zeroPot);
+#endif
+      for (vector<DataStorage*>::iterator ds = stores.begin();
+           ds != stores.end(); ++ds) {
+        DataStorage* d = *ds;
+        if (threadLayout_ & DataStorage::dslForce)
+          fill(d->force.begin(), d->force.end(), V3Zero);
+        if (threadLayout_ & DataStorage::dslTorque)
+          fill(d->torque.begin(), d->torque.end(), V3Zero);
+        if (threadLayout_ & DataStorage::dslParticlePot)
+          fill(d->particlePot.begin(), d->particlePot.end(), 0.0);
+        if (threadLayout_ & DataStorage::dslDensity)
+          fill(d->density.begin(), d->density.end(), 0.0);
+        if (threadLayout_ & DataStorage::dslSkippedCharge)
+          fill(d->skippedCharge.begin(), d->skippedCharge.end(), 0.0);
+        if (threadLayout_ & DataStorage::dslFlucQForce)
+          fill(d->flucQFrc.begin(), d->flucQFrc.end(), 0.0);
+        if (threadLayout_ & DataStorage::dslElectricField)
+          fill(d->electricField.begin(), d->electricField.end(), V3Zero);
+        if (threadLayout_ & DataStorage::dslSitePotential)
+          fill(d->sitePotential.begin(), d->sitePotential.end(), 0.0);
+      }
+    }
+  }
+
+  /**
+   * Adds the private accumulation arrays from threads 1 through
+   * nThreads-1 into the work arrays and zeroes them again, so that
+   * this can be called after every pass through the pair loop.  The
+   * contributions are always added in thread order, so the result
+   * does not depend on which thread finishes first.
+   */
+  void ForceMatrixDecomposition::reduceThreadData() {
+    if (nThreads_ < 2) return;
+
+    int nStores = 1;
+#ifdef IS_MPI
+    nStores = 2;
+#endif
+
+    for (int which = 0; which < nStores; which++) {
+      DataStorage& target = (which == 0) ? getRowStorage(0) :
+        getColumnStorage(0);
+#ifdef IS_MPI
+      int nAtoms = (which == 0) ? nAtomsInRow_ : nAtomsInCol_;
+#else
+      int nAtoms = nLocal_;
+#endif
+
+#pragma omp parallel for schedule(static)
+      for (int i = 0; i < nAtoms; i++) {
+        for (int t = 0; t < nThreads_ - 1; t++) {
+          DataStorage& d = (which == 0) ? threadWork_[t].rowData :
+#ifdef IS_MPI
+            threadWork_[t].colData;
+#else
+            threadWork_[t].rowData;
+#endif
+          if (threadLayout_ & DataStorage::dslForce) {
+            target.force[i] += d.force[i];
+            d.force[i] = V3Zero;
+          }
+          if (threadLayout_ & DataStorage::dslTorque) {
+            target.torque[i] += d.torque[i];
+            d.torque[i] = V3Zero;
+          }
+          if (threadLayout_ & DataStorage::dslParticlePot) {
+            target.particlePot[i] += d.particlePot[i];
+            d.particlePot[i] = 0.0;
+          }
+          if (threadLayout_ & DataStorage::dslDensity) {
+            target.density[i] += d.density[i];
+            d.density[i] = 0.0;
+          }
+          if (threadLayout_ & DataStorage::dslSkippedCharge) {
+            target.skippedCharge[i] += d.skippedCharge[i];
+            d.skippedCharge[i] = 0.0;
+          }
+          if (threadLayout_ & DataStorage::dslFlucQForce) {
+            target.flucQFrc[i] += d.flucQFrc[i];
+            d.flucQFrc[i] = 0.0;
+          }
+          if (threadLayout_ & DataStorage::dslElectricField) {
+            target.electricField[i] += d.electricField[i];
+            d.electricField[i] = V3Zero;
+          }
+          if (threadLayout_ & DataStorage::dslSitePotential) {
+            target.sitePotential[i] += d.sitePotential[i];
+            d.sitePotential[i] = 0.0;
+          }
+#ifdef IS_MPI
+          vector<potVec>& pot = (which == 0) ? threadWork_[t].pot_row :
+            threadWork_[t].pot_col;
+          vector<potVec>& expot = (which == 0) ? threadWork_[t].expot_row :
+            threadWork_[t].expot_col;
+          vector<potVec>& selepot = (which == 0) ?
+            threadWork_[t].selepot_row : threadWork_[t].selepot_col;
+          if (which == 0) {
+            pot_row[i] += pot[i];
+            expot_row[i] += expot[i];
+            selepot_row[i] += selepot[i];
+          } else {
+            pot_col[i] += pot[i];
+            expot_col[i] += expot[i];
+            selepot_col[i] += selepot[i];
+          }
+          pot[i] = 0.0;
+          expot[i] = 0.0;
+          selepot[i] = 0.0;
+#endif
+        }
+      }
+    }
+
+    for (vector<ThreadWorkData>::iterator tw = threadWork_.begin();
+         tw != threadWork_.end(); ++tw) {
+      pairwisePot += tw->pairwisePot;
+      excludedPot += tw->excludedPot;
+      selectedPot += tw->selectedPot;
+      tw->pairwisePot = 0.0;
+      tw->excludedPot = 0.0;
+      tw->selectedPot = 0.0;
+    }
   }
 
 
@@ -1029,28 +1214,25 @@ namespace OpenMD {
   }
 
 
-  void ForceMatrixDecomposition::addForceToAtomRow(int atom1, Vector3d fg){
-#ifdef IS_MPI
-    atomRowData.force[atom1] += fg;
-#else
-    snap_->atomData.force[atom1] += fg;
-#endif
+  void ForceMatrixDecomposition::addForceToAtomRow(int atom1, Vector3d fg,
+                                                   int tid){
+    getRowStorage(tid).force[atom1] += fg;
   }
 
-  void ForceMatrixDecomposition::addForceToAtomColumn(int atom2, Vector3d fg){
-#ifdef IS_MPI
-    atomColData.force[atom2] += fg;
-#else
-    snap_->atomData.force[atom2] += fg;
-#endif
+  void ForceMatrixDecomposition::addForceToAtomColumn(int atom2, Vector3d fg,
+                                                      int tid){
+    getColumnStorage(tid).force[atom2] += fg;
   }
 
     // filling interaction blocks with pointers
   void ForceMatrixDecomposition::fillInteractionData(InteractionData &idat, 
                                                      int atom1, int atom2,
-                                                     bool newAtom1) {
+                                                     bool newAtom1,
+                                                     int tid) {
 
-    idat.excluded = excludeAtomPair(atom1, atom2);
+    // quantities accumulated in the pair loop go to this thread's storage:
+    DataStorage& rowOut = getRowStorage(tid);
+    DataStorage& colOut = getColumnStorage(tid);
 
     if (newAtom1) {
       
@@ -1070,8 +1252,8 @@ namespace OpenMD {
       }
       
       if (storageLayout_ & DataStorage::dslTorque) {
-        idat.t1 = &(atomRowData.torque[atom1]);
-        idat.t2 = &(atomColData.torque[atom2]);
+        idat.t1 = &(rowOut.torque[atom1]);
+        idat.t2 = &(colOut.torque[atom2]);
       }
       
       if (storageLayout_ & DataStorage::dslDipole) {
@@ -1085,8 +1267,8 @@ namespace OpenMD {
       }
       
       if (storageLayout_ & DataStorage::dslDensity) {
-        idat.rho1 = &(atomRowData.density[atom1]);
-        idat.rho2 = &(atomColData.density[atom2]);
+        idat.rho1 = &(rowOut.density[atom1]);
+        idat.rho2 = &(colOut.density[atom2]);
       }
       
       if (storageLayout_ & DataStorage::dslFunctional) {
@@ -1100,13 +1282,13 @@ namespace OpenMD {
       }
       
       if (storageLayout_ & DataStorage::dslParticlePot) {
-        idat.particlePot1 = &(atomRowData.particlePot[atom1]);
-        idat.particlePot2 = &(atomColData.particlePot[atom2]);
+        idat.particlePot1 = &(rowOut.particlePot[atom1]);
+        idat.particlePot2 = &(colOut.particlePot[atom2]);
       }
       
       if (storageLayout_ & DataStorage::dslSkippedCharge) {              
-        idat.skippedCharge1 = &(atomRowData.skippedCharge[atom1]);
-        idat.skippedCharge2 = &(atomColData.skippedCharge[atom2]);
+        idat.skippedCharge1 = &(rowOut.skippedCharge[atom1]);
+        idat.skippedCharge2 = &(colOut.skippedCharge[atom2]);
       }
       
       if (storageLayout_ & DataStorage::dslFlucQPosition) {              
@@ -1131,8 +1313,8 @@ namespace OpenMD {
       }
       
       if (storageLayout_ & DataStorage::dslTorque) {
-        idat.t1 = &(snap_->atomData.torque[atom1]);
-        idat.t2 = &(snap_->atomData.torque[atom2]);
+        idat.t1 = &(rowOut.torque[atom1]);
+        idat.t2 = &(colOut.torque[atom2]);
       }
       
       if (storageLayout_ & DataStorage::dslDipole) {
@@ -1146,8 +1328,8 @@ namespace OpenMD {
       }
       
       if (storageLayout_ & DataStorage::dslDensity) {     
-        idat.rho1 = &(snap_->atomData.density[atom1]);
-        idat.rho2 = &(snap_->atomData.density[atom2]);
+        idat.rho1 = &(rowOut.density[atom1]);
+        idat.rho2 = &(colOut.density[atom2]);
       }
       
       if (storageLayout_ & DataStorage::dslFunctional) {
@@ -1161,13 +1343,13 @@ namespace OpenMD {
       }
       
       if (storageLayout_ & DataStorage::dslParticlePot) {
-        idat.particlePot1 = &(snap_->atomData.particlePot[atom1]);
-        idat.particlePot2 = &(snap_->atomData.particlePot[atom2]);
+        idat.particlePot1 = &(rowOut.particlePot[atom1]);
+        idat.particlePot2 = &(colOut.particlePot[atom2]);
       }
       
       if (storageLayout_ & DataStorage::dslSkippedCharge) {
-        idat.skippedCharge1 = &(snap_->atomData.skippedCharge[atom1]);
-        idat.skippedCharge2 = &(snap_->atomData.skippedCharge[atom2]);
+        idat.skippedCharge1 = &(rowOut.skippedCharge[atom1]);
+        idat.skippedCharge2 = &(colOut.skippedCharge[atom2]);
       }
       
       if (storageLayout_ & DataStorage::dslFlucQPosition) {              
@@ -1192,7 +1374,7 @@ namespace OpenMD {
     }
     
     if (storageLayout_ & DataStorage::dslTorque) {
-      idat.t2 = &(atomColData.torque[atom2]);
+      idat.t2 = &(colOut.torque[atom2]);
     }
 
     if (storageLayout_ & DataStorage::dslDipole) {
@@ -1204,7 +1386,7 @@ namespace OpenMD {
     }
 
     if (storageLayout_ & DataStorage::dslDensity) {
-      idat.rho2 = &(atomColData.density[atom2]);
+      idat.rho2 = &(colOut.density[atom2]);
     }
 
     if (storageLayout_ & DataStorage::dslFunctional) {
@@ -1216,11 +1398,11 @@ namespace OpenMD {
     }
 
     if (storageLayout_ & DataStorage::dslParticlePot) {
-      idat.particlePot2 = &(atomColData.particlePot[atom2]);
+      idat.particlePot2 = &(colOut.particlePot[atom2]);
     }
 
     if (storageLayout_ & DataStorage::dslSkippedCharge) {              
-      idat.skippedCharge2 = &(atomColData.skippedCharge[atom2]);
+      idat.skippedCharge2 = &(colOut.skippedCharge[atom2]);
     }
 
     if (storageLayout_ & DataStorage::dslFlucQPosition) {
@@ -1241,7 +1423,7 @@ namespace OpenMD {
     }
 
     if (storageLayout_ & DataStorage::dslTorque) {
-      idat.t2 = &(snap_->atomData.torque[atom2]);
+      idat.t2 = &(colOut.torque[atom2]);
     }
 
     if (storageLayout_ & DataStorage::dslDipole) {
@@ -1253,7 +1435,7 @@ namespace OpenMD {
     }
 
     if (storageLayout_ & DataStorage::dslDensity) {     
-      idat.rho2 = &(snap_->atomData.density[atom2]);
+      idat.rho2 = &(colOut.density[atom2]);
     }
 
     if (storageLayout_ & DataStorage::dslFunctional) {
@@ -1265,11 +1447,11 @@ namespace OpenMD {
     }
 
     if (storageLayout_ & DataStorage::dslParticlePot) {
-      idat.particlePot2 = &(snap_->atomData.particlePot[atom2]);
+      idat.particlePot2 = &(colOut.particlePot[atom2]);
     }
 
     if (storageLayout_ & DataStorage::dslSkippedCharge) {
-      idat.skippedCharge2 = &(snap_->atomData.skippedCharge[atom2]);
+      idat.skippedCharge2 = &(colOut.skippedCharge[atom2]);
     }
 
     if (storageLayout_ & DataStorage::dslFlucQPosition) {              
@@ -1281,63 +1463,80 @@ namespace OpenMD {
   }
   
   void ForceMatrixDecomposition::unpackInteractionData(InteractionData &idat,
-                                                       int atom1, int atom2) {  
+                                                       int atom1, int atom2,
+                                                       int tid) {  
+    DataStorage& rowOut = getRowStorage(tid);
+    DataStorage& colOut = getColumnStorage(tid);
 #ifdef IS_MPI
-    pot_row[atom1] += RealType(0.5) *  *(idat.pot);
-    pot_col[atom2] += RealType(0.5) *  *(idat.pot);
-    expot_row[atom1] += RealType(0.5) *  *(idat.excludedPot);
-    expot_col[atom2] += RealType(0.5) *  *(idat.excludedPot);
-    selepot_row[atom1] += RealType(0.5) *  *(idat.selePot);
-    selepot_col[atom2] += RealType(0.5) *  *(idat.selePot);
-
-    atomRowData.force[atom1] += *(idat.f1);
-    atomColData.force[atom2] -= *(idat.f1);
+    ThreadWorkData* tw = (tid > 0) ? &(threadWork_[tid-1]) : NULL;
+    vector<potVec>& potRow = tw ? tw->pot_row : pot_row;
+    vector<potVec>& potCol = tw ? tw->pot_col : pot_col;
+    vector<potVec>& expotRow = tw ? tw->expot_row : expot_row;
+    vector<potVec>& expotCol = tw ? tw->expot_col : expot_col;
+    vector<potVec>& selepotRow = tw ? tw->selepot_row : selepot_row;
+    vector<potVec>& selepotCol = tw ? tw->selepot_col : selepot_col;
+
+    potRow[atom1] += RealType(0.5) *  *(idat.pot);
+    potCol[atom2] += RealType(0.5) *  *(idat.pot);
+    expotRow[atom1] += RealType(0.5) *  *(idat.excludedPot);
+    expotCol[atom2] += RealType(0.5) *  *(idat.excludedPot);
+    selepotRow[atom1] += RealType(0.5) *  *(idat.selePot);
+    selepotCol[atom2] += RealType(0.5) *  *(idat.selePot);
+
+    rowOut.force[atom1] += *(idat.f1);
+    colOut.force[atom2] -= *(idat.f1);
 
     if (storageLayout_ & DataStorage::dslFlucQForce) {              
-      atomRowData.flucQFrc[atom1] -= *(idat.dVdFQ1);
-      atomColData.flucQFrc[atom2] -= *(idat.dVdFQ2);
+      rowOut.flucQFrc[atom1] -= *(idat.dVdFQ1);
+      colOut.flucQFrc[atom2] -= *(idat.dVdFQ2);
     }
 
     if (storageLayout_ & DataStorage::dslElectricField) {              
-      atomRowData.electricField[atom1] += *(idat.eField1);
-      atomColData.electricField[atom2] += *(idat.eField2);
+      rowOut.electricField[atom1] += *(idat.eField1);
+      colOut.electricField[atom2] += *(idat.eField2);
     }
 
     if (storageLayout_ & DataStorage::dslSitePotential) {              
-      atomRowData.sitePotential[atom1] += *(idat.sPot1);
-      atomColData.sitePotential[atom2] += *(idat.sPot2);
+      rowOut.sitePotential[atom1] += *(idat.sPot1);
+      colOut.sitePotential[atom2] += *(idat.sPot2);
     }
 
 #else
-    pairwisePot += *(idat.pot);
-    excludedPot += *(idat.excludedPot);
-    selectedPot += *(idat.selePot);
+    if (tid > 0) {
+      threadWork_[tid-1].pairwisePot += *(idat.pot);
+      threadWork_[tid-1].excludedPot += *(idat.excludedPot);
+      threadWork_[tid-1].selectedPot += *(idat.selePot);
+    } else {
+      pairwisePot += *(idat.pot);
+      excludedPot += *(idat.excludedPot);
+      selectedPot += *(idat.selePot);
+    }
 
-    snap_->atomData.force[atom1] += *(idat.f1);
-    snap_->atomData.force[atom2] -= *(idat.f1);
+    rowOut.force[atom1] += *(idat.f1);
+    colOut.force[atom2] -= *(idat.f1);
 
     if (idat.doParticlePot) {
       // This is the pairwise contribution to the particle pot.  The
       // self and embedding contribution is added in each of the low
       // level non-bonded routines.  In parallel, this calculation is
       // done in collectData, not in unpackInteractionData.
-      snap_->atomData.particlePot[atom1] += *(idat.vpair) * *(idat.sw);
-      snap_->atomData.particlePot[atom2] += *(idat.vpair) * *(idat.sw);
+      rowOut.particlePot[atom1] += *(idat.vpair) * *(idat.sw);
+      colOut.particlePot[atom2] += *(idat.vpair) * *(idat.sw);
     }
     
     if (storageLayout_ & DataStorage::dslFlucQForce) {
-      snap_->atomData.flucQFrc[atom1] -= *(idat.dVdFQ1);
-      snap_->atomData.flucQFrc[atom2] -= *(idat.dVdFQ2);
+      rowOut.flucQFrc[atom1] -= *(idat.dVdFQ1);
+      colOut.flucQFrc[atom2] -= *(idat.dVdFQ2);
     }
 
     if (storageLayout_ & DataStorage::dslElectricField) {              
-      snap_->atomData.electricField[atom1] += *(idat.eField1);
-      snap_->atomData.electricField[atom2] += *(idat.eField2);
+      rowOut.electricField[atom1] += *(idat.eField1);
+      colOut.electricField[atom2] += *(idat.eField2);
     }
 
     if (storageLayout_ & DataStorage::dslSitePotential) {              
-      snap_->atomData.sitePotential[atom1] += *(idat.sPot1);
-      snap_->atomData.sitePotential[atom2] += *(idat.sPot2);
+      rowOut.sitePotential[atom1] += *(idat.sPot1);
+      colOut.sitePotential[atom2] += *(idat.sPot2);
     }
 
 #endif
@@ -1356,21 +1555,31 @@ namespace OpenMD {
    * neighborList for each row-ordered CutoffGroup is given by the
    * returned vector point.
    */
+  /**
+   * Builds the cutoff-group neighbor list with linked cells.  The cells
+   * are half of the list radius wide, so each group only searches the
+   * 5 x 5 x 5 block of cells around its own.  Along an axis that is
+   * too short to hold that many distinct cells (thin slabs, skinny
+   * boxes, small bounding boxes) the stencil instead covers every
+   * cell along that axis exactly once.  No pair is ever found twice,
+   * and the work stays linear in the number of groups for any box
+   * shape.  Cells are laid out along the triclinic (or bounding) box
+   * vectors, so they work for both periodic and non-periodic runs.
+   */
   void ForceMatrixDecomposition::buildNeighborList(vector<int>& neighborList,
                                                    vector<int>& point) {
+    clock_t buildStart = clock();
+
     neighborList.clear();
     point.clear();
     int len = 0;
-    
-    bool doAllPairs = false;
 
     Snapshot* snap_ = sman_->getCurrentSnapshot();
     Mat3x3d box;
     Mat3x3d invBox;
 
-    Vector3d rs, scaled, dr;
-    Vector3i whichCell;
-    int cellIndex;
+    Vector3d rs, dr;
+    Vector3i whichCell, m2v;
 
 #ifdef IS_MPI
     cellListRow_.clear();
@@ -1404,252 +1613,117 @@ namespace OpenMD {
     CxA.normalize();
 
     // A set of perpendicular lengths in triclinic cells:
-    RealType Wa = abs(dot(A, BxC));
-    RealType Wb = abs(dot(B, CxA));
-    RealType Wc = abs(dot(C, AxB));
-    
-    nCells_.x() = int( Wa / rList_ );
-    nCells_.y() = int( Wb / rList_ );
-    nCells_.z() = int( Wc / rList_ );
-    
-    // handle small boxes where the cell offsets can end up repeating cells
-    if (nCells_.x() < 3) doAllPairs = true;
-    if (nCells_.y() < 3) doAllPairs = true;
-    if (nCells_.z() < 3) doAllPairs = true;
+    Vector3d W;
+    W[0] = abs(dot(A, BxC));
+    W[1] = abs(dot(B, CxA));
+    W[2] = abs(dot(C, AxB));
+
+    Vector3i lo, hi;
+    for (int k = 0; k < 3; k++) {
+      nCells_[k] = max(1, int( 2.0 * W[k] / rList_ ));
+      // number of cells needed to span the list radius along this axis:
+      int reach = int( ceil( rList_ * nCells_[k] / W[k] ) );
+      if (2 * reach + 1 >= nCells_[k]) {
+        lo[k] = 0;
+        hi[k] = nCells_[k] - 1;
+      } else {
+        lo[k] = -reach;
+        hi[k] = reach;
+      }
+    }
+
+    cellOffsets_.clear();
+    for (int oz = lo.z(); oz <= hi.z(); oz++)
+      for (int oy = lo.y(); oy <= hi.y(); oy++)
+        for (int ox = lo.x(); ox <= hi.x(); ox++)
+          cellOffsets_.push_back( Vector3i(ox, oy, oz) );
     
     int nCtot = nCells_.x() * nCells_.y() * nCells_.z();
     
 #ifdef IS_MPI
     cellListRow_.resize(nCtot);
     cellListCol_.resize(nCtot);
+
+    for (int i = 0; i < nGroupsInRow_; i++) {
+      whichCell = getCell(cgRowData.position[i], invBox);
+      // add this cutoff group to the list of groups in this cell;
+      cellListRow_[Vlinear(whichCell, nCells_)].push_back(i);
+    }
+    for (int i = 0; i < nGroupsInCol_; i++) {
+      whichCell = getCell(cgColData.position[i], invBox);
+      cellListCol_[Vlinear(whichCell, nCells_)].push_back(i);
+    }
 #else
     cellList_.resize(nCtot);
+
+    for (int i = 0; i < nGroups_; i++) {
+      whichCell = getCell(snap_->cgData.position[i], invBox);
+      cellList_[Vlinear(whichCell, nCells_)].push_back(i);
+    }
 #endif
-    
-    if (!doAllPairs) {
-      
+
 #ifdef IS_MPI
-      
-      for (int i = 0; i < nGroupsInRow_; i++) {
-        rs = cgRowData.position[i];
-        
-        // scaled positions relative to the box vectors
-        scaled = invBox * rs;
-        
-        // wrap the vector back into the unit box by subtracting integer box 
-        // numbers
-        for (int j = 0; j < 3; j++) {
-          scaled[j] -= roundMe(scaled[j]);
-          scaled[j] += 0.5;
-          // Handle the special case when an object is exactly on the
-          // boundary (a scaled coordinate of 1.0 is the same as
-          // scaled coordinate of 0.0)
-          if (scaled[j] >= 1.0) scaled[j] -= 1.0;
-        }
-        
-        // find xyz-indices of cell that cutoffGroup is in.
-        whichCell.x() = int(nCells_.x() * scaled.x());
-        whichCell.y() = int(nCells_.y() * scaled.y());
-        whichCell.z() = int(nCells_.z() * scaled.z());
-        
-        // find single index of this cell:
-        cellIndex = Vlinear(whichCell, nCells_);
-        
-        // add this cutoff group to the list of groups in this cell;
-        cellListRow_[cellIndex].push_back(i);
-      }
-      for (int i = 0; i < nGroupsInCol_; i++) {
-        rs = cgColData.position[i];
-        
-        // scaled positions relative to the box vectors
-        scaled = invBox * rs;
-        
-        // wrap the vector back into the unit box by subtracting integer box 
-        // numbers
-        for (int j = 0; j < 3; j++) {
-          scaled[j] -= roundMe(scaled[j]);
-          scaled[j] += 0.5;
-          // Handle the special case when an object is exactly on the
-          // boundary (a scaled coordinate of 1.0 is the same as
-          // scaled coordinate of 0.0)
-          if (scaled[j] >= 1.0) scaled[j] -= 1.0;
-        }
-        
-        // find xyz-indices of cell that cutoffGroup is in.
-        whichCell.x() = int(nCells_.x() * scaled.x());
-        whichCell.y() = int(nCells_.y() * scaled.y());
-        whichCell.z() = int(nCells_.z() * scaled.z());
-        
-        // find single index of this cell:
-        cellIndex = Vlinear(whichCell, nCells_);
-        
-        // add this cutoff group to the list of groups in this cell;
-        cellListCol_[cellIndex].push_back(i);
-      }
-            
+    for (int j1 = 0; j1 < nGroupsInRow_; j1++) {
+      rs = cgRowData.position[j1];
 #else
-      for (int i = 0; i < nGroups_; i++) {
-        rs = snap_->cgData.position[i];
-        
-        // scaled positions relative to the box vectors
-        scaled = invBox * rs;
-        
-        // wrap the vector back into the unit box by subtracting integer box 
-        // numbers
-        for (int j = 0; j < 3; j++) {
-          scaled[j] -= roundMe(scaled[j]);
-          scaled[j] += 0.5;
-          // Handle the special case when an object is exactly on the
-          // boundary (a scaled coordinate of 1.0 is the same as
-          // scaled coordinate of 0.0)
-          if (scaled[j] >= 1.0) scaled[j] -= 1.0;
-        }
-        
-        // find xyz-indices of cell that cutoffGroup is in.
-        whichCell.x() = int(nCells_.x() * scaled.x());
-        whichCell.y() = int(nCells_.y() * scaled.y());
-        whichCell.z() = int(nCells_.z() * scaled.z());
-        
-        // find single index of this cell:
-        cellIndex = Vlinear(whichCell, nCells_);
+    for (int j1 = 0; j1 < nGroups_; j1++) {
+      rs = snap_->cgData.position[j1];
+#endif
+      point[j1] = len;
+      whichCell = getCell(rs, invBox);
 
-        // add this cutoff group to the list of groups in this cell;
-        cellList_[cellIndex].push_back(i);
-      }
+      for (vector<Vector3i>::iterator os = cellOffsets_.begin();
+           os != cellOffsets_.end(); ++os) {
 
-#endif
+        // offsets never exceed the number of cells, so a single
+        // modulus wraps the neighboring cell back into the grid:
+        for (int k = 0; k < 3; k++)
+          m2v[k] = (whichCell[k] + (*os)[k] + nCells_[k]) % nCells_[k];
 
+        int m2 = Vlinear (m2v, nCells_);
 #ifdef IS_MPI
-      for (int j1 = 0; j1 < nGroupsInRow_; j1++) {
-        rs = cgRowData.position[j1];
-#else
-
-      for (int j1 = 0; j1 < nGroups_; j1++) {
-        rs = snap_->cgData.position[j1];
-#endif
-        point[j1] = len;
-        
-        // scaled positions relative to the box vectors
-        scaled = invBox * rs;
-        
-        // wrap the vector back into the unit box by subtracting integer box 
-        // numbers
-        for (int j = 0; j < 3; j++) {
-          scaled[j] -= roundMe(scaled[j]);
-          scaled[j] += 0.5;
-          // Handle the special case when an object is exactly on the
-          // boundary (a scaled coordinate of 1.0 is the same as
-          // scaled coordinate of 0.0)
-          if (scaled[j] >= 1.0) scaled[j] -= 1.0;
-        }
-        
-        // find xyz-indices of cell that cutoffGroup is in.
-        whichCell.x() = int(nCells_.x() * scaled.x());
-        whichCell.y() = int(nCells_.y() * scaled.y());
-        whichCell.z() = int(nCells_.z() * scaled.z());
-        
-        for (vector<Vector3i>::iterator os = cellOffsets_.begin();
-             os != cellOffsets_.end(); ++os) {
-              
-          Vector3i m2v = whichCell + (*os);
-
-          if (m2v.x() >= nCells_.x()) {
-            m2v.x() = 0;           
-          } else if (m2v.x() < 0) {
-            m2v.x() = nCells_.x() - 1; 
-          }
+        for (vector<int>::iterator j2 = cellListCol_[m2].begin(); 
+             j2 != cellListCol_[m2].end(); ++j2) {
           
-          if (m2v.y() >= nCells_.y()) {
-            m2v.y() = 0;           
-          } else if (m2v.y() < 0) {
-            m2v.y() = nCells_.y() - 1; 
+          // In parallel, we need to visit *all* pairs of row
+          // & column indicies and will divide labor in the
+          // force evaluation later.
+          dr = cgColData.position[(*j2)] - rs;
+          if (usePeriodicBoundaryConditions_) {
+            snap_->wrapVector(dr);
           }
+          if (dr.lengthSquare() < rListSq_) {
+            neighborList.push_back( (*j2) );
+            ++len;
+          }                 
+        }        
+#else
+        for (vector<int>::iterator j2 = cellList_[m2].begin(); 
+             j2 != cellList_[m2].end(); ++j2) {
           
-          if (m2v.z() >= nCells_.z()) {
-            m2v.z() = 0;           
-          } else if (m2v.z() < 0) {
-            m2v.z() = nCells_.z() - 1; 
-          }
-          int m2 = Vlinear (m2v, nCells_);                                      
-#ifdef IS_MPI
-          for (vector<int>::iterator j2 = cellListCol_[m2].begin(); 
-               j2 != cellListCol_[m2].end(); ++j2) {
+          // Always do this if we're in different cells or if
+          // we're in the same cell and the global index of
+          // the j2 cutoff group is greater than or equal to
+          // the j1 cutoff group.  Note that Rappaport's code
+          // has a "less than" conditional here, but that
+          // deals with atom-by-atom computation.  OpenMD
+          // allows atoms within a single cutoff group to
+          // interact with each other.
+          
+          if ( (*j2) >= j1 ) {
             
-            // In parallel, we need to visit *all* pairs of row
-            // & column indicies and will divide labor in the
-            // force evaluation later.
-            dr = cgColData.position[(*j2)] - rs;
+            dr = snap_->cgData.position[(*j2)] - rs;
             if (usePeriodicBoundaryConditions_) {
               snap_->wrapVector(dr);
             }
-            if (dr.lengthSquare() < rListSq_) {
+            if ( dr.lengthSquare() < rListSq_) {
               neighborList.push_back( (*j2) );
               ++len;
-            }                 
-          }        
-#else
-          for (vector<int>::iterator j2 = cellList_[m2].begin(); 
-               j2 != cellList_[m2].end(); ++j2) {
-          
-            // Always do this if we're in different cells or if
-            // we're in the same cell and the global index of
-            // the j2 cutoff group is greater than or equal to
-            // the j1 cutoff group.  Note that Rappaport's code
-            // has a "less than" conditional here, but that
-            // deals with atom-by-atom computation.  OpenMD
-            // allows atoms within a single cutoff group to
-            // interact with each other.
-            
-            if ( (*j2) >= j1 ) {
-              
-              dr = snap_->cgData.position[(*j2)] - rs;
-              if (usePeriodicBoundaryConditions_) {
-                snap_->wrapVector(dr);
-              }
-              if ( dr.lengthSquare() < rListSq_) {
-                neighborList.push_back( (*j2) );
-                ++len;
-              }
             }
-          }                
-#endif
-        }
-      }      
-    } else {
-      // branch to do all cutoff group pairs
-#ifdef IS_MPI
-      for (int j1 = 0; j1 < nGroupsInRow_; j1++) {
-        point[j1] = len;
-        rs = cgRowData.position[j1];
-        for (int j2 = 0; j2 < nGroupsInCol_; j2++) {    
-          dr = cgColData.position[j2] - rs;
-          if (usePeriodicBoundaryConditions_) {
-            snap_->wrapVector(dr);
-          }
-          if (dr.lengthSquare() < rListSq_) {
-            neighborList.push_back( j2 );
-            ++len;
           }
-        }
-      }      
-#else
-      // include all groups here.
-      for (int j1 = 0; j1 < nGroups_; j1++) {
-        point[j1] = len;
-        rs = snap_->cgData.position[j1];
-        // include self group interactions j2 == j1
-        for (int j2 = j1; j2 < nGroups_; j2++) {
-          dr = snap_->cgData.position[j2] - rs;
-          if (usePeriodicBoundaryConditions_) {
-            snap_->wrapVector(dr);
-          }
-          if (dr.lengthSquare() < rListSq_) {
-            neighborList.push_back( j2 );
-            ++len;
-          }
-        }    
-      }
+        }                
 #endif
+      }
     }
 
 #ifdef IS_MPI
@@ -1657,6 +1731,23 @@ namespace OpenMD {
 #else
     point[nGroups_] = len;
 #endif
+
+    // report the cell grid whenever it changes:
+    if (nCells_.x() != reportedCells_.x() ||
+        nCells_.y() != reportedCells_.y() ||
+        nCells_.z() != reportedCells_.z()) {
+      reportedCells_ = nCells_;
+      RealType buildTime = RealType(clock() - buildStart) / CLOCKS_PER_SEC;
+      sprintf(painCave.errMsg,
+              "ForceMatrixDecomposition::buildNeighborList: using a\n"
+              "\t%d x %d x %d linked-cell grid, searching %d cells around\n"
+              "\teach cell.  This neighbor list build took %.3g seconds.\n",
+              nCells_.x(), nCells_.y(), nCells_.z(),
+              int(cellOffsets_.size()), buildTime);
+      painCave.isFatal = 0;
+      painCave.severity = OPENMD_INFO;
+      simError();
+    }
   
     // save the local cutoff group positions for the check that is
     // done on each loop:
@@ -1665,6 +1756,29 @@ namespace OpenMD {
     for (int i = 0; i < nGroups_; i++)
       saved_CG_positions_.push_back(snap_->cgData.position[i]);
   }
+
+  /**
+   * Returns the xyz-indices of the neighbor-list cell that holds a
+   * position, after wrapping it back into the (scaled) unit box.
+   */
+  Vector3i ForceMatrixDecomposition::getCell(const Vector3d& pos,
+                                             const Mat3x3d& invBox) {
+    Vector3d scaled = invBox * pos;
+    Vector3i cell;
+
+    for (int j = 0; j < 3; j++) {
+      // wrap the vector back into the unit box by subtracting integer box
+      // numbers
+      scaled[j] -= roundMe(scaled[j]);
+      scaled[j] += 0.5;
+      // Handle the special case when an object is exactly on the
+      // boundary (a scaled coordinate of 1.0 is the same as
+      // scaled coordinate of 0.0)
+      if (scaled[j] >= 1.0) scaled[j] -= 1.0;
+      cell[j] = int(nCells_[j] * scaled[j]);
+    }
+    return cell;
+  }
     
     
     int ForceMatrixDecomposition::getGlobalIDRow(int atom1) {
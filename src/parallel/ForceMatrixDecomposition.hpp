@@ -66,6 +66,10 @@ namespace OpenMD {
     void collectSelfData();
     void collectData();
 
+    // shared-memory threading of the pair loop
+    void setNumThreads(int nThreads);
+    void reduceThreadData();
+
     // neighbor list routines
     void buildNeighborList(vector<int>& neighborList, vector<int>& point);
 
@@ -93,17 +97,49 @@ namespace OpenMD {
     int getGlobalIDRow(int atom1);
     int getGlobalIDCol(int atom1);
     int getGlobalID(int atom1);
-    void addForceToAtomRow(int atom1, Vector3d fg);
-    void addForceToAtomColumn(int atom2, Vector3d fg);
+    int getIdentRow(int atom1);
+    int getIdentCol(int atom2);
+    void addForceToAtomRow(int atom1, Vector3d fg, int tid = 0);
+    void addForceToAtomColumn(int atom2, Vector3d fg, int tid = 0);
     Vector3d& getAtomVelocityColumn(int atom2);
 
     // filling interaction blocks with pointers
-    void fillInteractionData(InteractionData &idat, int atom1, int atom2, bool newAtom1 = true);
-    void unpackInteractionData(InteractionData &idat, int atom1, int atom2);
+    void fillInteractionData(InteractionData &idat, int atom1, int atom2, bool newAtom1 = true, int tid = 0);
+    void unpackInteractionData(InteractionData &idat, int atom1, int atom2, int tid = 0);
 
   private:     
     int nLocal_;
     int nGroups_;
+
+    /**
+     * Private accumulation arrays for one of the threads (other than
+     * thread 0) sharing the pair loop.  Only the quantities that are
+     * written during the pair loop are stored here; everything that
+     * is read-only (positions, orientations, multipoles, functionals)
+     * is shared with the normal work arrays.
+     */
+    struct ThreadWorkData {
+      DataStorage rowData;  /**< local atoms (or row atoms in parallel) */
+      potVec pairwisePot;
+      potVec excludedPot;
+      potVec selectedPot;
+#ifdef IS_MPI
+      DataStorage colData;  /**< column atoms */
+      vector<potVec> pot_row;
+      vector<potVec> pot_col;
+      vector<potVec> expot_row;
+      vector<potVec> expot_col;
+      vector<potVec> selepot_row;
+      vector<potVec> selepot_col;
+#endif
+    };
+    vector<ThreadWorkData> threadWork_;
+    int threadLayout_;
+    void zeroThreadWorkArrays();
+    Vector3i getCell(const Vector3d& pos, const Mat3x3d& invBox);
+    Vector3i reportedCells_;   /**< cell grid last reported to the user */
+    DataStorage& getRowStorage(int tid);
+    DataStorage& getColumnStorage(int tid);
     vector<int> AtomLocalToGlobal;
     vector<int> cgLocalToGlobal;
     vector<RealType> groupCutoff;
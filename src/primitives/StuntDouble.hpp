@@ -128,7 +128,15 @@ namespace OpenMD{
     void setLocalIndex(int index) {
       localIndex_ = index;
     }
-    
+
+    /**
+     * Returns the member of a Snapshot (atomData or rigidbodyData)
+     * which holds the data of this stuntDouble
+     */
+    DataStoragePointer getStorage() {
+      return storage_;
+    }
+
     int getGlobalIntegrableObjectIndex(){
       return globalIntegrableObjectIndex_; 
     }
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2005, 2010 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *                                                                      
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).             
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).          
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).          
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "selection/CellGrid.hpp"
+
+namespace OpenMD {
+
+  CellGrid::CellGrid() : snap_(NULL), usePBC_(false), nCells_(1, 1, 1) {
+    cellStart_.resize(2, 0);
+  }
+
+  void CellGrid::build(Snapshot* snap, const std::vector<Vector3d>& points) {
+    snap_ = snap;
+    usePBC_ = snap->frameData.usePBC;
+    points_ = points;
+
+    if (usePBC_) {
+      // widths of the box are the distances between opposite faces,
+      // which are the inverse lengths of the rows of invHmat:
+      invHmat_ = snap->getInvHmat();
+      for (int i = 0; i < 3; i++) {
+        Vector3d row = invHmat_.getRow(i);
+        widths_[i] = 1.0 / row.length();
+      }
+    } else {
+      Vector3d lo(0.0), hi(0.0);
+      if (!points_.empty()) {
+        lo = points_[0];
+        hi = points_[0];
+      }
+      for (unsigned int j = 1; j < points_.size(); ++j) {
+        for (int i = 0; i < 3; i++) {
+          lo[i] = std::min(lo[i], points_[j][i]);
+          hi[i] = std::max(hi[i], points_[j][i]);
+        }
+      }
+      origin_ = lo;
+      widths_ = hi - lo;
+    }
+
+    // aim for a few points per cell, using only the sides of the grid
+    // that have some extent:
+    int nTarget = std::max(1, int(points_.size()) / 4);
+    RealType vol = 1.0;
+    int nDims = 0;
+    for (int i = 0; i < 3; i++) {
+      if (widths_[i] > 0.0) {
+        vol *= widths_[i];
+        nDims++;
+      }
+    }
+    RealType edge = 0.0;
+    if (nDims > 0) edge = pow(vol / RealType(nTarget), 1.0 / RealType(nDims));
+
+    for (int i = 0; i < 3; i++) {
+      nCells_[i] = 1;
+      if (widths_[i] > 0.0 && edge > 0.0)
+        nCells_[i] = std::max(1, int(widths_[i] / edge));
+    }
+
+    int nTotal = nCells_[0] * nCells_[1] * nCells_[2];
+    std::vector<int> cellOf(points_.size());
+    cellStart_.assign(nTotal + 1, 0);
+
+    for (unsigned int j = 0; j < points_.size(); ++j) {
+      Vector3d s = getScaledPos(points_[j]);
+      int c[3];
+      for (int i = 0; i < 3; i++) {
+        c[i] = int(s[i] * nCells_[i]);
+        c[i] = std::min(std::max(c[i], 0), nCells_[i] - 1);
+      }
+      cellOf[j] = getCellIndex(c[0], c[1], c[2]);
+      cellStart_[cellOf[j] + 1]++;
+    }
+    for (int c = 0; c < nTotal; ++c)
+      cellStart_[c + 1] += cellStart_[c];
+
+    std::vector<int> fill(cellStart_.begin(), cellStart_.end() - 1);
+    cellMembers_.resize(points_.size());
+    for (unsigned int j = 0; j < points_.size(); ++j)
+      cellMembers_[fill[cellOf[j]]++] = j;
+  }
+
+  void CellGrid::findWithin(const Vector3d& center, RealType distance,
+                            std::vector<int>& found) {
+    if (points_.empty()) return;
+
+    Vector3d s = getScaledPos(center);
+    int lo[3], hi[3];
+
+    for (int i = 0; i < 3; i++) {
+      if (widths_[i] > 0.0) {
+        // the padding keeps round-off in the scaled coordinates from
+        // excluding a cell that holds a point right at the boundary:
+        RealType reach = distance / widths_[i];
+        lo[i] = int(floor((s[i] - reach) * nCells_[i] - 1.0e-8));
+        hi[i] = int(floor((s[i] + reach) * nCells_[i] + 1.0e-8));
+      } else {
+        lo[i] = 0;
+        hi[i] = 0;
+      }
+      if (usePBC_) {
+        // a search that spans the whole box must not visit any cell twice
+        if (hi[i] - lo[i] + 1 >= nCells_[i]) {
+          lo[i] = 0;
+          hi[i] = nCells_[i] - 1;
+        }
+      } else {
+        lo[i] = std::max(lo[i], 0);
+        hi[i] = std::min(hi[i], nCells_[i] - 1);
+        if (lo[i] > hi[i]) return;
+      }
+    }
+
+    for (int a = lo[0]; a <= hi[0]; a++) {
+      int ca = (a % nCells_[0] + nCells_[0]) % nCells_[0];
+      for (int b = lo[1]; b <= hi[1]; b++) {
+        int cb = (b % nCells_[1] + nCells_[1]) % nCells_[1];
+        for (int c = lo[2]; c <= hi[2]; c++) {
+          int cc = (c % nCells_[2] + nCells_[2]) % nCells_[2];
+          int cell = getCellIndex(ca, cb, cc);
+
+          for (int m = cellStart_[cell]; m < cellStart_[cell + 1]; ++m) {
+            int j = cellMembers_[m];
+            Vector3d r = center - points_[j];
+            snap_->wrapVector(r);
+            if (r.length() <= distance) found.push_back(j);
+          }
+        }
+      }
+    }
+  }
+
+  Vector3d CellGrid::getScaledPos(const Vector3d& pos) {
+    Vector3d s;
+    if (usePBC_) {
+      s = invHmat_ * pos;
+      for (int i = 0; i < 3; i++) s[i] -= floor(s[i]);
+    } else {
+      for (int i = 0; i < 3; i++)
+        s[i] = widths_[i] > 0.0 ? (pos[i] - origin_[i]) / widths_[i] : 0.0;
+    }
+    return s;
+  }
+
+  int CellGrid::getCellIndex(int cx, int cy, int cz) {
+    return (cx * nCells_[1] + cy) * nCells_[2] + cz;
+  }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2005, 2010 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *                                                                      
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).             
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).          
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).          
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+ 
+#ifndef SELECTION_CELLGRID_HPP
+#define SELECTION_CELLGRID_HPP
+
+#include <vector>
+#include "math/Vector3.hpp"
+#include "math/SquareMatrix3.hpp"
+#include "brains/Snapshot.hpp"
+
+namespace OpenMD {
+
+  /**
+   * @class CellGrid
+   * A grid of cells over the simulation box used to find all of the
+   * points that lie within some distance of a center.  In periodic
+   * boxes the grid is laid out in scaled coordinates and the search
+   * wraps around the box using the same minimum image convention as
+   * Snapshot::wrapVector.  Without periodic boundaries, the grid
+   * covers the bounding box of the points.
+   */
+  class CellGrid {
+  public:
+    CellGrid();
+
+    /**
+     * Sorts a set of points into cells.
+     * @param snap the snapshot supplying the box geometry
+     * @param points the locations to sort; indices into this vector
+     * are returned by findWithin
+     */
+    void build(Snapshot* snap, const std::vector<Vector3d>& points);
+
+    /**
+     * Appends the indices of all points within distance of center
+     * (r.length() <= distance after wrapping) to found.
+     */
+    void findWithin(const Vector3d& center, RealType distance,
+                    std::vector<int>& found);
+
+  private:
+    Vector3d getScaledPos(const Vector3d& pos);
+    int getCellIndex(int cx, int cy, int cz);
+
+    Snapshot* snap_;
+    bool usePBC_;
+    Mat3x3d invHmat_;
+    Vector3d origin_;          /**< corner of the grid without PBC */
+    Vector3d widths_;          /**< distances between faces of the grid */
+    Vector3i nCells_;          /**< cells along each side */
+    std::vector<Vector3d> points_;
+    std::vector<int> cellStart_;   /**< first entry of each cell in cellMembers_ */
+    std::vector<int> cellMembers_; /**< point indices ordered by cell */
+  };
+}
+#endif
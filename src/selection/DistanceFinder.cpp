@@ -49,7 +49,12 @@
 
 namespace OpenMD {
   
-  DistanceFinder::DistanceFinder(SimInfo* info) : info_(info) {
+  DistanceFinder::DistanceFinder(SimInfo* info) : info_(info),
+                                                  haveIndex_(false),
+                                                  indexSnapshot_(NULL),
+                                                  indexID_(-1),
+                                                  indexTime_(0.0),
+                                                  indexFrame_(-1) {
     nObjects_.push_back(info_->getNGlobalAtoms()+info_->getNGlobalRigidBodies());
     nObjects_.push_back(info_->getNGlobalBonds());
     nObjects_.push_back(info_->getNGlobalBends());
@@ -63,6 +68,9 @@ namespace OpenMD {
     torsions_.resize(nObjects_[TORSION]);
     inversions_.resize(nObjects_[INVERSION]);
     molecules_.resize(nObjects_[MOLECULE]);
+
+    grids_.resize(N_SELECTIONTYPES);
+    gridObjects_.resize(N_SELECTIONTYPES);
     
     SimInfo::MoleculeIterator mi;
     Molecule::AtomIterator ai;
@@ -114,144 +122,128 @@ namespace OpenMD {
   }
 
   SelectionSet DistanceFinder::find(const SelectionSet& bs, RealType distance) {
-    StuntDouble* center;
-    Vector3d centerPos;
     Snapshot* currSnapshot = info_->getSnapshotManager()->getCurrentSnapshot();
-    SelectionSet bsResult(nObjects_);   
-    assert(bsResult.size() == bs.size());
-    
-#ifdef IS_MPI
-    int mol;
-    int proc;
-    RealType data[3];
-    int worldRank;
-    MPI_Comm_rank( MPI_COMM_WORLD, &worldRank);
-#endif
+    return find(bs, distance, currSnapshot, -1);
+  }
+
+  SelectionSet DistanceFinder::find(const SelectionSet& bs, RealType distance, int frame ) {
+    Snapshot* currSnapshot = info_->getSnapshotManager()->getSnapshot(frame);
+    return find(bs, distance, currSnapshot, frame);
+  }
+
+  // frame < 0 refers to the current snapshot
+  static Vector3d getLocation(StuntDouble* sd, int frame) {
+    return frame < 0 ? sd->getPos() : sd->getPos(frame);
+  }
+
+  void DistanceFinder::buildIndex(Snapshot* snap, int frame) {
+
+    if (haveIndex_ && snap == indexSnapshot_ && snap->getID() == indexID_ &&
+        snap->getTime() == indexTime_ && frame == indexFrame_) return;
 
-    
     for (unsigned int j = 0; j < stuntdoubles_.size(); ++j) {
       if (stuntdoubles_[j] != NULL) {
         if (stuntdoubles_[j]->isRigidBody()) {
           RigidBody* rb = static_cast<RigidBody*>(stuntdoubles_[j]);
-          rb->updateAtoms();
+          if (frame < 0) 
+            rb->updateAtoms();
+          else
+            rb->updateAtoms(frame);
         }
       }
     }
-            
-    SelectionSet bsTemp = bs;
-    bsTemp = bsTemp.parallelReduce();
 
-    for(int i = 0; i < bsTemp.bitsets_[STUNTDOUBLE].size(); ++i) {
-      if (bsTemp.bitsets_[STUNTDOUBLE][i]) {
-             
-#ifdef IS_MPI
-        
-        // Now, if we own stuntdouble i, we can use the position, but in
-        // parallel, we'll need to let everyone else know what that
-        // position is!
-        
-        mol = info_->getGlobalMolMembership(i);
-        proc = info_->getMolToProc(mol);        
-        
-        if (proc == worldRank) {
-          center = stuntdoubles_[i];
-          centerPos = center->getPos();
-          data[0] = centerPos.x();
-          data[1] = centerPos.y();
-          data[2] = centerPos.z();
-          MPI_Bcast(data, 3, MPI_REALTYPE, proc, MPI_COMM_WORLD);
-        } else {
-          MPI_Bcast(data, 3, MPI_REALTYPE, proc, MPI_COMM_WORLD);
-          centerPos = Vector3d(data);
-        }
-#else
-        center = stuntdoubles_[i];
-        centerPos = center->getPos();
-#endif               
-        for (unsigned int j = 0; j < molecules_.size(); ++j) {
-          if (molecules_[j] != NULL) {
-            Vector3d r =centerPos - molecules_[j]->getCom();
-            currSnapshot->wrapVector(r);
-            if (r.length() <= distance) {
-              bsResult.bitsets_[MOLECULE].setBitOn(j);
-            }
-          }
-        }
-        for (unsigned int j = 0; j < stuntdoubles_.size(); ++j) {
-          if (stuntdoubles_[j] != NULL) {
-            Vector3d r =centerPos - stuntdoubles_[j]->getPos();
-            currSnapshot->wrapVector(r);
-            if (r.length() <= distance) {
-              bsResult.bitsets_[STUNTDOUBLE].setBitOn(j);
-            }
-          }
-        }
-        for (unsigned int j = 0; j < bonds_.size(); ++j) {
-          if (bonds_[j] != NULL) {
-            Vector3d loc = bonds_[j]->getAtomA()->getPos();
-            loc += bonds_[j]->getAtomB()->getPos();
-            loc = loc / 2.0;
-            Vector3d r = centerPos - loc;
-            currSnapshot->wrapVector(r);
-            if (r.length() <= distance) {
-              bsResult.bitsets_[BOND].setBitOn(j);
-            }
-          }
-        }
-        for (unsigned int j = 0; j < bends_.size(); ++j) {
-          if (bends_[j] != NULL) {          
-            Vector3d loc = bends_[j]->getAtomA()->getPos();
-            loc += bends_[j]->getAtomB()->getPos();
-            loc += bends_[j]->getAtomC()->getPos();
-            loc = loc / 3.0;
-            Vector3d r = centerPos - loc;
-            currSnapshot->wrapVector(r);
-            if (r.length() <= distance) {
-              bsResult.bitsets_[BEND].setBitOn(j);
-            }
-          }
-        }
-        for (unsigned int j = 0; j < torsions_.size(); ++j) {
-          if (torsions_[j] != NULL) {
-            Vector3d loc = torsions_[j]->getAtomA()->getPos();
-            loc += torsions_[j]->getAtomB()->getPos();
-            loc += torsions_[j]->getAtomC()->getPos();
-            loc += torsions_[j]->getAtomD()->getPos();
-            loc = loc / 4.0;
-            Vector3d r = centerPos - loc;
-            currSnapshot->wrapVector(r);
-            if (r.length() <= distance) {
-              bsResult.bitsets_[TORSION].setBitOn(j);
-            }
-          }
-        }
-        for (unsigned int j = 0; j < inversions_.size(); ++j) {
-          if (inversions_[j] != NULL) {
-            Vector3d loc = inversions_[j]->getAtomA()->getPos();
-            loc += inversions_[j]->getAtomB()->getPos();
-            loc += inversions_[j]->getAtomC()->getPos();
-            loc += inversions_[j]->getAtomD()->getPos();
-            loc = loc / 4.0;
-            Vector3d r = centerPos - loc;
-            currSnapshot->wrapVector(r);
-            if (r.length() <= distance) {
-              bsResult.bitsets_[INVERSION].setBitOn(j);
-            }
-          }
-        }
+    std::vector<Vector3d> points;
+    Vector3d loc;
+
+    for (int k = 0; k < N_SELECTIONTYPES; ++k)
+      gridObjects_[k].clear();
+
+    for (unsigned int j = 0; j < molecules_.size(); ++j) {
+      if (molecules_[j] != NULL) {
+        loc = frame < 0 ? molecules_[j]->getCom() : molecules_[j]->getCom(frame);
+        points.push_back(loc);
+        gridObjects_[MOLECULE].push_back(j);
       }
     }
-    return bsResult;
+    grids_[MOLECULE].build(snap, points);
+
+    points.clear();
+    for (unsigned int j = 0; j < stuntdoubles_.size(); ++j) {
+      if (stuntdoubles_[j] != NULL) {
+        points.push_back(getLocation(stuntdoubles_[j], frame));
+        gridObjects_[STUNTDOUBLE].push_back(j);
+      }
+    }
+    grids_[STUNTDOUBLE].build(snap, points);
+
+    points.clear();
+    for (unsigned int j = 0; j < bonds_.size(); ++j) {
+      if (bonds_[j] != NULL) {
+        loc = getLocation(bonds_[j]->getAtomA(), frame);
+        loc += getLocation(bonds_[j]->getAtomB(), frame);
+        loc = loc / 2.0;
+        points.push_back(loc);
+        gridObjects_[BOND].push_back(j);
+      }
+    }
+    grids_[BOND].build(snap, points);
+
+    points.clear();
+    for (unsigned int j = 0; j < bends_.size(); ++j) {
+      if (bends_[j] != NULL) {
+        loc = getLocation(bends_[j]->getAtomA(), frame);
+        loc += getLocation(bends_[j]->getAtomB(), frame);
+        loc += getLocation(bends_[j]->getAtomC(), frame);
+        loc = loc / 3.0;
+        points.push_back(loc);
+        gridObjects_[BEND].push_back(j);
+      }
+    }
+    grids_[BEND].build(snap, points);
+
+    points.clear();
+    for (unsigned int j = 0; j < torsions_.size(); ++j) {
+      if (torsions_[j] != NULL) {
+        loc = getLocation(torsions_[j]->getAtomA(), frame);
+        loc += getLocation(torsions_[j]->getAtomB(), frame);
+        loc += getLocation(torsions_[j]->getAtomC(), frame);
+        loc += getLocation(torsions_[j]->getAtomD(), frame);
+        loc = loc / 4.0;
+        points.push_back(loc);
+        gridObjects_[TORSION].push_back(j);
+      }
+    }
+    grids_[TORSION].build(snap, points);
+
+    points.clear();
+    for (unsigned int j = 0; j < inversions_.size(); ++j) {
+      if (inversions_[j] != NULL) {
+        loc = getLocation(inversions_[j]->getAtomA(), frame);
+        loc += getLocation(inversions_[j]->getAtomB(), frame);
+        loc += getLocation(inversions_[j]->getAtomC(), frame);
+        loc += getLocation(inversions_[j]->getAtomD(), frame);
+        loc = loc / 4.0;
+        points.push_back(loc);
+        gridObjects_[INVERSION].push_back(j);
+      }
+    }
+    grids_[INVERSION].build(snap, points);
+
+    haveIndex_ = true;
+    indexSnapshot_ = snap;
+    indexID_ = snap->getID();
+    indexTime_ = snap->getTime();
+    indexFrame_ = frame;
   }
-  
-  
-  SelectionSet DistanceFinder::find(const SelectionSet& bs, RealType distance, int frame ) {
-    StuntDouble * center;
+
+  SelectionSet DistanceFinder::find(const SelectionSet& bs, RealType distance,
+                                    Snapshot* currSnapshot, int frame) {
+    StuntDouble* center;
     Vector3d centerPos;
-    Snapshot* currSnapshot = info_->getSnapshotManager()->getSnapshot(frame);
     SelectionSet bsResult(nObjects_);   
     assert(bsResult.size() == bs.size());
-
+    
 #ifdef IS_MPI
     int mol;
     int proc;
@@ -259,36 +251,32 @@ namespace OpenMD {
     int worldRank;
     MPI_Comm_rank( MPI_COMM_WORLD, &worldRank);
 #endif
- 
-    for (unsigned int j = 0; j < stuntdoubles_.size(); ++j) {
-      if (stuntdoubles_[j] != NULL) {        
-        if (stuntdoubles_[j]->isRigidBody()) {
-          RigidBody* rb = static_cast<RigidBody*>(stuntdoubles_[j]);
-          rb->updateAtoms(frame);
-        }
-      }
-    }
-    
+
+    buildIndex(currSnapshot, frame);
+            
     SelectionSet bsTemp = bs;
     bsTemp = bsTemp.parallelReduce();
-    
+
+    std::vector<int> found;
+
     for(int i = 0; i < bsTemp.bitsets_[STUNTDOUBLE].size(); ++i) {
       if (bsTemp.bitsets_[STUNTDOUBLE][i]) {
+             
+#ifdef IS_MPI
         
         // Now, if we own stuntdouble i, we can use the position, but in
         // parallel, we'll need to let everyone else know what that
         // position is!
         
-#ifdef IS_MPI
         mol = info_->getGlobalMolMembership(i);
-        proc = info_->getMolToProc(mol);
+        proc = info_->getMolToProc(mol);        
         
         if (proc == worldRank) {
           center = stuntdoubles_[i];
-          centerPos = center->getPos(frame);
+          centerPos = getLocation(center, frame);
           data[0] = centerPos.x();
           data[1] = centerPos.y();
-          data[2] = centerPos.z();          
+          data[2] = centerPos.z();
           MPI_Bcast(data, 3, MPI_REALTYPE, proc, MPI_COMM_WORLD);
         } else {
           MPI_Bcast(data, 3, MPI_REALTYPE, proc, MPI_COMM_WORLD);
@@ -296,83 +284,16 @@ namespace OpenMD {
         }
 #else
         center = stuntdoubles_[i];
-        centerPos = center->getPos(frame);
-#endif
-        for (unsigned int j = 0; j < molecules_.size(); ++j) {
-          if (molecules_[j] != NULL) {
-            Vector3d r =centerPos - molecules_[j]->getCom(frame);
-            currSnapshot->wrapVector(r);
-            if (r.length() <= distance) {
-              bsResult.bitsets_[MOLECULE].setBitOn(j);
-            }
-          }
-        }
-        
-        for (unsigned int j = 0; j < stuntdoubles_.size(); ++j) {
-          if (stuntdoubles_[j] != NULL) {          
-            Vector3d r =centerPos - stuntdoubles_[j]->getPos(frame);
-            currSnapshot->wrapVector(r);
-            if (r.length() <= distance) {
-              bsResult.bitsets_[STUNTDOUBLE].setBitOn(j);
-            }
-          }
-        }
-        for (unsigned int j = 0; j < bonds_.size(); ++j) {
-          if (bonds_[j] != NULL) {
-            Vector3d loc = bonds_[j]->getAtomA()->getPos(frame);
-            loc += bonds_[j]->getAtomB()->getPos(frame);
-            loc = loc / 2.0;
-            Vector3d r = centerPos - loc;
-            currSnapshot->wrapVector(r);
-            if (r.length() <= distance) {
-              bsResult.bitsets_[BOND].setBitOn(j);
-            }
-          }
-        }
-        for (unsigned int j = 0; j < bends_.size(); ++j) {
-          if (bends_[j] != NULL) {
-            Vector3d loc = bends_[j]->getAtomA()->getPos(frame);
-            loc += bends_[j]->getAtomB()->getPos(frame);
-            loc += bends_[j]->getAtomC()->getPos(frame);
-            loc = loc / 3.0;
-            Vector3d r = centerPos - loc;
-            currSnapshot->wrapVector(r);
-            if (r.length() <= distance) {
-              bsResult.bitsets_[BEND].setBitOn(j);
-            }
-          }
-        }
-        for (unsigned int j = 0; j < torsions_.size(); ++j) {
-          if (torsions_[j] != NULL) {
-            Vector3d loc = torsions_[j]->getAtomA()->getPos(frame);
-            loc += torsions_[j]->getAtomB()->getPos(frame);
-            loc += torsions_[j]->getAtomC()->getPos(frame);
-            loc += torsions_[j]->getAtomD()->getPos(frame);
-            loc = loc / 4.0;
-            Vector3d r = centerPos - loc;
-            currSnapshot->wrapVector(r);
-            if (r.length() <= distance) {
-              bsResult.bitsets_[TORSION].setBitOn(j);
-            }
-          }
+        centerPos = getLocation(center, frame);
+#endif               
+        for (int k = 0; k < N_SELECTIONTYPES; ++k) {
+          found.clear();
+          grids_[k].findWithin(centerPos, distance, found);
+          for (unsigned int m = 0; m < found.size(); ++m)
+            bsResult.bitsets_[k].setBitOn(gridObjects_[k][found[m]]);
         }
-        for (unsigned int j = 0; j < inversions_.size(); ++j) {
-          if (inversions_[j] != NULL) {
-            Vector3d loc = inversions_[j]->getAtomA()->getPos(frame);
-            loc += inversions_[j]->getAtomB()->getPos(frame);
-            loc += inversions_[j]->getAtomC()->getPos(frame);
-            loc += inversions_[j]->getAtomD()->getPos(frame);
-            loc = loc / 4.0;
-            Vector3d r = centerPos - loc;
-            currSnapshot->wrapVector(r);
-            if (r.length() <= distance) {
-              bsResult.bitsets_[INVERSION].setBitOn(j);
-            }
-          }
-        }      
       }
     }
-    return bsResult;    
+    return bsResult;
   }
 }
-  
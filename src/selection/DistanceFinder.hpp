@@ -48,6 +48,7 @@
 #include "primitives/Bend.hpp"
 #include "primitives/Torsion.hpp"
 #include "primitives/Inversion.hpp"
+#include "selection/CellGrid.hpp"
 namespace OpenMD {
 
   class DistanceFinder {
@@ -57,6 +58,13 @@ namespace OpenMD {
     SelectionSet find(const SelectionSet& bs, RealType distance);
     SelectionSet find(const SelectionSet& bs, RealType distance, int frame);
 
+    /**
+     * Discards the cell grids, so the next find rebuilds them from the
+     * current positions.  The grids are otherwise reused by every
+     * find on the same frame.
+     */
+    void clearIndex() { haveIndex_ = false; }
+
     SimInfo* info_;
     std::vector<StuntDouble*> stuntdoubles_;
     std::vector<Bond*> bonds_;
@@ -65,7 +73,21 @@ namespace OpenMD {
     std::vector<Inversion*> inversions_;
     std::vector<Molecule*> molecules_;
     vector<int> nObjects_;
-        
+
+  private:
+    SelectionSet find(const SelectionSet& bs, RealType distance,
+                      Snapshot* snap, int frame);
+    void buildIndex(Snapshot* snap, int frame);
+
+    // one cell grid for each SelectionType, holding the locations of
+    // the local objects, and the global index of each grid point:
+    std::vector<CellGrid> grids_;
+    std::vector<std::vector<int> > gridObjects_;
+    bool haveIndex_;
+    Snapshot* indexSnapshot_;
+    int indexID_;
+    RealType indexTime_;
+    int indexFrame_;
   };
 
 }
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2005, 2010 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *                                                                      
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).             
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).          
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).          
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#ifdef IS_MPI
+#include <mpi.h>
+#endif
+
+#include <cstring>
+#include "selection/SelectionCache.hpp"
+#include "brains/SnapshotManager.hpp"
+#include "primitives/Molecule.hpp"
+
+namespace OpenMD {
+
+  static const std::string SelectionCacheID("SelectionCache");
+
+  // FNV-1a style mixing, one whole value at a time
+  static inline void hashValue(unsigned long long& h, RealType value) {
+    unsigned long long bits = 0;
+    memcpy(&bits, &value, 
+           sizeof(RealType) < sizeof(bits) ? sizeof(RealType) : sizeof(bits));
+    h ^= bits;
+    h *= 1099511628211ULL;
+  }
+
+  SelectionCache* SelectionCache::getCache(SimInfo* info) {
+    SelectionCacheData* data = 
+      dynamic_cast<SelectionCacheData*>(info->getPropertyByName(SelectionCacheID));
+    if (data == NULL) {
+      data = new SelectionCacheData(SelectionCacheID);
+      info->addProperty(data);
+    }
+    data->getData().info_ = info;
+    return &(data->getData());
+  }
+
+  bool SelectionCache::find(const std::string& script, int frame, 
+                            Entry& entry) {
+    std::map<std::pair<std::string, bool>, Entry>::iterator i;
+    i = entries_.find(std::make_pair(script, frame >= 0));
+
+    Snapshot* snap = getSnapshot(frame);
+    int found = (i != entries_.end() && 
+                 i->second.snapshotID == snap->getID() && 
+                 i->second.time == snap->getTime()) ? 1 : 0;
+
+    // each processor checks its own objects; the entry is only used
+    // if every processor matches:
+    if (found) 
+      found = (i->second.fingerprint == getFingerprint(frame)) ? 1 : 0;
+
+#ifdef IS_MPI
+    MPI_Allreduce(MPI_IN_PLACE, &found, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+
+    if (found) entry = i->second;
+    return found != 0;
+  }
+
+  void SelectionCache::store(const std::string& script, int frame, 
+                             Entry& entry) {
+    Snapshot* snap = getSnapshot(frame);
+    entry.snapshotID = snap->getID();
+    entry.time = snap->getTime();
+    entry.fingerprint = getFingerprint(frame);
+    entries_[std::make_pair(script, frame >= 0)] = entry;
+  }
+
+  Snapshot* SelectionCache::getSnapshot(int frame) {
+    SnapshotManager* sman = info_->getSnapshotManager();
+    return frame < 0 ? sman->getCurrentSnapshot() : sman->getSnapshot(frame);
+  }
+
+  unsigned long long SelectionCache::getFingerprint(int frame) {
+    unsigned long long h = 14695981039346656037ULL;
+    bool hasFlucQ = (info_->getStorageLayout() & 
+                     DataStorage::dslFlucQPosition) != 0;
+
+    Mat3x3d hmat = getSnapshot(frame)->getHmat();
+    for (int i = 0; i < 3; i++) 
+      for (int j = 0; j < 3; j++) 
+        hashValue(h, hmat(i, j));
+    
+    SimInfo::MoleculeIterator mi;
+    Molecule::AtomIterator ai;
+    Molecule::RigidBodyIterator rbIter;
+    Molecule* mol;
+    Atom* atom;
+    RigidBody* rb;
+    Vector3d pos;
+    RotMat3x3d A;
+
+    for (mol = info_->beginMolecule(mi); mol != NULL; 
+         mol = info_->nextMolecule(mi)) {
+      for (atom = mol->beginAtom(ai); atom != NULL; 
+           atom = mol->nextAtom(ai)) {
+        pos = frame < 0 ? atom->getPos() : atom->getPos(frame);
+        for (int i = 0; i < 3; i++) hashValue(h, pos[i]);
+        if (hasFlucQ) 
+          hashValue(h, frame < 0 ? atom->getFlucQPos() : 
+                    atom->getFlucQPos(frame));
+      }
+      for (rb = mol->beginRigidBody(rbIter); rb != NULL; 
+           rb = mol->nextRigidBody(rbIter)) {
+        pos = frame < 0 ? rb->getPos() : rb->getPos(frame);
+        A = frame < 0 ? rb->getA() : rb->getA(frame);
+        for (int i = 0; i < 3; i++) {
+          hashValue(h, pos[i]);
+          for (int j = 0; j < 3; j++) hashValue(h, A(i, j));
+        }
+      }
+    }
+    return h;
+  }
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2005, 2010 The University of Notre Dame. All Rights Reserved.
+ *
+ * The University of Notre Dame grants you ("Licensee") a
+ * non-exclusive, royalty free, license to use, modify and
+ * redistribute this software in source and binary code form, provided
+ * that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This software is provided "AS IS," without a warranty of any
+ * kind. All express or implied conditions, representations and
+ * warranties, including any implied warranty of merchantability,
+ * fitness for a particular purpose or non-infringement, are hereby
+ * excluded.  The University of Notre Dame and its licensors shall not
+ * be liable for any damages suffered by licensee as a result of
+ * using, modifying or distributing the software or its
+ * derivatives. In no event will the University of Notre Dame or its
+ * licensors be liable for any lost revenue, profit or data, or for
+ * direct, indirect, special, consequential, incidental or punitive
+ * damages, however caused and regardless of the theory of liability,
+ * arising out of the use of or inability to use software, even if the
+ * University of Notre Dame has been advised of the possibility of
+ * such damages.
+ *
+ * SUPPORT OPEN SCIENCE!  If you use OpenMD or its source code in your
+ * research, please cite the appropriate papers when you publish your
+ * work.  Good starting points are:
+ *                                                                      
+ * [1]  Meineke, et al., J. Comp. Chem. 26, 252-271 (2005).             
+ * [2]  Fennell & Gezelter, J. Chem. Phys. 124, 234104 (2006).          
+ * [3]  Sun, Lin & Gezelter, J. Chem. Phys. 128, 234107 (2008).          
+ * [4]  Kuang & Gezelter,  J. Chem. Phys. 133, 164101 (2010).
+ * [5]  Vardeman, Stocker & Gezelter, J. Chem. Theory Comput. 7, 834 (2011).
+ */
+
+#ifndef SELECTION_SELECTIONCACHE_HPP
+#define SELECTION_SELECTIONCACHE_HPP
+
+#include <map>
+#include <string>
+#include "brains/SimInfo.hpp"
+#include "brains/Snapshot.hpp"
+#include "selection/SelectionSet.hpp"
+#include "utils/GenericData.hpp"
+
+namespace OpenMD {
+
+  /**
+   * @class SelectionCache
+   * Results of dynamic selection scripts, shared by all of the
+   * SelectionEvaluators working on one SimInfo so that several
+   * consumers of the same script in one frame only evaluate it once.
+   *
+   * An entry is matched on the script, the snapshot ID and time, and
+   * on a fingerprint of the box, positions, orientations and
+   * fluctuating charges.  A configuration that changes without a new
+   * snapshot (e.g. when constraints are applied at startup) never
+   * picks up a stale result.
+   */
+  class SelectionCache {
+  public:
+    SelectionCache() : info_(NULL) {}
+
+    struct Entry {
+      int snapshotID;
+      RealType time;
+      unsigned long long fingerprint;
+      SelectionSet result;
+      bool hasSurfaceArea;
+      RealType surfaceArea;
+      bool hasVolume;
+      RealType volume;
+    };
+
+    /** Returns the cache attached to info, creating it if needed. */
+    static SelectionCache* getCache(SimInfo* info);
+
+    /**
+     * Looks up a script evaluated on frame (or on the current
+     * snapshot if frame < 0).  Must be called on every processor.
+     */
+    bool find(const std::string& script, int frame, Entry& entry);
+
+    /** Saves the result of a script evaluated on frame. */
+    void store(const std::string& script, int frame, Entry& entry);
+
+  private:
+    Snapshot* getSnapshot(int frame);
+    unsigned long long getFingerprint(int frame);
+
+    SimInfo* info_;
+    // one entry for the current snapshot and one for the latest frame
+    // of each script:
+    std::map<std::pair<std::string, bool>, Entry> entries_;
+  };
+
+  typedef SimpleTypeData<SelectionCache> SelectionCacheData;
+
+}
+#endif
@@ -55,19 +55,34 @@ namespace OpenMD {
 
   SelectionEvaluator::SelectionEvaluator(SimInfo* si) 
     : info(si), nameFinder(info), distanceFinder(info), hullFinder(info),
-      alphaHullFinder(info), indexFinder(info), isLoaded_(false),
-      hasSurfaceArea_(false), hasVolume_(false) {
+      alphaHullFinder(info), indexFinder(info), hasDefines_(false),
+      hasResult_(false), isLoaded_(false), hasSurfaceArea_(false),
+      hasVolume_(false) {
     nObjects.push_back(info->getNGlobalAtoms() + info->getNGlobalRigidBodies());
     nObjects.push_back(info->getNGlobalBonds());
     nObjects.push_back(info->getNGlobalBends());
     nObjects.push_back(info->getNGlobalTorsions());
     nObjects.push_back(info->getNGlobalInversions());
     nObjects.push_back(info->getNGlobalMolecules());    
+    cache_ = SelectionCache::getCache(info);
   }
   
   bool SelectionEvaluator::loadScript(const std::string& filename, 
                                       const std::string& script) {
     clearDefinitionsAndLoadPredefined();
+
+    // Reloading the script that is already compiled keeps the program
+    // and its static constants.  Only the constants that were built
+    // from defined variables have to be evaluated again.
+    if (isLoaded_ && filename == this->filename && script == this->script) {
+      for (unsigned int i = 0; i < constants_.size(); ++i) {
+        if (constants_[i].usesVariables) constants_[i].evaluated = false;
+      }
+      if (hasDefines_) hasResult_ = false;
+      return true;
+    }
+
+    isLoaded_ = false;
     this->filename = filename;
     this->script = script;
     if (! compiler.compile(filename, script)) {
@@ -97,8 +112,8 @@ namespace OpenMD {
       }
     }
 
-    isLoaded_ = true;
-    return true;
+    isLoaded_ = compileProgram();
+    return isLoaded_;
   }
 
   void SelectionEvaluator::clearState() {
@@ -131,198 +146,231 @@ namespace OpenMD {
     return loadScript(filename, script);
   }
   
-  void SelectionEvaluator::instructionDispatchLoop(SelectionSet& bs){
-    
-    while ( pc < aatoken.size()) {
-      statement = aatoken[pc++];
-      statementLength = statement.size();
-      Token token = statement[0];
-      switch (token.tok) {
+  bool SelectionEvaluator::compileProgram() {
+    program_.clear();
+    operands_.clear();
+    constants_.clear();
+    hasDefines_ = false;
+    hasResult_ = false;
+
+    for (pc = 0; pc < aatoken.size(); ++pc) {
+      const std::vector<Token>& statement = aatoken[pc];
+      Statement st;
+      switch (statement[0].tok) {
       case Token::define:
-	define();
-	break;
+        assert(statement.size() >= 3);
+        st.isDefine = true;
+        st.variable = boost::any_cast<std::string>(statement[1].value);
+        hasDefines_ = true;
+        if (!compileExpression(statement, 2, st.code)) return false;
+        break;
       case Token::select:
-	select(bs);
-	break;
+        st.isDefine = false;
+        if (!compileExpression(statement, 1, st.code)) return false;
+        break;
       default:
-	unrecognizedCommand(token);
-	return;
+        unrecognizedCommand(statement[0]);
+        return false;
       }
+      program_.push_back(st);
     }
-
+    pc = 0;
+    return true;
   }
 
-  void SelectionEvaluator::instructionDispatchLoop(SelectionSet& bs, int frame){
-    
-    while ( pc < aatoken.size()) {
-      statement = aatoken[pc++];
-      statementLength = statement.size();
-      Token token = statement[0];
-      switch (token.tok) {
-      case Token::define:
-	define();
-	break;
-      case Token::select:
-	select(bs, frame);
-	break;
-      default:
-	unrecognizedCommand(token);
-	return;
-      }
-    }
+  bool SelectionEvaluator::compileExpression(const std::vector<Token>& code,
+                                             int pcStart,
+                                             std::vector<Instruction>& program) {
+    std::vector<Segment> stack;
+    Instruction ins;
 
-  }
-
-  SelectionSet SelectionEvaluator::expression(const std::vector<Token>& code, 
-                                             int pcStart) {
-    SelectionSet bs = createSelectionSets();
-    std::stack<SelectionSet> stack; 
-    vector<int> bsSize = bs.size();
-   
-    for (unsigned int pc = pcStart; pc < code.size(); ++pc) {
-      Token instruction = code[pc];
+    for (unsigned int i = pcStart; i < code.size(); ++i) {
+      const Token& token = code[i];
+      Segment seg;
+      seg.isStatic = true;
+      seg.usesVariables = false;
 
-      switch (instruction.tok) {
+      switch (token.tok) {
       case Token::expressionBegin:
-        break;
       case Token::expressionEnd:
-        break;
+        continue;
+      case Token::identifier:
+        seg.usesVariables = true;
+        // fall through
       case Token::all:
-        bs = allInstruction();
-        stack.push(bs);
-        break;
       case Token::none:
-        bs = createSelectionSets();
-        stack.push(bs);
-        break;
-      case Token::opOr:
-          bs= stack.top();
-          stack.pop();
-          stack.top() |= bs;
-        break;
-      case Token::opAnd:
-          bs = stack.top();
-          stack.pop();
-          stack.top() &= bs;
-        break;
-      case Token::opNot:
-          stack.top().flip();
-        break;
-      case Token::within:
-        withinInstruction(instruction, stack.top());
-        break;
-      case Token::alphahull:
-        stack.push(alphaHullInstruction(instruction));
-        break;
-      case Token::hull:
-          stack.push(hull());
-        break;
-	//case Token::selected:
-	//  stack.push(getSelectionSet());
-	//  break;
       case Token::name:
-          stack.push(nameInstruction(boost::any_cast<std::string>(instruction.value)));
-        break;
       case Token::index:
-          stack.push(indexInstruction(instruction.value));
-        break;
-      case Token::identifier:
-          stack.push(lookupValue(boost::any_cast<std::string>(instruction.value)));
+        ins.op = pushToken;
+        ins.operand = operands_.size();
+        operands_.push_back(token);
+        seg.code.push_back(ins);
+        stack.push_back(seg);
         break;
+      case Token::hull:
+      case Token::alphahull:
       case Token::opLT:
       case Token::opLE:
       case Token::opGE:
       case Token::opGT:
       case Token::opEQ:
       case Token::opNE:
-        stack.push(comparatorInstruction(instruction));
+        if (token.tok == Token::hull) ins.op = opHull;
+        else if (token.tok == Token::alphahull) ins.op = opAlphaHull;
+        else ins.op = opCompare;
+        ins.operand = operands_.size();
+        operands_.push_back(token);
+        seg.isStatic = false;
+        seg.code.push_back(ins);
+        stack.push_back(seg);
+        break;
+      case Token::within:
+        if (stack.empty()) break;
+        foldConstant(stack.back());
+        ins.op = opWithin;
+        ins.operand = operands_.size();
+        operands_.push_back(token);
+        stack.back().code.push_back(ins);
+        stack.back().isStatic = false;
+        break;
+      case Token::opNot:
+        if (stack.empty()) break;
+        ins.op = opNot;
+        ins.operand = -1;
+        stack.back().code.push_back(ins);
+        break;
+      case Token::opOr:
+      case Token::opAnd:
+        if (stack.size() < 2) {
+          stack.clear();
+          break;
+        }
+        ins.op = (token.tok == Token::opOr) ? opOr : opAnd;
+        ins.operand = -1;
+        seg = stack.back();
+        stack.pop_back();
+        if (!(seg.isStatic && stack.back().isStatic)) {
+          foldConstant(stack.back());
+          foldConstant(seg);
+          stack.back().isStatic = false;
+        }
+        stack.back().code.insert(stack.back().code.end(), 
+                                 seg.code.begin(), seg.code.end());
+        stack.back().code.push_back(ins);
+        stack.back().usesVariables |= seg.usesVariables;
         break;
       default:
         unrecognizedExpression();
+        return false;
       }
     }
-    if (stack.size() != 1)
+    if (stack.size() != 1) {
       evalError("atom expression compiler error - stack over/underflow");
-          
-    return stack.top();
+      return false;
+    }
+
+    foldConstant(stack.back());
+    program = stack.back().code;
+    return true;
   }
 
+  void SelectionEvaluator::foldConstant(Segment& segment) {
+    if (!segment.isStatic) return;
+    if (segment.code.size() == 1 && segment.code[0].op == pushConstant) return;
 
-  SelectionSet SelectionEvaluator::expression(const std::vector<Token>& code, 
-                                              int pcStart, int frame) {
-    SelectionSet bs = createSelectionSets();
+    Constant c;
+    c.code = segment.code;
+    c.usesVariables = segment.usesVariables;
+    c.evaluated = false;
+
+    Instruction ins;
+    ins.op = pushConstant;
+    ins.operand = constants_.size();
+    constants_.push_back(c);
+
+    segment.code.clear();
+    segment.code.push_back(ins);
+  }
+
+  SelectionSet SelectionEvaluator::execute(const std::vector<Instruction>& code,
+                                           int frame) {
+    SelectionSet bs;
     std::stack<SelectionSet> stack; 
-   
-    for (unsigned int pc = pcStart; pc < code.size(); ++pc) {
-      Token instruction = code[pc];
 
-      switch (instruction.tok) {
-      case Token::expressionBegin:
-        break;
-      case Token::expressionEnd:
-        break;
-      case Token::all:
-        bs = allInstruction();
-        stack.push(bs);            
+    for (unsigned int i = 0; i < code.size(); ++i) {
+      const Instruction& ins = code[i];
+
+      switch (ins.op) {
+      case pushToken: {
+        const Token& token = operands_[ins.operand];
+        switch (token.tok) {
+        case Token::all:
+          stack.push(allInstruction());
+          break;
+        case Token::none:
+          stack.push(createSelectionSets());
+          break;
+        case Token::name:
+          stack.push(nameInstruction(boost::any_cast<std::string>(token.value)));
+          break;
+        case Token::index:
+          stack.push(indexInstruction(token.value));
+          break;
+        case Token::identifier:
+          stack.push(lookupValue(boost::any_cast<std::string>(token.value)));
+          break;
+        }
         break;
-      case Token::none:
-        bs = SelectionSet(nObjects);
-        stack.push(bs);            
+      }
+      case pushConstant: {
+        Constant& c = constants_[ins.operand];
+        if (!c.evaluated) {
+          c.value = execute(c.code, frame);
+          c.evaluated = true;
+        }
+        stack.push(c.value);
         break;
-      case Token::opOr:
+      }
+      case opOr:
         bs = stack.top();
         stack.pop();
         stack.top() |= bs;
         break;
-      case Token::opAnd:
+      case opAnd:
         bs = stack.top();
         stack.pop();
         stack.top() &= bs;
         break;
-      case Token::opNot:
+      case opNot:
         stack.top().flip();
         break;
-      case Token::within:
-        withinInstruction(instruction, stack.top(), frame);
-        break;
-      case Token::alphahull:
-        stack.push(alphaHullInstruction(instruction, frame));
-        break;        
-      case Token::hull:
-        stack.push(hull(frame));
-        break;
-	//case Token::selected:
-	//  stack.push(getSelectionSet());
-	//  break;
-      case Token::name:
-        stack.push(nameInstruction(boost::any_cast<std::string>(instruction.value)));
+      case opWithin:
+        if (frame < 0) 
+          withinInstruction(operands_[ins.operand], stack.top());
+        else
+          withinInstruction(operands_[ins.operand], stack.top(), frame);
         break;
-      case Token::index:
-        stack.push(indexInstruction(instruction.value));
+      case opHull:
+        stack.push(frame < 0 ? hull() : hull(frame));
         break;
-      case Token::identifier:
-        stack.push(lookupValue(boost::any_cast<std::string>(instruction.value)));
+      case opAlphaHull:
+        if (frame < 0) 
+          stack.push(alphaHullInstruction(operands_[ins.operand]));
+        else
+          stack.push(alphaHullInstruction(operands_[ins.operand], frame));
         break;
-      case Token::opLT:
-      case Token::opLE:
-      case Token::opGE:
-      case Token::opGT:
-      case Token::opEQ:
-      case Token::opNE:
-        stack.push(comparatorInstruction(instruction, frame));
+      case opCompare:
+        if (frame < 0) 
+          stack.push(comparatorInstruction(operands_[ins.operand]));
+        else
+          stack.push(comparatorInstruction(operands_[ins.operand], frame));
         break;
-      default:
-        unrecognizedExpression();
       }
     }
-    if (stack.size() != 1)
-      evalError("atom expression compiler error - stack over/underflow");
           
     return stack.top();
   }
 
-
-
   SelectionSet SelectionEvaluator::comparatorInstruction(const Token& instruction) {
     int comparator = instruction.tok;
     int property = instruction.intValue;
@@ -787,16 +835,6 @@ namespace OpenMD {
     return bs.parallelReduce();
   }
 
-  void SelectionEvaluator::define() {
-    assert(statement.size() >= 3);
-    
-    std::string variable = boost::any_cast<std::string>(statement[1].value);
-    
-    variables.insert(VariablesType::value_type(variable, 
-                                               expression(statement, 2)));
-  }
-  
-
   /** @todo */
   void SelectionEvaluator::predefine(const std::string& script) {
     
@@ -828,14 +866,6 @@ namespace OpenMD {
     }
   }
 
-  void SelectionEvaluator::select(SelectionSet& bs){
-    bs = expression(statement, 1);
-  }
-
-  void SelectionEvaluator::select(SelectionSet& bs, int frame){
-    bs = expression(statement, 1, frame);
-  }
-  
   SelectionSet SelectionEvaluator::lookupValue(const std::string& variable){
     
     SelectionSet bs = createSelectionSets();
@@ -845,7 +875,10 @@ namespace OpenMD {
       if (i->second.type() == typeid(SelectionSet)) {
 	return boost::any_cast<SelectionSet>(i->second);
       } else if (i->second.type() ==  typeid(std::vector<Token>)){
-	bs = expression(boost::any_cast<std::vector<Token> >(i->second), 2);
+        std::vector<Instruction> code;
+        if (compileExpression(boost::any_cast<std::vector<Token> >(i->second), 
+                              2, code))
+          bs = execute(code, -1);
 	i->second =  bs; /**@todo fixme */
 	return bs.parallelReduce();
       }
@@ -883,21 +916,75 @@ namespace OpenMD {
   }
 
   SelectionSet SelectionEvaluator::evaluate() {
-    SelectionSet bs = createSelectionSets();
-    if (isLoaded_) {
-      pc = 0;
-      instructionDispatchLoop(bs);
-    }
-    return bs.parallelReduce();
+    return evaluateProgram(-1);
   }
 
   SelectionSet SelectionEvaluator::evaluate(int frame) {
+    return evaluateProgram(frame);
+  }
+
+  // frame < 0 evaluates the script on the current snapshot
+  SelectionSet SelectionEvaluator::evaluateProgram(int frame) {
     SelectionSet bs = createSelectionSets();
-    if (isLoaded_) {
-      pc = 0;
-      instructionDispatchLoop(bs, frame);
+    if (!isLoaded_) return bs.parallelReduce();
+
+    if (hasResult_) return result_;
+
+    // Dynamic scripts are shared with the other evaluators on this
+    // SimInfo.  Scripts with definitions are not, since defined
+    // variables keep their value from the first evaluation.
+    bool useCache = isDynamic_ && !hasDefines_;
+    SelectionCache::Entry entry;
+
+    if (useCache && cache_->find(script, frame, entry)) {
+      if (entry.hasSurfaceArea) {
+        hasSurfaceArea_ = true;
+        surfaceArea_ = entry.surfaceArea;
+      }
+      if (entry.hasVolume) {
+        hasVolume_ = true;
+        volume_ = entry.volume;
+      }
+      return entry.result;
     }
-    return bs.parallelReduce();
+
+    bool hadSurfaceArea = hasSurfaceArea_;
+    bool hadVolume = hasVolume_;
+    hasSurfaceArea_ = false;
+    hasVolume_ = false;
+
+    // positions may have moved since the last evaluation, but every
+    // within() in this one can share the same cell grids:
+    distanceFinder.clearIndex();
+
+    for (pc = 0; pc < program_.size(); ++pc) {
+      Statement& st = program_[pc];
+      if (st.isDefine) {
+        if (variables.find(st.variable) == variables.end())
+          variables.insert(VariablesType::value_type(st.variable, 
+                                                     execute(st.code, frame)));
+      } else {
+        bs = execute(st.code, frame);
+      }
+    }
+    bs = bs.parallelReduce();
+
+    if (useCache) {
+      entry.result = bs;
+      entry.hasSurfaceArea = hasSurfaceArea_;
+      entry.surfaceArea = surfaceArea_;
+      entry.hasVolume = hasVolume_;
+      entry.volume = volume_;
+      cache_->store(script, frame, entry);
+    }
+    if (!isDynamic_) {
+      result_ = bs;
+      hasResult_ = true;
+    }
+
+    hasSurfaceArea_ = hasSurfaceArea_ || hadSurfaceArea;
+    hasVolume_ = hasVolume_ || hadVolume;
+    return bs;
   }
 
   SelectionSet SelectionEvaluator::indexInstruction(const boost::any& value) {
@@ -56,6 +56,7 @@
 #include "selection/HullFinder.hpp"
 #include "selection/IndexFinder.hpp"
 #include "selection/SelectionSet.hpp"
+#include "selection/SelectionCache.hpp"
 #include "primitives/StuntDouble.hpp"
 #include "utils/StringUtils.hpp"
 namespace OpenMD {
@@ -144,13 +145,54 @@ namespace OpenMD {
     SelectionSet createSelectionSets();
     void clearDefinitionsAndLoadPredefined();
          
-    void define();
-    void select(SelectionSet& bs);
-    void select(SelectionSet& bs, int frame);
     void predefine(const std::string& script);
 
-    void instructionDispatchLoop(SelectionSet& bs);
-    void instructionDispatchLoop(SelectionSet& bs, int frame);
+    /**
+     * Operations of a compiled statement.  pushToken, opWithin,
+     * opAlphaHull and opCompare refer to a token in operands_, and
+     * pushConstant to an entry in constants_.
+     */
+    enum OpCode {
+      pushToken, pushConstant, opAnd, opOr, opNot, 
+      opWithin, opHull, opAlphaHull, opCompare
+    };
+
+    struct Instruction {
+      OpCode op;
+      int operand;
+    };
+
+    /**
+     * A static subexpression (built only from names, indices, all,
+     * none and defined variables), evaluated the first time it is
+     * needed and reused on every later evaluation.
+     */
+    struct Constant {
+      std::vector<Instruction> code;
+      bool usesVariables;
+      bool evaluated;
+      SelectionSet value;
+    };
+
+    struct Statement {
+      bool isDefine;
+      std::string variable;
+      std::vector<Instruction> code;
+    };
+
+    /** Entry on the stack used while compiling an expression */
+    struct Segment {
+      std::vector<Instruction> code;
+      bool isStatic;
+      bool usesVariables;
+    };
+
+    bool compileProgram();
+    bool compileExpression(const std::vector<Token>& tokens, int pcStart,
+                           std::vector<Instruction>& code);
+    void foldConstant(Segment& segment);
+    SelectionSet execute(const std::vector<Instruction>& code, int frame);
+    SelectionSet evaluateProgram(int frame);
 
     void withinInstruction(const Token& instruction, SelectionSet& bs);
     void withinInstruction(const Token& instruction, SelectionSet& bs, int frame);
@@ -168,8 +210,6 @@ namespace OpenMD {
     void compareProperty(Molecule* mol, SelectionSet& bs, int property, int comparator, float comparisonValue, int frame);
     SelectionSet nameInstruction(const std::string& name);
     SelectionSet indexInstruction(const boost::any& value);
-    SelectionSet expression(const std::vector<Token>& tokens, int pc);
-    SelectionSet expression(const std::vector<Token>& tokens, int pc, int frame);
 
     SelectionSet lookupValue(const std::string& variable);
 
@@ -235,8 +275,6 @@ namespace OpenMD {
     bool error;
     std::string errorMessage;
 
-    std::vector<Token> statement;
-    int statementLength;
 
     SimInfo* info;
     NameFinder nameFinder;
@@ -249,6 +287,14 @@ namespace OpenMD {
     typedef std::map<std::string, boost::any > VariablesType;
     VariablesType variables;
 
+    std::vector<Statement> program_;
+    std::vector<Token> operands_;
+    std::vector<Constant> constants_;
+    bool hasDefines_;
+    bool hasResult_;        /**< result_ holds the value of a static script */
+    SelectionSet result_;
+    SelectionCache* cache_;
+
     bool isDynamic_;
     bool isLoaded_;
     bool hasSurfaceArea_;
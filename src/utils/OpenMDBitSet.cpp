@@ -50,47 +50,72 @@
 #include <iterator>
 
 #include "utils/OpenMDBitSet.hpp"
-#include "utils/Algorithm.hpp"
 
 namespace OpenMD {
-  int OpenMDBitSet::countBits() {
-#ifdef __RWSTD    
-    //For the compiler(Sun, MSVC6.0) binding with RougeWave STL Library, we need to use old-style
-    // std::count which is error-prone.
+
+  static inline int countWordBits(unsigned long w) {
+#if defined(__GNUC__)
+    return __builtin_popcountl(w);
+#else
     int count = 0;
-    std::count(bitset_.begin(), bitset_.end(), true, count);
+    while (w) {
+      w &= w - 1;
+      ++count;
+    }
     return count;
+#endif
+  }
+
+  // index of the lowest bit that is on in a word which is not zero
+  static inline int lowestWordBit(unsigned long w) {
+#if defined(__GNUC__)
+    return __builtin_ctzl(w);
 #else
-    return std::count(bitset_.begin(), bitset_.end(), true);
+    int index = 0;
+    while (!(w & 1UL)) {
+      w >>= 1;
+      ++index;
+    }
+    return index;
 #endif
   }
 
+  int OpenMDBitSet::countBits() {
+    int count = 0;
+    for (std::size_t i = 0; i < words_.size(); ++i)
+      count += countWordBits(words_[i]);
+    return count;
+  }
+
   void OpenMDBitSet::flip(int fromIndex, int toIndex) {
     assert(fromIndex <= toIndex);
     assert(fromIndex >=0);
     assert(toIndex <= size());
-    std::vector<bool>::iterator first = bitset_.begin() + fromIndex;
-    std::vector<bool>::iterator last = bitset_.begin() + toIndex;
+    for (int i = fromIndex; i < toIndex; ++i) 
+      flip(i);
+  }
 
-    std::transform(first, last, first, std::logical_not<bool>());
-        
+  void OpenMDBitSet::flip() {
+    for (std::size_t i = 0; i < words_.size(); ++i)
+      words_[i] = ~words_[i];
+    clearUnusedBits();
   }
 
   OpenMDBitSet OpenMDBitSet::get(int fromIndex, int toIndex) {
     assert(fromIndex <= toIndex);
     assert(fromIndex >=0);
     assert(toIndex <= size());
-    std::vector<bool>::iterator first = bitset_.begin() + fromIndex;
-    std::vector<bool>::iterator last = bitset_.begin() + toIndex;
 
-    OpenMDBitSet result;
-    std::copy(first, last, std::back_inserter(result.bitset_));
+    OpenMDBitSet result(toIndex - fromIndex);
+    for (int i = fromIndex; i < toIndex; ++i) 
+      if ((*this)[i]) result.setBitOn(i - fromIndex);
     return result;
   }
 
   bool OpenMDBitSet::none() {
-    std::vector<bool>::iterator i = std::find(bitset_.begin(), bitset_.end(), true);
-    return i == bitset_.end() ? true : false;
+    for (std::size_t i = 0; i < words_.size(); ++i)
+      if (words_[i]) return false;
+    return true;
   }
     
   int OpenMDBitSet::nextOffBit(int fromIndex) const {
@@ -100,14 +125,19 @@ namespace OpenMD {
     }
     
     ++fromIndex;
-    while (fromIndex < size()) {
-      if (!bitset_[fromIndex]) {
-	return fromIndex;
+    if (fromIndex >= size()) return -1;
+
+    std::size_t i = fromIndex / wordBits;
+    // bits below fromIndex in the first word are treated as on:
+    word_type w = ~words_[i] & (~word_type(0) << (fromIndex % wordBits));
+    while (true) {
+      if (w) {
+        int index = i * wordBits + lowestWordBit(w);
+        return index < size() ? index : -1;
       }
-      ++fromIndex;
+      if (++i == words_.size()) return -1;
+      w = ~words_[i];
     }
-
-    return -1;
   }
 
   int OpenMDBitSet::nextOnBit(int fromIndex) const {
@@ -117,47 +147,79 @@ namespace OpenMD {
     }
 
     ++fromIndex;
-    while (fromIndex < size()) {
-      if (bitset_[fromIndex]) {
-	return fromIndex;
-      }
-      ++fromIndex;
+    if (fromIndex >= size()) return -1;
+
+    std::size_t i = fromIndex / wordBits;
+    word_type w = words_[i] & (~word_type(0) << (fromIndex % wordBits));
+    while (true) {
+      if (w) return i * wordBits + lowestWordBit(w);
+      if (++i == words_.size()) return -1;
+      w = words_[i];
     }
-
-    return -1;
   }
 
+  // The word loops below have no dependencies between iterations, so
+  // the compiler is free to vectorize them.
+
   void OpenMDBitSet::andOperator (const OpenMDBitSet& bs) {
     assert(size() == bs.size());
-
-    std::transform(bs.bitset_.begin(), bs.bitset_.end(), bitset_.begin(), bitset_.begin(), std::logical_and<bool>());
+    const std::size_t n = words_.size();
+    for (std::size_t i = 0; i < n; ++i)
+      words_[i] &= bs.words_[i];
   }
 
   void OpenMDBitSet::orOperator (const OpenMDBitSet& bs) {
     assert(size() == bs.size());
-    std::transform(bs.bitset_.begin(), bs.bitset_.end(), bitset_.begin(), bitset_.begin(), std::logical_or<bool>());    
+    const std::size_t n = words_.size();
+    for (std::size_t i = 0; i < n; ++i)
+      words_[i] |= bs.words_[i];
   }
 
   void OpenMDBitSet::xorOperator (const OpenMDBitSet& bs) {
     assert(size() == bs.size());
-    std::transform(bs.bitset_.begin(), bs.bitset_.end(), bitset_.begin(), bitset_.begin(), OpenMD::logical_xor<bool>());        
+    const std::size_t n = words_.size();
+    for (std::size_t i = 0; i < n; ++i)
+      words_[i] ^= bs.words_[i];
+  }
+
+  void OpenMDBitSet::andNotOperator (const OpenMDBitSet& bs) {
+    assert(size() == bs.size());
+    const std::size_t n = words_.size();
+    for (std::size_t i = 0; i < n; ++i)
+      words_[i] &= ~bs.words_[i];
   }
    
   void OpenMDBitSet::setBits(int fromIndex, int toIndex, bool value) {
     assert(fromIndex <= toIndex);
     assert(fromIndex >=0);
     assert(toIndex <= size());
-    std::vector<bool>::iterator first = bitset_.begin() + fromIndex;
-    std::vector<bool>::iterator last = bitset_.begin() + toIndex;
-    std::fill(first, last, value);
+
+    int i = fromIndex;
+    // partial words at either end are done bit by bit, whole words at once
+    while (i < toIndex && i % wordBits != 0) {
+      if (value) setBitOn(i); else setBitOff(i);
+      ++i;
+    }
+    while (i + wordBits <= toIndex) {
+      words_[i / wordBits] = value ? ~word_type(0) : word_type(0);
+      i += wordBits;
+    }
+    while (i < toIndex) {
+      if (value) setBitOn(i); else setBitOff(i);
+      ++i;
+    }
   }
 
   void OpenMDBitSet::resize(int nbits) {
-    int oldSize = size();
-    bitset_.resize(nbits);
-    if (nbits > oldSize) {
-      std::fill(bitset_.begin()+oldSize, bitset_.end(), false);
-    }
+    nbits_ = nbits;
+    words_.resize((nbits + wordBits - 1) / wordBits, word_type(0));
+    clearUnusedBits();
+  }
+
+  void OpenMDBitSet::clearUnusedBits() {
+    int used = nbits_ % wordBits;
+    if (used != 0) 
+      words_.back() &= ~(~word_type(0) << used);
   }
 
   OpenMDBitSet operator| (const OpenMDBitSet& bs1, const OpenMDBitSet& bs2) {
@@ -194,32 +256,17 @@ namespace OpenMD {
 
   bool operator== (const OpenMDBitSet & bs1, const OpenMDBitSet &bs2) {
     assert(bs1.size() == bs2.size());
-    return std::equal(bs1.bitset_.begin(), bs1.bitset_.end(), bs2.bitset_.begin());
+    return bs1.words_ == bs2.words_;
   }  
 
   OpenMDBitSet OpenMDBitSet::parallelReduce() {
-    OpenMDBitSet result;
+    OpenMDBitSet result(*this);
 
 #ifdef IS_MPI
-
-    // This is necessary because std::vector<bool> isn't really a
-    // std::vector, so we can't pass the address of the first element
-    // to the MPI call that follows.  We first have to convert to a
-    // std::vector<int> to do the logical_or Allreduce call, then back
-    // convert it into the vector<bool>.
-
-    std::vector<int> bsInt(bitset_.begin(), bitset_.end());
-
-    MPI_Allreduce(MPI_IN_PLACE, &bsInt[0], 
-                  bsInt.size(), MPI_INT, MPI_LOR, MPI_COMM_WORLD);
-
-    std::transform(bsInt.begin(), bsInt.end(), 
-                   std::back_inserter( result.bitset_ ), to_bool<int>());
-#else
-
-    // Not in MPI?  Just return a copy of the current bitset:
-    std::copy(bitset_.begin(), bitset_.end(), 
-              std::back_inserter( result.bitset_ ));
+    // The packed words can be or-ed together directly:
+    if (!result.words_.empty())
+      MPI_Allreduce(MPI_IN_PLACE, &result.words_[0], result.words_.size(),
+                    MPI_UNSIGNED_LONG, MPI_BOR, MPI_COMM_WORLD);
 #endif
 
     return result;
@@ -231,7 +278,7 @@ namespace OpenMD {
   //}
 
   std::ostream& operator<< ( std::ostream& os, const OpenMDBitSet& bs) {
-    for (unsigned int i = 0; i < bs.bitset_.size(); ++i) {
+    for (int i = 0; i < bs.size(); ++i) {
       std::string val = bs[i] ? "true" : "false";
       os << "OpenMDBitSet[" << i <<"] = " << val << std::endl; 
     }
@@ -45,33 +45,39 @@
 
 #include <iostream>
 #include <vector>
+#include <climits>
 namespace OpenMD {
 
   /**
    * @class OpenMDBitSet OpenMDBitSet.hpp "OpenMDBitSet.hpp"
-   * @brief OpenMDBitSet is a wrapper class of std::vector<bool> to act as a growable std::bitset 
+   * @brief OpenMDBitSet is a growable bitset, packed into machine
+   * words so that the logical operations work on a whole word of
+   * bits at a time.
+   *
+   * Bits past size() in the last word are always kept off, so word
+   * operations never need to mask anything except flip.
    */
   class OpenMDBitSet {
   public:
     /** */
-    OpenMDBitSet() {}
+    OpenMDBitSet() : nbits_(0) {}
     /** */
-    OpenMDBitSet(int nbits) : bitset_(nbits) {clearAll(); }
+    OpenMDBitSet(int nbits) : nbits_(0) { resize(nbits); }
 
     /** Returns the number of bits set to true in this OpenMDBitSet.  */
     int countBits();
 
     /** Sets the bit at the specified index to to the complement of its current value. */
-    void flip(int bitIndex) {  bitset_[bitIndex] = !bitset_[bitIndex];  }
+    void flip(int bitIndex) {  words_[bitIndex / wordBits] ^= mask(bitIndex);  }
  
     /** Sets each bit from the specified fromIndex(inclusive) to the specified toIndex(exclusive) to the complement of its current value. */
     void flip(int fromIndex, int toIndex); 
 
     /** Sets each bit to the complement of its current value. */
-    void flip() { flip(0, size()); }
+    void flip();
         
     /** Returns the value of the bit with the specified index. */
-    bool get(int bitIndex) {  return bitset_[bitIndex];  }
+    bool get(int bitIndex) {  return (*this)[bitIndex];  }
         
     /** Returns a new OpenMDBitSet composed of bits from this OpenMDBitSet from fromIndex(inclusive) to toIndex(exclusive). */
     OpenMDBitSet get(int fromIndex, int toIndex); 
@@ -82,12 +88,12 @@ namespace OpenMD {
     /** Returns true if no bits are set to true */
     bool none();
 
-    int firstOffBit() const { return !bitset_[0] ? 0 : nextOffBit(0); }
+    int firstOffBit() const { return (nbits_ > 0 && !(*this)[0]) ? 0 : nextOffBit(0); }
         
     /** Returns the index of the first bit that is set to false that occurs on or after the specified starting index.*/
     int nextOffBit(int fromIndex) const; 
 
-    int firstOnBit() const { return bitset_[0] ? 0 : nextOnBit(0); }
+    int firstOnBit() const { return (nbits_ > 0 && (*this)[0]) ? 0 : nextOnBit(0); }
         
     /** Returns the index of the first bit that is set to true that occurs on or after the specified starting index. */
     int nextOnBit(int fromIndex) const; 
@@ -100,10 +106,13 @@ namespace OpenMD {
         
     /** Performs a logical XOR of this bit set with the bit set argument. */
     void xorOperator (const OpenMDBitSet& bs);        
+
+    /** Turns off every bit that is on in the argument bit set. */
+    void andNotOperator (const OpenMDBitSet& bs);
                
-    void setBitOn(int bitIndex) {  setBit(bitIndex, true);  }
+    void setBitOn(int bitIndex) {  words_[bitIndex / wordBits] |= mask(bitIndex);  }
 
-    void setBitOff(int bitIndex) {  setBit(bitIndex, false);  }
+    void setBitOff(int bitIndex) {  words_[bitIndex / wordBits] &= ~mask(bitIndex);  }
 
     void setRangeOn(int fromIndex, int toIndex) {  setBits(fromIndex, toIndex, true);  }
 
@@ -115,7 +124,7 @@ namespace OpenMD {
     void setAll() {  setRangeOn(0, size());  }        
         
     /** Returns the number of bits of space actually in use by this OpenMDBitSet to represent bit values. */
-    int size() const {  return bitset_.size();  }
+    int size() const {  return nbits_;  }
 
     /** Changes the size of OpenMDBitSet*/
     void resize(int nbits);
@@ -124,14 +133,15 @@ namespace OpenMD {
     OpenMDBitSet& operator|= (const OpenMDBitSet &bs) { orOperator (bs); return *this; }
     OpenMDBitSet& operator^= (const OpenMDBitSet &bs) { xorOperator (bs); return *this; }
     OpenMDBitSet& operator-= (const OpenMDBitSet &bs) { 
-      OpenMDBitSet tmp = *this ^ bs;
-      *this &= tmp;
+      andNotOperator(bs);
       return *this;
     }
 
     OpenMDBitSet parallelReduce();
         
-    bool operator[] (int bitIndex)  const {  return bitset_[bitIndex];  }
+    bool operator[] (int bitIndex)  const {  
+      return (words_[bitIndex / wordBits] & mask(bitIndex)) != 0;  
+    }
     friend OpenMDBitSet operator| (const OpenMDBitSet& bs1, const OpenMDBitSet& bs2);
     friend OpenMDBitSet operator& (const OpenMDBitSet& bs1, const OpenMDBitSet& bs2);
     friend OpenMDBitSet operator^ (const OpenMDBitSet& bs1, const OpenMDBitSet& bs2);
@@ -143,14 +153,21 @@ namespace OpenMD {
     friend std::ostream& operator<< ( std::ostream&, const OpenMDBitSet& bs) ;
 
   private:
+    typedef unsigned long word_type;
+    static const int wordBits = sizeof(word_type) * CHAR_BIT;
+
+    static word_type mask(int bitIndex) { 
+      return word_type(1) << (bitIndex % wordBits); 
+    }
 
-    /** Sets the bit at the specified index to the specified value. */
-    void setBit(int bitIndex, bool value) { bitset_[bitIndex] = value; }
-        
     /** Sets the bits from the specified fromIndex(inclusive) to the specified toIndex(exclusive) to the specified value. */
     void setBits(int fromIndex, int toIndex, bool value);
+
+    /** Turns off the unused bits past the end of the last word */
+    void clearUnusedBits();
         
-    std::vector<bool> bitset_;
+    std::vector<word_type> words_;
+    int nbits_;
   }; 
 
 }